@@ -279,7 +279,8 @@ Core::initiateMemoryAccess(MemComponent::component_t mem_component,
       Byte* data_buf, UInt32 data_size,
       MemModeled modeled,
       IntPtr eip,
-      SubsecondTime now)
+      SubsecondTime now,
+      bool batched)
 {
    MYLOG("access %lx+%u %c%c modeled(%s)", address, data_size, mem_op_type == Core::WRITE ? 'W' : 'R', mem_op_type == Core::READ_EX ? 'X' : ' ', ModeledString(modeled));
 
@@ -292,7 +293,8 @@ Core::initiateMemoryAccess(MemComponent::component_t mem_component,
    SubsecondTime initial_time = (now == SubsecondTime::MaxTime()) ? getPerformanceModel()->getElapsedTime() : now;
 
    // Protect from concurrent access by user thread (doing rewritten memops) and core thread (doing icache lookups)
-   if (lock_signal != Core::UNLOCK)
+   // (in a batch, accessMemoryBatch already holds the lock)
+   if (lock_signal != Core::UNLOCK && !batched)
       m_mem_lock.acquire();
 
 #if 0
@@ -401,7 +403,7 @@ Core::initiateMemoryAccess(MemComponent::component_t mem_component,
         ((mem_op_type == READ) ? "READ" : "WRITE"),
         address, data_size);
 
-   if (lock_signal != Core::LOCK)
+   if (lock_signal != Core::LOCK && !batched)
       m_mem_lock.release();
 
    // Calculate the round-trip time
@@ -482,6 +484,25 @@ Core::accessMemory(lock_signal_t lock_signal, mem_op_t mem_op_type, IntPtr d_add
       return initiateMemoryAccess(MemComponent::L1_DCACHE, lock_signal, mem_op_type, d_addr, (Byte*) data_buffer, data_size, modeled, eip, now);
 }
 
+void
+Core::accessMemoryBatch(MemoryRequest *requests, UInt32 count, MemModeled modeled, IntPtr eip, SubsecondTime now)
+{
+   if (modeled == MEM_MODELED_NONE || count == 0)
+   {
+      for (UInt32 i = 0; i < count; ++i)
+         requests[i].result = makeMemoryResult(HitWhere::UNKNOWN, SubsecondTime::Zero());
+      return;
+   }
+
+   ScopedLock sl(m_mem_lock);
+   getMemoryManager()->coreBeginMemoryBatch(MemComponent::L1_DCACHE);
+
+   for (UInt32 i = 0; i < count; ++i)
+      requests[i].result = initiateMemoryAccess(MemComponent::L1_DCACHE, Core::NONE, requests[i].mem_op_type, requests[i].address, NULL, requests[i].size, modeled, eip, now, true);
+
+   getMemoryManager()->coreEndMemoryBatch(MemComponent::L1_DCACHE);
+}
+
 
 MemoryResult
 Core::nativeMemOp(lock_signal_t lock_signal, mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size)
@@ -92,6 +92,19 @@ class Core
       MemoryResult accessMemory(lock_signal_t lock_signal, mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size, MemModeled modeled = MEM_MODELED_NONE, IntPtr eip = 0, SubsecondTime now = SubsecondTime::MaxTime(), bool is_fault_mask = false);
       MemoryResult nativeMemOp(lock_signal_t lock_signal, mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size);
 
+      // One data access of accessMemoryBatch
+      struct MemoryRequest
+      {
+         mem_op_t mem_op_type;
+         IntPtr address;
+         UInt32 size;
+         MemoryResult result;
+      };
+      // Data accesses that are issued together, such as the memory operands of one instruction. They are done in order
+      // and modeled exactly like accessMemory calls without lock signal or data, but the core's memory lock and the SMT
+      // lock of the L1-D are taken once for the whole batch instead of once per access (or per cache line)
+      void accessMemoryBatch(MemoryRequest *requests, UInt32 count, MemModeled modeled, IntPtr eip = 0, SubsecondTime now = SubsecondTime::MaxTime());
+
       void accessMemoryFast(bool icache, mem_op_t mem_op_type, IntPtr address);
 
       void logMemoryHit(bool icache, mem_op_t mem_op_type, IntPtr address, MemModeled modeled = MEM_MODELED_NONE, IntPtr eip = 0);
@@ -159,7 +172,8 @@ class Core
             Byte* data_buf, UInt32 data_size,
             MemModeled modeled,
             IntPtr eip,
-            SubsecondTime now);
+            SubsecondTime now,
+            bool batched = false);
 
       void hookPeriodicInsCheck();
       void hookPeriodicInsCall();
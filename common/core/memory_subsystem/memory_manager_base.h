@@ -72,6 +72,11 @@ class MemoryManagerBase
          return latency;
       }
 
+      // A batch of accesses by the core to mem_component starts or ends (see Core::accessMemoryBatch), so locks that
+      // every access would take can be held for the whole batch instead
+      virtual void coreBeginMemoryBatch(MemComponent::component_t mem_component) {}
+      virtual void coreEndMemoryBatch(MemComponent::component_t mem_component) {}
+
       virtual void handleMsgFromNetwork(NetPacket& packet) = 0;
 
       // FIXME: Take this out of here
@@ -142,6 +142,7 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
    m_coherent(cache_params.coherent),
    m_prefetch_on_prefetch_hit(false),
    m_l1_mshr(cache_params.outstanding_misses > 0),
+   m_in_core_batch(false),
    m_core_id(core_id),
    m_cache_block_size(cache_block_size),
    m_cache_writethrough(cache_params.writethrough),
@@ -322,10 +323,41 @@ CacheCntlr::processMemOpFromCore(
       bool modeled,
       bool count)
 {
-   HitWhere::where_t hit_where = HitWhere::MISS;
-
    // Protect against concurrent access from sibling SMT threads
+   // (during a core batch, beginCoreBatch already took the lock)
+   if (m_in_core_batch)
+      return processMemOpFromCoreSmtLocked(lock_signal, mem_op_type, ca_address, offset, data_buf, data_length, modeled, count);
+
    ScopedLock sl_smt(m_master->m_smt_lock);
+   return processMemOpFromCoreSmtLocked(lock_signal, mem_op_type, ca_address, offset, data_buf, data_length, modeled, count);
+}
+
+void
+CacheCntlr::beginCoreBatch()
+{
+   LOG_ASSERT_ERROR(!m_in_core_batch, "Nested core batch");
+   m_master->m_smt_lock.acquire();
+   m_in_core_batch = true;
+}
+
+void
+CacheCntlr::endCoreBatch()
+{
+   LOG_ASSERT_ERROR(m_in_core_batch, "No core batch in progress");
+   m_in_core_batch = false;
+   m_master->m_smt_lock.release();
+}
+
+HitWhere::where_t
+CacheCntlr::processMemOpFromCoreSmtLocked(
+      Core::lock_signal_t lock_signal,
+      Core::mem_op_t mem_op_type,
+      IntPtr ca_address, UInt32 offset,
+      Byte* data_buf, UInt32 data_length,
+      bool modeled,
+      bool count)
+{
+   HitWhere::where_t hit_where = HitWhere::MISS;
 
    LOG_PRINT("processMemOpFromCore(), lock_signal(%u), mem_op_type(%u), ca_address(0x%x)",
              lock_signal, mem_op_type, ca_address);
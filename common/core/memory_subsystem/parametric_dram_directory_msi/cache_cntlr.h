@@ -214,6 +214,7 @@ namespace ParametricDramDirectoryMSI
          bool m_coherent;
          bool m_prefetch_on_prefetch_hit;
          bool m_l1_mshr;
+         bool m_in_core_batch; //< The core holds the SMT lock for a batch of accesses (protected by the core's memory lock)
 
          struct {
            UInt64 loads, stores;
@@ -348,6 +349,14 @@ namespace ParametricDramDirectoryMSI
 
          CacheCntlr* lastLevelCache(void);
 
+         HitWhere::where_t processMemOpFromCoreSmtLocked(
+               Core::lock_signal_t lock_signal,
+               Core::mem_op_t mem_op_type,
+               IntPtr ca_address, UInt32 offset,
+               Byte* data_buf, UInt32 data_length,
+               bool modeled,
+               bool count);
+
       public:
 
          CacheCntlr(MemComponent::component_t mem_component,
@@ -379,6 +388,9 @@ namespace ParametricDramDirectoryMSI
                Byte* data_buf, UInt32 data_length,
                bool modeled,
                bool count);
+         // Hold the SMT lock across a batch of processMemOpFromCore calls by the core (see Core::accessMemoryBatch)
+         void beginCoreBatch();
+         void endCoreBatch();
          void updateHits(Core::mem_op_t mem_op_type, UInt64 hits);
 
          // Notify next level cache of so it can update its sharing set
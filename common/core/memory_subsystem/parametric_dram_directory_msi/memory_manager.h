@@ -90,6 +90,9 @@ namespace ParametricDramDirectoryMSI
                Byte* data_buf, UInt32 data_length,
                Core::MemModeled modeled);
 
+         void coreBeginMemoryBatch(MemComponent::component_t mem_component) { m_cache_cntlrs[mem_component]->beginCoreBatch(); }
+         void coreEndMemoryBatch(MemComponent::component_t mem_component) { m_cache_cntlrs[mem_component]->endCoreBatch(); }
+
          void handleMsgFromNetwork(NetPacket& packet);
 
          void sendMsg(PrL1PrL2DramDirectoryMSI::ShmemMsg::msg_t msg_type, MemComponent::component_t sender_mem_component, MemComponent::component_t receiver_mem_component, core_id_t requester, core_id_t receiver, IntPtr address, Byte* data_buf = NULL, UInt32 data_length = 0, HitWhere::where_t where = HitWhere::UNKNOWN, ShmemPerf *perf = NULL, ShmemPerfModel::Thread_t thread_num = ShmemPerfModel::NUM_CORE_THREADS);
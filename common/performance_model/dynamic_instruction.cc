@@ -41,23 +41,20 @@ SubsecondTime DynamicInstruction::getBranchCost(Core *core, bool *p_is_mispredic
 
 void DynamicInstruction::accessMemory(Core *core)
 {
+   // All operands go to the L1-D as one batch, which takes the memory and SMT locks once per instruction
+   Core::MemoryRequest requests[MAX_MEMORY];
+   UInt8 index[MAX_MEMORY];
+   UInt32 count = 0;
+
    for(UInt8 idx = 0; idx < num_memory; ++idx)
    {
       if (memory_info[idx].executed && memory_info[idx].hit_where == HitWhere::UNKNOWN)
       {
-         MemoryResult res = core->accessMemory(
-            /*instruction.isAtomic()
-               ? (info->type == DynamicInstructionInfo::MEMORY_READ ? Core::LOCK : Core::UNLOCK)
-               :*/ Core::NONE, // Just as in pin/lite/memory_modeling.cc, make the second part of an atomic update implicit
-            memory_info[idx].dir == Operand::READ ? (instruction->isAtomic() ? Core::READ_EX : Core::READ) : Core::WRITE,
-            memory_info[idx].addr,
-            NULL,
-            memory_info[idx].size,
-            Core::MEM_MODELED_RETURN,
-            instruction->getAddress()
-         );
-         memory_info[idx].latency = res.latency;
-         memory_info[idx].hit_where = res.hit_where;
+         // Just as in pin/lite/memory_modeling.cc, make the second part of an atomic update implicit (no lock signals)
+         requests[count].mem_op_type = memory_info[idx].dir == Operand::READ ? (instruction->isAtomic() ? Core::READ_EX : Core::READ) : Core::WRITE;
+         requests[count].address = memory_info[idx].addr;
+         requests[count].size = memory_info[idx].size;
+         index[count++] = idx;
       }
       else
       {
@@ -65,4 +62,12 @@ void DynamicInstruction::accessMemory(Core *core)
          memory_info[idx].hit_where = HitWhere::PREDICATE_FALSE;
       }
    }
+
+   core->accessMemoryBatch(requests, count, Core::MEM_MODELED_RETURN, instruction->getAddress());
+
+   for(UInt32 i = 0; i < count; ++i)
+   {
+      memory_info[index[i]].latency = requests[i].result.latency;
+      memory_info[index[i]].hit_where = requests[i].result.hit_where;
+   }
 }
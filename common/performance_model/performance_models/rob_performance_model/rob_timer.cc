@@ -37,6 +37,7 @@ RobTimer::RobTimer(
       , m_store_to_load_forwarding(Sim()->getCfg()->getBoolArray("perf_model/core/rob_timer/store_to_load_forwarding", core->getId()))
       , m_no_address_disambiguation(!Sim()->getCfg()->getBoolArray("perf_model/core/rob_timer/address_disambiguation", core->getId()))
       , inorder(Sim()->getCfg()->getBoolArray("perf_model/core/rob_timer/in_order", core->getId()))
+      , m_issue_scheduler(parseIssueScheduler(Sim()->getCfg()->getStringArray("perf_model/core/rob_timer/issue_scheduler", core->getId())))
       , m_core(core)
       , rob(window_size + 255)
       , m_num_in_rob(0)
@@ -54,6 +55,10 @@ RobTimer::RobTimer(
       , nextSequenceNumber(0)
       , will_skip(false)
       , time_skipped(SubsecondTime::Zero())
+      , m_waiting(window_size)
+      , m_waiting_stores(window_size)
+      , m_ready(window_size)
+      , m_event_times(window_size)
       , registerDependencies(new RegisterDependencies())
       , memoryDependencies(new MemoryDependencies())
       , perf(_perf)
@@ -179,6 +184,74 @@ RobTimer::~RobTimer()
       it->free();
 }
 
+RobTimer::issue_scheduler_t RobTimer::parseIssueScheduler(const String &name)
+{
+   if (name == "scan")
+      return ISSUE_SCAN;
+   else if (name == "event")
+      return ISSUE_EVENT;
+   else if (name == "check")
+      return ISSUE_CHECK;
+   LOG_PRINT_ERROR("Invalid perf_model/core/rob_timer/issue_scheduler %s", name.c_str());
+   return ISSUE_SCAN;
+}
+
+UInt64 RobTimer::SequenceSet::findNext(UInt64 from, UInt64 to) const
+{
+   while (from < to)
+   {
+      UInt64 slot = from % m_size;
+      UInt64 word = m_bits[slot / 64] >> (slot % 64);
+      if (word)
+         // Bits beyond m_size are never set, so this does not wrap around
+         return std::min(to, from + __builtin_ctzll(word));
+      // Continue at the next word, or wrap around to the first slot
+      from += std::min(m_size, (slot / 64 + 1) * 64) - slot;
+   }
+   return to;
+}
+
+RobTimer::MinTimeTree::MinTimeTree(UInt64 size)
+   : m_size(size)
+   , m_leaves(1)
+{
+   while (m_leaves < size)
+      m_leaves *= 2;
+   m_tree.resize(2 * m_leaves, SubsecondTime::MaxTime());
+}
+
+void RobTimer::MinTimeTree::set(UInt64 seq, SubsecondTime time)
+{
+   UInt64 node = m_leaves + seq % m_size;
+   m_tree[node] = time;
+   for(node /= 2; node > 0; node /= 2)
+      m_tree[node] = std::min(m_tree[2 * node], m_tree[2 * node + 1]);
+}
+
+SubsecondTime RobTimer::MinTimeTree::minSlots(UInt64 from, UInt64 to) const
+{
+   SubsecondTime result = SubsecondTime::MaxTime();
+   for(from += m_leaves, to += m_leaves; from < to; from /= 2, to /= 2)
+   {
+      if (from & 1)
+         result = std::min(result, m_tree[from++]);
+      if (to & 1)
+         result = std::min(result, m_tree[--to]);
+   }
+   return result;
+}
+
+SubsecondTime RobTimer::MinTimeTree::min(UInt64 from, UInt64 to) const
+{
+   if (from >= to)
+      return SubsecondTime::MaxTime();
+   UInt64 first = from % m_size, last = first + (to - from);
+   if (last <= m_size)
+      return minSlots(first, last);
+   else
+      return std::min(minSlots(first, m_size), minSlots(0, last - m_size));
+}
+
 void RobTimer::RobEntry::init(DynamicMicroOp *_uop, UInt64 sequenceNumber)
 {
    ready = SubsecondTime::MaxTime();
@@ -503,6 +576,14 @@ SubsecondTime RobTimer::doDispatch(SubsecondTime **cpiComponent)
          entry->ready = std::max(entry->ready, (now + 1ul).getElapsedTime());
          next_event = std::min(next_event, entry->ready);
 
+         if (m_issue_scheduler != ISSUE_SCAN)
+         {
+            m_waiting.insert(uop.getSequenceNumber());
+            if (uop.getMicroOp()->isStore())
+               m_waiting_stores.insert(uop.getSequenceNumber());
+            setReady(entry);
+         }
+
          #ifdef DEBUG_PERCYCLE
             std::cout<<"DISPATCH "<<entry->uop->getMicroOp()->toShortString()<<std::endl;
          #endif
@@ -632,6 +713,14 @@ void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
 
    --m_rs_entries_used;
 
+   if (m_issue_scheduler != ISSUE_SCAN)
+   {
+      m_waiting.erase(uop.getSequenceNumber());
+      m_waiting_stores.erase(uop.getSequenceNumber());
+      m_ready.erase(uop.getSequenceNumber());
+      m_event_times.set(uop.getSequenceNumber(), entry->done);
+   }
+
    #ifdef DEBUG_PERCYCLE
       std::cout<<"ISSUE    "<<entry->uop->getMicroOp()->toShortString()<<"   latency="<<uop.getExecLatency()<<std::endl;
    #endif
@@ -650,6 +739,10 @@ void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
       {
          depEntry->ready = depEntry->readyMax;
          //std::cout<<"    ready @ "<<depEntry->ready<<std::endl;
+
+         // Uops that are not dispatched yet are picked up by doDispatch
+         if (m_issue_scheduler != ISSUE_SCAN && depEntry->uop->getSequenceNumber() - rob.front().uop->getSequenceNumber() < m_num_in_rob)
+            setReady(depEntry);
       }
 
       // For stores, check if their address has been produced
@@ -694,138 +787,267 @@ void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
    }
 }
 
-SubsecondTime RobTimer::doIssue()
+void RobTimer::setReady(RobEntry *entry)
 {
-   uint64_t num_issued = 0;
-   SubsecondTime next_event = SubsecondTime::MaxTime();
-   bool head_of_queue = true, no_more_load = false, no_more_store = false, have_unresolved_store = false;
+   UInt64 seq = entry->uop->getSequenceNumber();
 
-   if (m_rob_contention)
-      m_rob_contention->initCycle(now);
+   // While waiting, the slot's event time is the ready time (MaxTime as long as dependencies are unresolved)
+   m_event_times.set(seq, entry->ready);
 
-   for(uint64_t i = 0; i < m_num_in_rob; ++i)
+   if (entry->ready <= now)
+      m_ready.insert(seq);
+   else if (entry->ready != SubsecondTime::MaxTime())
+      m_wakeups.push(wakeup_t(entry->ready, seq));
+}
+
+void RobTimer::wakeUp()
+{
+   while (!m_wakeups.empty() && m_wakeups.top().first <= now)
    {
-      RobEntry *entry = &rob.at(i);
-      DynamicMicroOp *uop = entry->uop;
+      UInt64 seq = m_wakeups.top().second;
+      m_wakeups.pop();
+      // Entries are stale when the uop has meanwhile issued, and maybe committed
+      if (m_num_in_rob && seq - rob.front().uop->getSequenceNumber() < m_num_in_rob && m_waiting.contains(seq))
+         m_ready.insert(seq);
+   }
+}
 
+bool RobTimer::visitInstruction(uint64_t idx, IssueWalk &walk)
+{
+   RobEntry *entry = &rob.at(idx);
+   DynamicMicroOp *uop = entry->uop;
 
-      if (entry->done != SubsecondTime::MaxTime())
-      {
-         next_event = std::min(next_event, entry->done);
-         continue;                     // already done
-      }
+   walk.next_event = std::min(walk.next_event, entry->ready);
 
-      next_event = std::min(next_event, entry->ready);
 
+   // See if we can issue this instruction
 
-      // See if we can issue this instruction
+   bool canIssue = false;
 
-      bool canIssue = false;
+   if (entry->ready > now)
+      canIssue = false;          // blocked by dependency
 
-      if (entry->ready > now)
-         canIssue = false;          // blocked by dependency
+   else if ((walk.no_more_load && uop->getMicroOp()->isLoad()) || (walk.no_more_store && uop->getMicroOp()->isStore()))
+      canIssue = false;          // blocked by mfence
 
-      else if ((no_more_load && uop->getMicroOp()->isLoad()) || (no_more_store && uop->getMicroOp()->isStore()))
-         canIssue = false;          // blocked by mfence
+   else if (uop->getMicroOp()->isSerializing())
+   {
+      if (walk.head_of_queue && last_store_done <= now)
+         canIssue = true;
+      else
+         return false;
+   }
 
-      else if (uop->getMicroOp()->isSerializing())
-      {
-         if (head_of_queue && last_store_done <= now)
-            canIssue = true;
-         else
-            break;
-      }
+   else if (uop->getMicroOp()->isMemBarrier())
+   {
+      if (walk.head_of_queue && last_store_done <= now)
+         canIssue = true;
+      else
+         // Don't issue any memory operations following a memory barrier
+         walk.no_more_load = walk.no_more_store = true;
+         // FIXME: L/SFENCE
+   }
 
-      else if (uop->getMicroOp()->isMemBarrier())
-      {
-         if (head_of_queue && last_store_done <= now)
-            canIssue = true;
-         else
-            // Don't issue any memory operations following a memory barrier
-            no_more_load = no_more_store = true;
-            // FIXME: L/SFENCE
-      }
+   else if (!m_rob_contention && walk.num_issued == dispatchWidth)
+      canIssue = false;          // no issue contention: issue width == dispatch width
 
-      else if (!m_rob_contention && num_issued == dispatchWidth)
-         canIssue = false;          // no issue contention: issue width == dispatch width
+   else if (uop->getMicroOp()->isLoad() && !load_queue.hasFreeSlot(now))
+      canIssue = false;          // load queue full
 
-      else if (uop->getMicroOp()->isLoad() && !load_queue.hasFreeSlot(now))
-         canIssue = false;          // load queue full
+   else if (uop->getMicroOp()->isLoad() && m_no_address_disambiguation && walk.have_unresolved_store)
+      canIssue = false;          // preceding store with unknown address
 
-      else if (uop->getMicroOp()->isLoad() && m_no_address_disambiguation && have_unresolved_store)
-         canIssue = false;          // preceding store with unknown address
+   else if (uop->getMicroOp()->isStore() && (!walk.head_of_queue || !store_queue.hasFreeSlot(now)))
+      canIssue = false;          // store queue full
 
-      else if (uop->getMicroOp()->isStore() && (!head_of_queue || !store_queue.hasFreeSlot(now)))
-         canIssue = false;          // store queue full
+   else
+      canIssue = true;           // issue!
 
-      else
-         canIssue = true;           // issue!
 
+   // canIssue already marks issue ports as in use, so do this one last
+   if (canIssue && m_rob_contention && ! m_rob_contention->tryIssue(*uop))
+      canIssue = false;          // blocked by structural hazard
 
-      // canIssue already marks issue ports as in use, so do this one last
-      if (canIssue && m_rob_contention && ! m_rob_contention->tryIssue(*uop))
-         canIssue = false;          // blocked by structural hazard
 
+   if (canIssue)
+   {
+      walk.num_issued++;
+      walk.issued_ready = std::min(walk.issued_ready, entry->ready);
+      issueInstruction(idx, walk.next_event);
 
-      if (canIssue)
+      // Calculate memory-level parallelism (MLP) for long-latency loads (but ignore overlapped misses)
+      if (uop->getMicroOp()->isLoad() && uop->isLongLatencyLoad() && uop->getDCacheHitWhere() != HitWhere::L1_OWN)
       {
-         num_issued++;
-         issueInstruction(i, next_event);
-
-         // Calculate memory-level parallelism (MLP) for long-latency loads (but ignore overlapped misses)
-         if (uop->getMicroOp()->isLoad() && uop->isLongLatencyLoad() && uop->getDCacheHitWhere() != HitWhere::L1_OWN)
-         {
-            if (m_lastAccountedMemoryCycle < now) m_lastAccountedMemoryCycle = now;
+         if (m_lastAccountedMemoryCycle < now) m_lastAccountedMemoryCycle = now;
 
-            SubsecondTime done = std::max( now.getElapsedTime(), entry->done );
-            // Ins will be outstanding for until it is done. By account beforehand I don't need to
-            // worry about fast-forwarding simulations
-            m_outstandingLongLatencyInsns += (done - now);
+         SubsecondTime done = std::max( now.getElapsedTime(), entry->done );
+         // Ins will be outstanding for until it is done. By account beforehand I don't need to
+         // worry about fast-forwarding simulations
+         m_outstandingLongLatencyInsns += (done - now);
 
-            // Only account for the cycles that have not yet been accounted for by other long
-            // latency misses (don't account cycles twice).
-            if ( done > m_lastAccountedMemoryCycle )
-            {
-               m_outstandingLongLatencyCycles += done - m_lastAccountedMemoryCycle;
-               m_lastAccountedMemoryCycle = done;
-            }
-
-            #ifdef ASSERT_SKIP
-            LOG_ASSERT_ERROR( m_outstandingLongLatencyInsns >= m_outstandingLongLatencyCycles, "MLP calculation is wrong: MLP cannot be < 1!"  );
-            #endif
+         // Only account for the cycles that have not yet been accounted for by other long
+         // latency misses (don't account cycles twice).
+         if ( done > m_lastAccountedMemoryCycle )
+         {
+            m_outstandingLongLatencyCycles += done - m_lastAccountedMemoryCycle;
+            m_lastAccountedMemoryCycle = done;
          }
 
-
          #ifdef ASSERT_SKIP
-            LOG_ASSERT_ERROR(will_skip == false, "Cycle would have been skipped but stuff happened");
+         LOG_ASSERT_ERROR( m_outstandingLongLatencyInsns >= m_outstandingLongLatencyCycles, "MLP calculation is wrong: MLP cannot be < 1!"  );
          #endif
       }
-      else
-      {
-         head_of_queue = false;     // Subsequent instructions are not at the head of the ROB
 
-         if (uop->getMicroOp()->isStore() && entry->addressReady > now)
-            have_unresolved_store = true;
 
-         if (inorder)
-            // In-order: only issue from head of the ROB
-            break;
+      #ifdef ASSERT_SKIP
+         LOG_ASSERT_ERROR(will_skip == false, "Cycle would have been skipped but stuff happened");
+      #endif
+   }
+   else
+   {
+      walk.head_of_queue = false;  // Subsequent instructions are not at the head of the ROB
+
+      if (uop->getMicroOp()->isStore() && entry->addressReady > now)
+         walk.have_unresolved_store = true;
+
+      if (inorder)
+         // In-order: only issue from head of the ROB
+         return false;
+   }
+
+
+   if (m_rob_contention)
+   {
+      if (m_rob_contention->noMore())
+         return false;
+   }
+   else
+   {
+      if (walk.num_issued == dispatchWidth)
+         return false;
+   }
+
+   return true;
+}
+
+SubsecondTime RobTimer::doIssueScan(IssueWalk &walk)
+{
+   uint64_t i;
+   for(i = 0; i < m_num_in_rob; ++i)
+   {
+      RobEntry *entry = &rob.at(i);
+
+      if (entry->done != SubsecondTime::MaxTime())
+      {
+         walk.next_event = std::min(walk.next_event, entry->done);
+         continue;                     // already done
       }
 
+      if (m_issue_scheduler == ISSUE_CHECK)
+         checkIssueWalk(i, walk);
 
-      if (m_rob_contention)
+      if (!visitInstruction(i, walk))
+         break;
+   }
+
+   if (m_issue_scheduler == ISSUE_CHECK && m_num_in_rob)
+   {
+      UInt64 front = rob.front().uop->getSequenceNumber();
+      SubsecondTime next_event = std::min(walk.issued_ready, m_event_times.min(front, front + std::min(i + 1, m_num_in_rob)));
+      LOG_ASSERT_ERROR(walk.next_event == next_event, "Issue stage next event %ld, event-driven bookkeeping has %ld",
+                       walk.next_event.getPS(), next_event.getPS());
+   }
+
+   return walk.next_event;
+}
+
+SubsecondTime RobTimer::doIssueEvent(IssueWalk &walk)
+{
+   if (m_num_in_rob == 0)
+      return walk.next_event;
+
+   const UInt64 front = rob.front().uop->getSequenceNumber(), end = front + m_num_in_rob;
+
+   // Walk over the ready uops, in ROB order. Uops that issue can make younger uops ready, which are then visited as well.
+   UInt64 pos = front, stop = end;
+   while (true)
+   {
+      UInt64 next = m_ready.findNext(pos, end);
+
+      // Uops in between that are waiting for their operands: the scan would not issue them,
+      // but they are no longer at the head of the ROB, and may be stores with an unknown address
+      UInt64 blocked = m_waiting.findNext(pos, next);
+      if (blocked != next)
       {
-         if (m_rob_contention->noMore())
+         walk.head_of_queue = false;
+         if (inorder)
+         {
+            stop = blocked + 1;
             break;
+         }
+         for(UInt64 store = m_waiting_stores.findNext(pos, next); store != next && !walk.have_unresolved_store; store = m_waiting_stores.findNext(store + 1, next))
+            if (rob.at(store - front).addressReady > now)
+               walk.have_unresolved_store = true;
       }
-      else
+
+      if (next == end)
+         break;
+      if (!visitInstruction(next - front, walk))
       {
-         if (num_issued == dispatchWidth)
-            break;
+         stop = next + 1;
+         break;
       }
+      pos = next + 1;
    }
 
-   return next_event;
+   // Done times of issued uops and ready times of waiting uops, up to where the scan would have stopped
+   return std::min(walk.next_event, m_event_times.min(front, stop));
+}
+
+SubsecondTime RobTimer::doIssue()
+{
+   IssueWalk walk;
+   walk.num_issued = 0;
+   walk.next_event = SubsecondTime::MaxTime();
+   walk.issued_ready = SubsecondTime::MaxTime();
+   walk.head_of_queue = true;
+   walk.no_more_load = walk.no_more_store = walk.have_unresolved_store = false;
+
+   if (m_rob_contention)
+      m_rob_contention->initCycle(now);
+
+   if (m_issue_scheduler != ISSUE_SCAN)
+      wakeUp();
+
+   if (m_issue_scheduler == ISSUE_EVENT)
+      return doIssueEvent(walk);
+   else
+      return doIssueScan(walk);
+}
+
+void RobTimer::checkIssueWalk(uint64_t idx, const IssueWalk &walk)
+{
+   // The event-driven walk derives the state of the scan at this uop from the bookkeeping:
+   // it is visited if ready, it is at the head if no older uop is waiting, and preceding stores with an
+   // unknown address are those still waiting
+   RobEntry *entry = &rob.at(idx);
+   UInt64 seq = entry->uop->getSequenceNumber(), front = rob.front().uop->getSequenceNumber();
+
+   LOG_ASSERT_ERROR(m_waiting.contains(seq), "Uop %ld is waiting for issue, but not in the event-driven bookkeeping", seq);
+   LOG_ASSERT_ERROR(m_ready.contains(seq) == (entry->ready <= now), "Uop %ld is %s for issue, but not according to the event-driven bookkeeping",
+                    seq, entry->ready <= now ? "ready" : "not ready");
+   if (m_event_times.min(seq, seq + 1) != entry->ready)
+      LOG_PRINT_ERROR("Uop %ld is ready at %ld, event-driven bookkeeping has %ld", seq, entry->ready.getPS(), m_event_times.min(seq, seq + 1).getPS());
+
+   bool head_of_queue = m_waiting.findNext(front, seq) == seq;
+   LOG_ASSERT_ERROR(walk.head_of_queue == head_of_queue, "Uop %ld head of queue %d, event-driven bookkeeping has %d", seq, walk.head_of_queue, head_of_queue);
+
+   bool have_unresolved_store = false;
+   for(UInt64 store = m_waiting_stores.findNext(front, seq); store != seq; store = m_waiting_stores.findNext(store + 1, seq))
+      if (rob.at(store - front).addressReady > now)
+         have_unresolved_store = true;
+   LOG_ASSERT_ERROR(walk.have_unresolved_store == have_unresolved_store, "Uop %ld unresolved store %d, event-driven bookkeeping has %d",
+                    seq, walk.have_unresolved_store, have_unresolved_store);
 }
 
 SubsecondTime RobTimer::doCommit(uint64_t& instructionsExecuted)
@@ -10,6 +10,7 @@
 #include "stats.h"
 
 #include <deque>
+#include <queue>
 
 class RobTimer
 {
@@ -45,6 +46,56 @@ private:
          SubsecondTime done;
    };
 
+   // Set of the sequence numbers of dispatched uops, one bit per ROB slot
+   class SequenceSet
+   {
+      private:
+         const UInt64 m_size;
+         std::vector<UInt64> m_bits;
+
+      public:
+         SequenceSet(UInt64 size) : m_size(size), m_bits((size + 63) / 64, 0) {}
+
+         void insert(UInt64 seq) { m_bits[(seq % m_size) / 64] |= 1ull << (seq % m_size % 64); }
+         void erase(UInt64 seq) { m_bits[(seq % m_size) / 64] &= ~(1ull << (seq % m_size % 64)); }
+         bool contains(UInt64 seq) const { return m_bits[(seq % m_size) / 64] & (1ull << (seq % m_size % 64)); }
+         // Lowest member in [from, to), or to if there is none. The range may not be longer than the set.
+         UInt64 findNext(UInt64 from, UInt64 to) const;
+   };
+
+   // Minimum of one time per ROB slot over a range of sequence numbers (segment tree)
+   class MinTimeTree
+   {
+      private:
+         const UInt64 m_size;
+         UInt64 m_leaves;
+         std::vector<SubsecondTime> m_tree;
+
+         SubsecondTime minSlots(UInt64 from, UInt64 to) const;
+
+      public:
+         MinTimeTree(UInt64 size);
+
+         void set(UInt64 seq, SubsecondTime time);
+         // Minimum over [from, to), MaxTime if empty. The range may not be longer than the tree.
+         SubsecondTime min(UInt64 from, UInt64 to) const;
+   };
+
+   // State of one cycle's walk of the issue stage over the ROB
+   struct IssueWalk
+   {
+      uint64_t num_issued;
+      SubsecondTime next_event;
+      SubsecondTime issued_ready; // earliest ready time of the uops issued in this cycle
+      bool head_of_queue, no_more_load, no_more_store, have_unresolved_store;
+   };
+
+   enum issue_scheduler_t {
+      ISSUE_SCAN,    // walk every uop in the ROB every cycle
+      ISSUE_EVENT,   // only visit uops that are ready, derive what the walk sees in between
+      ISSUE_CHECK,   // walk every uop, and check that the event-driven bookkeeping derives the same
+   };
+
    const uint64_t dispatchWidth;
    const uint64_t commitWidth;
    const uint64_t windowSize;
@@ -54,6 +105,8 @@ private:
    const bool m_no_address_disambiguation;
    const bool inorder;
 
+   const issue_scheduler_t m_issue_scheduler;
+
    Core *m_core;
 
    typedef CircularQueue<RobEntry> Rob;
@@ -73,6 +126,14 @@ private:
    bool will_skip;
    SubsecondTime time_skipped;
 
+   // Event-driven issue bookkeeping (not kept with ISSUE_SCAN)
+   SequenceSet m_waiting;        // dispatched, not yet issued
+   SequenceSet m_waiting_stores; // dispatched stores, not yet issued
+   SequenceSet m_ready;          // dispatched, not yet issued, ready <= now
+   MinTimeTree m_event_times;    // per dispatched uop: done once issued, ready before that
+   typedef std::pair<SubsecondTime, UInt64> wakeup_t;
+   std::priority_queue<wakeup_t, std::vector<wakeup_t>, std::greater<wakeup_t> > m_wakeups; // (ready, sequence number) of waiting uops with ready > now
+
    RegisterDependencies* const registerDependencies;
    MemoryDependencies* const memoryDependencies;
 
@@ -143,9 +204,19 @@ private:
    void execute(uint64_t& instructionsExecuted, SubsecondTime& latency);
    SubsecondTime doDispatch(SubsecondTime **cpiComponent);
    SubsecondTime doIssue();
+   SubsecondTime doIssueScan(IssueWalk &walk);
+   SubsecondTime doIssueEvent(IssueWalk &walk);
    SubsecondTime doCommit(uint64_t& instructionsExecuted);
 
+   // Issue stage decision for a uop that was not yet issued, returns false when the walk stops here
+   bool visitInstruction(uint64_t idx, IssueWalk &walk);
    void issueInstruction(uint64_t idx, SubsecondTime &next_event);
+   // Keep the event-driven bookkeeping in sync when a dispatched uop's ready time becomes known
+   void setReady(RobEntry *entry);
+   // Move the waiting uops whose ready time has passed from the wakeup heap into the ready set
+   void wakeUp();
+   void checkIssueWalk(uint64_t idx, const IssueWalk &walk);
+   static issue_scheduler_t parseIssueScheduler(const String &name);
 
 public:
 
@@ -0,0 +1,149 @@
+#include "native_power_model.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <algorithm>
+
+const NativePowerModel::event_t NativePowerModel::s_component_event[NativePowerModel::NUM_COMPONENTS] = {
+   EVENT_UOPS_FP,       // FPU
+   EVENT_UOPS,          // RBB
+   EVENT_INSTRUCTIONS,  // REN
+   EVENT_TLB_ACCESSES,  // MMU
+   EVENT_BUSY_CYCLES,   // OTHER (clock network, pipeline latches, ...)
+   EVENT_UOPS_INT,      // IW
+   EVENT_UOPS_FP,       // FPIW
+   EVENT_INSTRUCTIONS,  // ROB
+   EVENT_UOPS_INT,      // IRF
+   EVENT_UOPS_FP,       // FPRF
+   EVENT_UOPS_INT,      // CALU
+   EVENT_UOPS_INT,      // IALU
+   EVENT_BRANCHES,      // BTB
+   EVENT_BRANCHES,      // BP
+   EVENT_LOADS,         // LQ
+   EVENT_STORES,        // SQ
+   EVENT_L1D_ACCESSES,  // DC
+   EVENT_INSTRUCTIONS,  // ID
+   EVENT_INSTRUCTIONS,  // IB
+   EVENT_L1I_ACCESSES,  // IC
+   EVENT_L2_ACCESSES,   // L2
+};
+
+const char* NativePowerModel::s_component_names[NativePowerModel::NUM_COMPONENTS] = {
+   "FPU", "RBB", "REN", "MMU", "Other", "IW", "FPIW", "ROB", "IRF", "FPRF", "CALU",
+   "IALU", "BTB", "BP", "LQ", "SQ", "DC", "ID", "IB", "IC", "L2",
+};
+
+const char* NativePowerModel::getComponentName(component_t component)
+{
+   LOG_ASSERT_ERROR(component < NUM_COMPONENTS, "Invalid power component %d", component);
+   return s_component_names[component];
+}
+
+NativePowerModel::NativePowerModel()
+{
+   buildDvfsTable(Sim()->getCfg()->getInt("power/technology_node"));
+
+   // Static power of a core is linear in frequency, calibrated at two points (see PowerModel::estimatePower)
+   const double static_freq_a = Sim()->getCfg()->getFloat("power/static_frequency_a") * 1000;
+   const double static_freq_b = Sim()->getCfg()->getFloat("power/static_frequency_b") * 1000;
+   const double static_power_a = Sim()->getCfg()->getFloat("power/static_power_a");
+   const double static_power_b = Sim()->getCfg()->getFloat("power/static_power_b");
+   const double static_power_m = (static_power_b - static_power_a) / (static_freq_b - static_freq_a);
+   const double static_power_offset = static_power_a - static_power_m * static_freq_a;
+
+   const double reference_vdd = Sim()->getCfg()->getFloat("periodic_power/native/reference_vdd");
+   const double l3_energy = Sim()->getCfg()->getFloat("periodic_power/native/l3_energy") * 1e-9;
+   const double l3_static_power = Sim()->getCfg()->getFloat("periodic_power/native/l3_static_power");
+
+   double energy[NUM_COMPONENTS], leakage_share[NUM_COMPONENTS];
+   double total_leakage_share = 0;
+   for (UInt32 c = 0; c < NUM_COMPONENTS; ++c)
+   {
+      String key = String(s_component_names[c]);
+      std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+      energy[c] = Sim()->getCfg()->getFloat("periodic_power/native/energy/" + key) * 1e-9;
+      leakage_share[c] = Sim()->getCfg()->getFloat("periodic_power/native/leakage/" + key);
+      total_leakage_share += leakage_share[c];
+   }
+   // The components together leak exactly the static power of the core
+   LOG_ASSERT_ERROR(total_leakage_share > 0, "periodic_power/native/leakage shares must not all be zero");
+   for (UInt32 c = 0; c < NUM_COMPONENTS; ++c)
+      leakage_share[c] /= total_leakage_share;
+
+   // Pre-scale all coefficients for every operating point
+   for (std::vector<OperatingPoint>::iterator it = m_operating_points.begin(); it != m_operating_points.end(); ++it)
+   {
+      const double vdd_ratio = it->vdd / reference_vdd;
+      const double static_power = std::max(0., static_power_m * it->freq_mhz + static_power_offset);
+      for (UInt32 c = 0; c < NUM_COMPONENTS; ++c)
+      {
+         it->energy[c] = energy[c] * vdd_ratio * vdd_ratio;
+         it->leakage[c] = static_power * leakage_share[c];
+      }
+      it->l3_energy = l3_energy * vdd_ratio * vdd_ratio;
+      it->l3_leakage = l3_static_power * vdd_ratio;
+   }
+}
+
+void NativePowerModel::buildDvfsTable(UInt32 technology_node)
+{
+   // Keep in sync with build_dvfs_table in scripts/energystats.py
+   if (technology_node <= 22)
+   {
+      for (SInt32 f = 4000; f >= 0; f -= 100)
+      {
+         OperatingPoint op;
+         op.freq_mhz = f;
+         op.vdd = 0.6 + f / 4000.0 * 0.8;
+         m_operating_points.push_back(op);
+      }
+   }
+   else if (technology_node == 45)
+   {
+      const UInt32 freqs[] = { 2000, 1800, 1500, 1000, 0 };
+      const double vdds[] = { 1.2, 1.1, 1.0, 0.9, 0.8 };
+      for (UInt32 i = 0; i < sizeof(freqs) / sizeof(freqs[0]); ++i)
+      {
+         OperatingPoint op;
+         op.freq_mhz = freqs[i];
+         op.vdd = vdds[i];
+         m_operating_points.push_back(op);
+      }
+   }
+   else
+   {
+      LOG_PRINT_ERROR("No DVFS table available for %d nm technology node", technology_node);
+   }
+}
+
+const NativePowerModel::OperatingPoint& NativePowerModel::getOperatingPoint(UInt32 freq_mhz) const
+{
+   for (std::vector<OperatingPoint>::const_iterator it = m_operating_points.begin(); it != m_operating_points.end(); ++it)
+   {
+      if (freq_mhz >= it->freq_mhz)
+         return *it;
+   }
+   return m_operating_points.back();
+}
+
+void NativePowerModel::computeCorePower(const Activity &activity, UInt32 freq_mhz, SubsecondTime interval, double *static_power, double *dynamic_power) const
+{
+   const OperatingPoint &op = getOperatingPoint(freq_mhz);
+   const double seconds = interval.getFS() * 1e-15;
+
+   for (UInt32 c = 0; c < NUM_COMPONENTS; ++c)
+   {
+      static_power[c] = op.leakage[c];
+      dynamic_power[c] = seconds > 0 ? op.energy[c] * activity.events[s_component_event[c]] / seconds : 0;
+   }
+}
+
+void NativePowerModel::computeL3Power(UInt64 accesses, UInt32 freq_mhz, SubsecondTime interval, double &static_power, double &dynamic_power) const
+{
+   const OperatingPoint &op = getOperatingPoint(freq_mhz);
+   const double seconds = interval.getFS() * 1e-15;
+
+   static_power = op.l3_leakage;
+   dynamic_power = seconds > 0 ? op.l3_energy * accesses / seconds : 0;
+}
@@ -0,0 +1,77 @@
+#ifndef __NATIVE_POWER_MODEL_H
+#define __NATIVE_POWER_MODEL_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+#include <vector>
+
+// Activity-based power model, used as an in-simulator replacement for the per-epoch McPAT run.
+// Energy-per-event coefficients are configured at a reference Vdd and pre-scaled for every
+// (frequency, Vdd) point of the DVFS table, so evaluating an epoch is a handful of multiply-adds per core.
+
+class NativePowerModel
+{
+   public:
+      // Per-core components, in the order used by the power and thermal logs (see tools/mcpat.py)
+      enum component_t {
+         FPU, RBB, REN, MMU, OTHER, IW, FPIW, ROB, IRF, FPRF, CALU,
+         IALU, BTB, BP, LQ, SQ, DC, ID, IB, IC, L2,
+         NUM_COMPONENTS
+      };
+      // Activity classes that drive the components' dynamic energy
+      enum event_t {
+         EVENT_INSTRUCTIONS,
+         EVENT_BUSY_CYCLES,
+         EVENT_UOPS,
+         EVENT_UOPS_INT,
+         EVENT_UOPS_FP,
+         EVENT_BRANCHES,
+         EVENT_LOADS,
+         EVENT_STORES,
+         EVENT_L1I_ACCESSES,
+         EVENT_L1D_ACCESSES,
+         EVENT_TLB_ACCESSES,
+         EVENT_L2_ACCESSES,
+         NUM_EVENTS
+      };
+
+      struct Activity
+      {
+         UInt64 events[NUM_EVENTS];
+      };
+
+      NativePowerModel();
+
+      static const char* getComponentName(component_t component);
+      static event_t getComponentEvent(component_t component) { return s_component_event[component]; }
+
+      double getVdd(UInt32 freq_mhz) const { return getOperatingPoint(freq_mhz).vdd; }
+
+      // Power (in W) of each component of one core that ran at freq_mhz for the given interval
+      void computeCorePower(const Activity &activity, UInt32 freq_mhz, SubsecondTime interval, double *static_power, double *dynamic_power) const;
+      // Power (in W) of the shared L3, which lives in the global clock domain
+      void computeL3Power(UInt64 accesses, UInt32 freq_mhz, SubsecondTime interval, double &static_power, double &dynamic_power) const;
+
+   private:
+      struct OperatingPoint
+      {
+         UInt32 freq_mhz;
+         double vdd;
+         double energy[NUM_COMPONENTS];   // J per event
+         double leakage[NUM_COMPONENTS];  // W
+         double l3_energy;
+         double l3_leakage;
+      };
+
+      static const event_t s_component_event[NUM_COMPONENTS];
+      static const char* s_component_names[NUM_COMPONENTS];
+
+      // Sorted from highest to lowest frequency, like build_dvfs_table in scripts/energystats.py
+      std::vector<OperatingPoint> m_operating_points;
+
+      void buildDvfsTable(UInt32 technology_node);
+      const OperatingPoint& getOperatingPoint(UInt32 freq_mhz) const;
+};
+
+#endif // __NATIVE_POWER_MODEL_H
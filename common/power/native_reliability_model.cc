@@ -0,0 +1,93 @@
+#include "native_reliability_model.h"
+#include "simulator.h"
+#include "config.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// Boltzmann constant in eV/K
+static const double BOLTZMANN = 8.617333262e-5;
+
+NativeReliabilityModel::NativeReliabilityModel(UInt32 num_units)
+   : m_acceleration_factor(Sim()->getCfg()->getFloat("reliability/acceleration_factor"))
+   , m_activation_energy(Sim()->getCfg()->getFloat("reliability/native/activation_energy"))
+   , m_beta(Sim()->getCfg()->getFloat("reliability/native/weibull_beta"))
+   , m_reference_temperature(Sim()->getCfg()->getFloat("reliability/native/reference_temperature") + 273.15)
+   , m_sums(num_units, 0)
+{
+   LOG_ASSERT_ERROR(m_beta > 0, "reliability/native/weibull_beta must be positive");
+
+   // The mean of a Weibull distribution is alpha * Gamma(1 + 1 / beta)
+   const double mttf = Sim()->getCfg()->getFloat("reliability/native/mttf_reference") * 365.25 * 24 * 3600;
+   m_reference_alpha = mttf / tgamma(1 + 1 / m_beta);
+}
+
+double NativeReliabilityModel::getAlpha(double temperature) const
+{
+   return m_reference_alpha * exp(m_activation_energy / BOLTZMANN * (1 / (temperature + 273.15) - 1 / m_reference_temperature));
+}
+
+void NativeReliabilityModel::update(const double *temperatures, SubsecondTime interval)
+{
+   const double seconds = interval.getFS() * 1e-15 * m_acceleration_factor;
+   for (UInt32 i = 0; i < m_sums.size(); ++i)
+      m_sums[i] += seconds / getAlpha(temperatures[i]);
+}
+
+void NativeReliabilityModel::getRValues(double *rvalues) const
+{
+   for (UInt32 i = 0; i < m_sums.size(); ++i)
+      rvalues[i] = exp(-pow(m_sums[i], m_beta));
+}
+
+void NativeReliabilityModel::writeLogs(const std::vector<String> &names, bool append) const
+{
+   std::vector<double> rvalues(m_sums.size());
+   getRValues(&rvalues[0]);
+
+   char value[32];
+   std::ostringstream header, readings;
+   for (UInt32 i = 0; i < names.size(); ++i)
+   {
+      snprintf(value, sizeof(value), "%.12g", rvalues[i]);
+      header << (i ? "\t" : "") << names[i];
+      readings << (i ? "\t" : "") << value;
+   }
+
+   std::ofstream instantaneous(Sim()->getConfig()->formatOutputFileName("InstantaneousRvalue.log").c_str());
+   instantaneous << header.str() << "\n" << readings.str() << "\n";
+
+   std::ofstream periodic(Sim()->getConfig()->formatOutputFileName("PeriodicRvalue.log").c_str(),
+      append ? std::ios::app : std::ios::trunc);
+   if (!append)
+      periodic << header.str() << "\n";
+   periodic << readings.str() << "\n";
+}
+
+void NativeReliabilityModel::writeSums(const std::vector<String> &names) const
+{
+   std::ofstream sums(Sim()->getConfig()->formatOutputFileName(Sim()->getCfg()->getString("reliability/sum_file")).c_str());
+   char value[32];
+   for (UInt32 i = 0; i < names.size(); ++i)
+   {
+      snprintf(value, sizeof(value), "%.12g", m_sums[i]);
+      sums << names[i] << "\t" << value << "\n";
+   }
+}
+
+void NativeReliabilityModel::saveCheckpoint(const std::vector<String> &names, CheckpointManager::Section &section) const
+{
+   section.set("units", names);
+   section.set("sums", m_sums);
+}
+
+void NativeReliabilityModel::restoreCheckpoint(const std::vector<String> &names, const CheckpointManager::Section &section)
+{
+   LOG_ASSERT_ERROR(section.getStringArray("units") == names, "Checkpoint has the damage sums of other units");
+   m_sums = section.getFloatArray("sums");
+   LOG_ASSERT_ERROR(m_sums.size() == names.size(), "Checkpoint has %d damage sums, expected %d", m_sums.size(), names.size());
+}
@@ -0,0 +1,47 @@
+#ifndef __NATIVE_RELIABILITY_MODEL_H
+#define __NATIVE_RELIABILITY_MODEL_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "checkpoint_manager.h"
+
+#include <vector>
+
+// In-simulator wear-out model, replacing the reliability/reliability_external binary.
+// Every unit accumulates the damage sum(dt / alpha(T)) over the epochs, where alpha(T) is the Weibull
+// scale parameter of the unit at temperature T: calibrated by a reference MTTF at a reference temperature
+// and scaled with the Arrhenius term of Black's equation (electromigration).
+// The R-value, the probability that the unit did not fail yet, is exp(-sum^beta).
+// The sums are kept in memory, so an epoch is a few flops per unit.
+
+class NativeReliabilityModel
+{
+   public:
+      NativeReliabilityModel(UInt32 num_units);
+
+      // Add the wear-out of an epoch of the given (simulated, not yet accelerated) length at the given temperatures (Celsius)
+      void update(const double *temperatures, SubsecondTime interval);
+      void getRValues(double *rvalues) const;
+
+      // Instantaneous/PeriodicRvalue.log, in the format of the external model
+      void writeLogs(const std::vector<String> &names, bool append) const;
+      // Per-unit damage sums ([reliability] sum_file)
+      void writeSums(const std::vector<String> &names) const;
+
+      // Damage sums, to continue the wear-out of the units in a later run
+      void saveCheckpoint(const std::vector<String> &names, CheckpointManager::Section &section) const;
+      void restoreCheckpoint(const std::vector<String> &names, const CheckpointManager::Section &section);
+
+   private:
+      const double m_acceleration_factor;
+      const double m_activation_energy;    // eV
+      const double m_beta;
+      const double m_reference_temperature; // K
+      double m_reference_alpha;             // s
+
+      std::vector<double> m_sums;
+
+      double getAlpha(double temperature) const;
+};
+
+#endif // __NATIVE_RELIABILITY_MODEL_H
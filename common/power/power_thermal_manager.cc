@@ -0,0 +1,737 @@
+#include "power_thermal_manager.h"
+#include "telemetry.h"
+#include "simulator.h"
+#include "hooks_manager.h"
+#include "magic_server.h"
+#include "dvfs_manager.h"
+#include "hit_where.h"
+#include "stats.h"
+#include "config.hpp"
+#include "log.h"
+#include "itostr.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+PowerThermalManager* PowerThermalManager::create()
+{
+   String engine = Sim()->getCfg()->getString("periodic_power/engine");
+
+   if (engine == "native")
+      return new PowerThermalManager();
+   else if (engine == "mcpat")
+      return NULL; // Handled by scripts/energystats.py
+   else
+      LOG_PRINT_ERROR("Unknown periodic power engine %s", engine.c_str());
+   return NULL;
+}
+
+PowerThermalManager::PowerThermalManager()
+   : m_num_cores(Sim()->getConfig()->getApplicationCores())
+   , m_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("periodic_power/interval")))
+   , m_has_l3(Sim()->getCfg()->getInt("perf_model/cache/levels") == 3)
+   , m_thermal_enabled(Sim()->getCfg()->getBool("periodic_thermal/enabled"))
+   , m_reliability_enabled(Sim()->getCfg()->getBool("reliability/enabled"))
+   , m_export_logs(Sim()->getCfg()->getBool("telemetry/export_logs"))
+   , m_core_metrics(m_num_cores, std::vector<StatsMetricBase*>(NUM_RAW_STATS, NULL))
+   , m_core_last(m_num_cores, std::vector<UInt64>(NUM_RAW_STATS, 0))
+   , m_l3_last(0)
+   , m_have_snapshot(false)
+   , m_logs_initialized(false)
+   , m_last_update(SubsecondTime::Zero())
+   , m_next_update(SubsecondTime::Zero())
+   , m_static_power(m_num_cores * NativePowerModel::NUM_COMPONENTS, 0)
+   , m_dynamic_power(m_num_cores * NativePowerModel::NUM_COMPONENTS, 0)
+   , m_l3_static_power(0)
+   , m_l3_dynamic_power(0)
+   , m_energy(m_num_cores)
+   , m_processor_static_energy(0)
+   , m_processor_dynamic_energy(0)
+   , m_thermal(NULL)
+   , m_reliability(NULL)
+   , m_pipeline_thread(NULL)
+   , m_pipeline_running(false)
+   , m_pipeline_quit(false)
+   , m_job_pending(false)
+   , m_job_append_logs(false)
+   , m_job_interval(SubsecondTime::Zero())
+{
+   LOG_ASSERT_ERROR(m_interval > SubsecondTime::Zero(), "periodic_power/interval must be positive");
+
+   String pipeline = Sim()->getCfg()->getString("periodic_power/pipeline");
+   if (pipeline == "off")
+      m_pipeline = PIPELINE_OFF;
+   else if (pipeline == "lag")
+      m_pipeline = PIPELINE_LAG;
+   else if (pipeline == "block")
+      m_pipeline = PIPELINE_BLOCK;
+   else
+      LOG_PRINT_ERROR("Unknown periodic_power/pipeline mode %s", pipeline.c_str());
+
+   // Core statistics are registered when the cores are created, which happens before we are
+   const char *timer = findMetric("interval_timer", 0, "uop_generic") ? "interval_timer" : "rob_timer";
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+   {
+      std::vector<StatsMetricBase*> &metrics = m_core_metrics[core];
+      metrics[STAT_INSTRUCTIONS] = findMetric("performance_model", core, "instruction_count");
+      metrics[STAT_ELAPSED_TIME] = findMetric("performance_model", core, "elapsed_time");
+      metrics[STAT_IDLE_ELAPSED_TIME] = findMetric("performance_model", core, "idle_elapsed_time");
+      metrics[STAT_UOP_FP_ADDSUB] = findMetric(timer, core, "uop_fp_addsub");
+      metrics[STAT_UOP_FP_MULDIV] = findMetric(timer, core, "uop_fp_muldiv");
+      metrics[STAT_UOP_LOAD] = findMetric(timer, core, "uop_load");
+      metrics[STAT_UOP_STORE] = findMetric(timer, core, "uop_store");
+      metrics[STAT_UOP_GENERIC] = findMetric(timer, core, "uop_generic");
+      metrics[STAT_UOP_BRANCH] = findMetric(timer, core, "uop_branch");
+      metrics[STAT_L1I_LOADS] = findMetric("L1-I", core, "loads");
+      metrics[STAT_L1D_LOADS] = findMetric("L1-D", core, "loads");
+      metrics[STAT_L1D_STORES] = findMetric("L1-D", core, "stores");
+      metrics[STAT_L2_LOADS] = findMetric("L2", core, "loads");
+      metrics[STAT_L2_STORES] = findMetric("L2", core, "stores");
+
+      // L3 / NUCA slices only exist on their master cores
+      const char *l3_object = m_has_l3 ? "L3" : "nuca-cache";
+      const char *l3_reads = m_has_l3 ? "loads" : "reads";
+      const char *l3_writes = m_has_l3 ? "stores" : "writes";
+      if (StatsMetricBase *metric = findMetric(l3_object, core, l3_reads))
+         m_l3_metrics.push_back(metric);
+      if (StatsMetricBase *metric = findMetric(l3_object, core, l3_writes))
+         m_l3_metrics.push_back(metric);
+
+      registerStatsMetric("core", core, "energy-static", &m_energy[core].core_static);
+      registerStatsMetric("core", core, "energy-dynamic", &m_energy[core].core_dynamic);
+      registerStatsMetric("L1-I", core, "energy-static", &m_energy[core].l1i_static);
+      registerStatsMetric("L1-I", core, "energy-dynamic", &m_energy[core].l1i_dynamic);
+      registerStatsMetric("L1-D", core, "energy-static", &m_energy[core].l1d_static);
+      registerStatsMetric("L1-D", core, "energy-dynamic", &m_energy[core].l1d_dynamic);
+      registerStatsMetric("L2", core, "energy-static", &m_energy[core].l2_static);
+      registerStatsMetric("L2", core, "energy-dynamic", &m_energy[core].l2_dynamic);
+   }
+   registerStatsMetric("processor", 0, "energy-static", &m_processor_static_energy);
+   registerStatsMetric("processor", 0, "energy-dynamic", &m_processor_dynamic_energy);
+
+   if (m_has_l3)
+      m_unit_names.push_back("L3");
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+      for (UInt32 c = 0; c < NativePowerModel::NUM_COMPONENTS; ++c)
+         m_unit_names.push_back("C_" + itostr(core) + "_" + NativePowerModel::getComponentName(NativePowerModel::component_t(c)));
+   m_unit_power.resize(m_unit_names.size(), 0);
+   m_unit_temperature.resize(m_unit_names.size(), 0);
+   m_unit_rvalue.resize(m_unit_names.size(), -1);
+   Sim()->getTelemetry()->setUnits(m_unit_names);
+
+   initCpiStack();
+
+   if (m_thermal_enabled)
+      initThermal();
+
+   if (m_reliability_enabled)
+   {
+      String engine = Sim()->getCfg()->getString("reliability/engine");
+      if (engine == "native")
+         m_reliability = new NativeReliabilityModel(m_unit_names.size());
+      else if (engine != "external")
+         LOG_PRINT_ERROR("Unknown reliability engine %s", engine.c_str());
+   }
+
+   CheckpointManager *checkpoint = Sim()->getCheckpointManager();
+   if (const CheckpointManager::Section *section = checkpoint->getRestoredSection("power_thermal"))
+      restoreCheckpoint(*section);
+   const CheckpointManager::Section *reliability = checkpoint->getRestoredSection("reliability");
+   if (reliability && reliability->has("units") && m_reliability)
+   {
+      m_reliability->restoreCheckpoint(m_unit_names, *reliability);
+      m_reliability->getRValues(&m_unit_rvalue[0]);
+      Sim()->getTelemetry()->publish(Telemetry::RVALUE, &m_unit_rvalue[0]);
+   }
+   checkpoint->registerComponent("power_thermal", checkpoint_save, (UInt64)this);
+   if (m_reliability)
+      checkpoint->registerComponent("reliability", checkpoint_save_reliability, (UInt64)this);
+
+   if (m_pipeline != PIPELINE_OFF)
+   {
+      m_pipeline_running = true;
+      m_pipeline_thread = _Thread::create(this);
+      m_pipeline_thread->run();
+   }
+
+   Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, hook_periodic, (UInt64)this, HooksManager::ORDER_NOTIFY_PRE);
+}
+
+PowerThermalManager::~PowerThermalManager()
+{
+   if (m_pipeline_thread)
+   {
+      ScopedLock sl(m_pipeline_lock);
+      while (m_job_pending)
+         m_pipeline_done.wait(m_pipeline_lock);
+      m_pipeline_quit = true;
+      m_pipeline_submitted.signal();
+      while (m_pipeline_running)
+         m_pipeline_done.wait(m_pipeline_lock);
+   }
+   delete m_pipeline_thread;
+
+   if (m_thermal)
+   {
+      // Same content as the hotspot binary's stdout, can be used as init_file for a follow-up run
+      hotspot_thermal_dump(m_thermal, Sim()->getConfig()->formatOutputFileName("Temperature.init").c_str());
+      hotspot_thermal_free(m_thermal);
+   }
+   if (m_reliability)
+   {
+      m_reliability->writeSums(m_unit_names);
+      delete m_reliability;
+   }
+}
+
+StatsMetricBase* PowerThermalManager::findMetric(const char *objectName, UInt32 index, const char *metricName)
+{
+   return Sim()->getStatsManager()->getMetricObject(objectName, index, metricName);
+}
+
+UInt64 PowerThermalManager::readMetric(StatsMetricBase *metric)
+{
+   // Components that do not exist on this core (e.g. shared caches on non-master cores) count as zero
+   return metric ? metric->recordMetric() : 0;
+}
+
+void PowerThermalManager::periodic(SubsecondTime time)
+{
+   if (time < m_next_update)
+      return;
+   m_next_update = time + m_interval;
+
+   // Like energystats.py (roi_only = True), only account for time inside the region of interest
+   if (!Sim()->getMagicServer()->inROI())
+   {
+      m_have_snapshot = false;
+      return;
+   }
+
+   if (m_have_snapshot)
+      update(time);
+
+   snapshot();
+   m_last_update = time;
+   m_have_snapshot = true;
+}
+
+void PowerThermalManager::snapshot()
+{
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+      for (UInt32 s = 0; s < NUM_RAW_STATS; ++s)
+         m_core_last[core][s] = readMetric(m_core_metrics[core][s]);
+
+   m_l3_last = 0;
+   for (std::vector<StatsMetricBase*>::const_iterator it = m_l3_metrics.begin(); it != m_l3_metrics.end(); ++it)
+      m_l3_last += readMetric(*it);
+
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+      for (UInt32 i = 0; i < m_cpi_metrics[core].size(); ++i)
+         m_cpi_last[core][i] = readMetric(m_cpi_metrics[core][i].first);
+}
+
+void PowerThermalManager::update(SubsecondTime time)
+{
+   SubsecondTime interval = time - m_last_update;
+
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+   {
+      UInt64 delta[NUM_RAW_STATS];
+      for (UInt32 s = 0; s < NUM_RAW_STATS; ++s)
+         delta[s] = readMetric(m_core_metrics[core][s]) - m_core_last[core][s];
+
+      UInt32 freq_mhz = Sim()->getDvfsManager()->getCoreDomain(core)->getPeriodInFreqMHz();
+      UInt64 busy_fs = delta[STAT_ELAPSED_TIME] > delta[STAT_IDLE_ELAPSED_TIME] ? delta[STAT_ELAPSED_TIME] - delta[STAT_IDLE_ELAPSED_TIME] : 0;
+
+      NativePowerModel::Activity activity;
+      activity.events[NativePowerModel::EVENT_INSTRUCTIONS] = delta[STAT_INSTRUCTIONS];
+      activity.events[NativePowerModel::EVENT_BUSY_CYCLES] = UInt64(busy_fs * (freq_mhz * 1e-9));
+      activity.events[NativePowerModel::EVENT_UOPS_INT] = delta[STAT_UOP_GENERIC] + delta[STAT_UOP_LOAD] + delta[STAT_UOP_STORE];
+      activity.events[NativePowerModel::EVENT_UOPS_FP] = delta[STAT_UOP_FP_ADDSUB] + delta[STAT_UOP_FP_MULDIV];
+      activity.events[NativePowerModel::EVENT_UOPS] = activity.events[NativePowerModel::EVENT_UOPS_INT] + activity.events[NativePowerModel::EVENT_UOPS_FP] + delta[STAT_UOP_BRANCH];
+      activity.events[NativePowerModel::EVENT_BRANCHES] = delta[STAT_UOP_BRANCH];
+      activity.events[NativePowerModel::EVENT_LOADS] = delta[STAT_UOP_LOAD];
+      activity.events[NativePowerModel::EVENT_STORES] = delta[STAT_UOP_STORE];
+      activity.events[NativePowerModel::EVENT_L1I_ACCESSES] = delta[STAT_L1I_LOADS];
+      activity.events[NativePowerModel::EVENT_L1D_ACCESSES] = delta[STAT_L1D_LOADS] + delta[STAT_L1D_STORES];
+      activity.events[NativePowerModel::EVENT_TLB_ACCESSES] = delta[STAT_L1I_LOADS] + delta[STAT_L1D_LOADS] + delta[STAT_L1D_STORES];
+      activity.events[NativePowerModel::EVENT_L2_ACCESSES] = delta[STAT_L2_LOADS] + delta[STAT_L2_STORES];
+
+      m_power_model.computeCorePower(activity, freq_mhz, interval,
+         &m_static_power[core * NativePowerModel::NUM_COMPONENTS], &m_dynamic_power[core * NativePowerModel::NUM_COMPONENTS]);
+   }
+
+   UInt64 l3_accesses = 0;
+   for (std::vector<StatsMetricBase*>::const_iterator it = m_l3_metrics.begin(); it != m_l3_metrics.end(); ++it)
+      l3_accesses += readMetric(*it);
+   if (m_has_l3)
+      m_power_model.computeL3Power(l3_accesses - m_l3_last, Sim()->getDvfsManager()->getGlobalDomain()->getPeriodInFreqMHz(), interval, m_l3_static_power, m_l3_dynamic_power);
+
+   updateEnergy(interval);
+   updateCpiStack(interval);
+   if (m_export_logs)
+      writeActivityLogs(m_logs_initialized);
+
+   UInt32 unit = 0;
+   if (m_has_l3)
+      m_unit_power[unit++] = m_l3_static_power + m_l3_dynamic_power;
+   for (UInt32 i = 0; i < m_num_cores * NativePowerModel::NUM_COMPONENTS; ++i)
+      m_unit_power[unit++] = m_static_power[i] + m_dynamic_power[i];
+   Sim()->getTelemetry()->publish(Telemetry::POWER, &m_unit_power[0]);
+
+   if (m_pipeline == PIPELINE_OFF)
+      processEpoch(m_unit_power, interval, m_logs_initialized);
+   else
+      submitEpoch(interval);
+
+   m_logs_initialized = true;
+}
+
+void PowerThermalManager::processEpoch(const std::vector<double> &power, SubsecondTime interval, bool append_logs)
+{
+   if (m_export_logs)
+      writePowerLogs(power, append_logs);
+
+   if (m_thermal_enabled)
+   {
+      runThermal(power, interval, append_logs);
+      if (m_reliability_enabled)
+         runReliability(interval, append_logs);
+   }
+}
+
+void PowerThermalManager::submitEpoch(SubsecondTime interval)
+{
+   ScopedLock sl(m_pipeline_lock);
+
+   // At most one epoch in flight: the thermal model state and the job buffers are not shared
+   while (m_job_pending)
+      m_pipeline_done.wait(m_pipeline_lock);
+
+   m_job_power = m_unit_power;
+   m_job_interval = interval;
+   m_job_append_logs = m_logs_initialized;
+   m_job_pending = true;
+   m_pipeline_submitted.signal();
+}
+
+void PowerThermalManager::drainPipeline()
+{
+   ScopedLock sl(m_pipeline_lock);
+
+   while (m_job_pending)
+      m_pipeline_done.wait(m_pipeline_lock);
+}
+
+void PowerThermalManager::waitForResults()
+{
+   if (m_pipeline == PIPELINE_BLOCK)
+      drainPipeline();
+}
+
+void PowerThermalManager::run()
+{
+   m_pipeline_lock.acquire();
+   while (true)
+   {
+      while (!m_job_pending && !m_pipeline_quit)
+         m_pipeline_submitted.wait(m_pipeline_lock);
+      if (!m_job_pending)
+         break;
+
+      // The job buffers are not touched by the simulation while m_job_pending is set
+      m_pipeline_lock.release();
+      processEpoch(m_job_power, m_job_interval, m_job_append_logs);
+      m_pipeline_lock.acquire();
+
+      m_job_pending = false;
+      m_pipeline_done.broadcast();
+   }
+   m_pipeline_running = false;
+   m_pipeline_done.broadcast();
+   m_pipeline_lock.release();
+}
+
+void PowerThermalManager::updateEnergy(SubsecondTime interval)
+{
+   // Same units as scripts/energystats.py: femtoseconds times Watt
+   const double fs = interval.getFS();
+
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+   {
+      const double *static_power = &m_static_power[core * NativePowerModel::NUM_COMPONENTS];
+      const double *dynamic_power = &m_dynamic_power[core * NativePowerModel::NUM_COMPONENTS];
+      Energy &energy = m_energy[core];
+
+      double core_static = 0, core_dynamic = 0;
+      for (UInt32 c = 0; c < NativePowerModel::NUM_COMPONENTS; ++c)
+      {
+         switch(c)
+         {
+            case NativePowerModel::IC:
+               energy.l1i_static += UInt64(fs * static_power[c]);
+               energy.l1i_dynamic += UInt64(fs * dynamic_power[c]);
+               break;
+            case NativePowerModel::DC:
+               energy.l1d_static += UInt64(fs * static_power[c]);
+               energy.l1d_dynamic += UInt64(fs * dynamic_power[c]);
+               break;
+            case NativePowerModel::L2:
+               energy.l2_static += UInt64(fs * static_power[c]);
+               energy.l2_dynamic += UInt64(fs * dynamic_power[c]);
+               break;
+            default:
+               core_static += static_power[c];
+               core_dynamic += dynamic_power[c];
+         }
+         m_processor_static_energy += UInt64(fs * static_power[c]);
+         m_processor_dynamic_energy += UInt64(fs * dynamic_power[c]);
+      }
+      energy.core_static += UInt64(fs * core_static);
+      energy.core_dynamic += UInt64(fs * core_dynamic);
+   }
+
+   m_processor_static_energy += UInt64(fs * m_l3_static_power);
+   m_processor_dynamic_energy += UInt64(fs * m_l3_dynamic_power);
+}
+
+// CPI stack labels, following the (compacted) stack of tools/mcpat.py:log_cpi_stack
+static const char* s_cpi_labels[] = {
+   "total", "base", "rs_full", "serial", "smt", "branch", "itlb", "dtlb", "ifetch",
+   "mem-l1d", "mem-l2", "mem-l3", "mem-l4", "mem-remote", "mem-nuca", "mem-dram-cache", "mem-dram",
+   "sync", "dvfs-transition", "imbalance",
+};
+
+static UInt32 getCpiLabel(const String &label)
+{
+   for (UInt32 i = 0; i < sizeof(s_cpi_labels) / sizeof(s_cpi_labels[0]); ++i)
+      if (label == s_cpi_labels[i])
+         return i;
+   LOG_PRINT_ERROR("Unknown CPI stack label %s", label.c_str());
+   return 0;
+}
+
+// Map a cpi<component> statistic onto its CPI stack label (see tools/cpistack_items.py)
+static String getCpiComponentLabel(const String &component)
+{
+   if (component == "Base") return "base";
+   if (component == "RSFull") return "rs_full";
+   if (component == "Serialization" || component == "LongLatency") return "serial";
+   if (component == "SMT") return "smt";
+   if (component == "BranchPredictor") return "branch";
+   if (component == "ITLBMiss") return "itlb";
+   if (component == "DTLBMiss") return "dtlb";
+   if (component == "StartTime") return "imbalance";
+   if (component == "SyncDvfsTransition") return "dvfs-transition";
+   if (component.compare(0, 4, "Sync") == 0 || component == "Recv") return "sync";
+   if (component.compare(0, 16, "InstructionCache") == 0 || component == "DataCacheL1I") return "ifetch";
+
+   const String where = component.substr(strlen("DataCache"));
+   if (where == "L1" || where == "L1_S") return "mem-l1d";
+   if (where == "L2" || where == "L2_S") return "mem-l2";
+   if (where == "L3" || where == "L3_S") return "mem-l3";
+   if (where == "L4" || where == "L4_S") return "mem-l4";
+   if (where == "cache-remote") return "mem-remote";
+   if (where == "nuca-cache") return "mem-nuca";
+   if (where == "dram-cache") return "mem-dram-cache";
+   return "mem-dram";
+}
+
+void PowerThermalManager::initCpiStack()
+{
+   m_cpi_labels.assign(s_cpi_labels, s_cpi_labels + sizeof(s_cpi_labels) / sizeof(s_cpi_labels[0]));
+   m_cpi_metrics.resize(m_num_cores);
+   m_cpi_last.resize(m_num_cores);
+   m_cpi_stack.resize(m_cpi_labels.size() * m_num_cores, 0);
+
+   const char *timer = findMetric("interval_timer", 0, "cpiBase") ? "interval_timer" : "rob_timer";
+   const char *timer_components[] = { "Base", "BranchPredictor", "Serialization", "LongLatency", "RSFull", "SMT" };
+   const char *model_components[] = {
+      "StartTime", "SyncFutex", "SyncPthreadMutex", "SyncPthreadCond", "SyncPthreadBarrier", "SyncJoin", "SyncPause",
+      "SyncSleep", "SyncSyscall", "SyncUnscheduled", "SyncDvfsTransition", "Recv", "ITLBMiss", "DTLBMiss",
+   };
+
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+   {
+      for (UInt32 i = 0; i < sizeof(timer_components) / sizeof(timer_components[0]); ++i)
+         addCpiMetric(core, timer, timer_components[i]);
+      for (UInt32 i = 0; i < sizeof(model_components) / sizeof(model_components[0]); ++i)
+         addCpiMetric(core, "performance_model", model_components[i]);
+      for (int h = HitWhere::WHERE_FIRST; h < HitWhere::NUM_HITWHERES; h++)
+      {
+         if (HitWhereIsValid((HitWhere::where_t)h))
+         {
+            addCpiMetric(core, timer, "InstructionCache" + String(HitWhereString((HitWhere::where_t)h)));
+            addCpiMetric(core, timer, "DataCache" + String(HitWhereString((HitWhere::where_t)h)));
+         }
+      }
+      m_cpi_last[core].resize(m_cpi_metrics[core].size(), 0);
+   }
+
+   Sim()->getTelemetry()->setCpiStackLabels(m_cpi_labels);
+}
+
+void PowerThermalManager::addCpiMetric(UInt32 core, const char *objectName, const String &component)
+{
+   if (StatsMetricBase *metric = findMetric(objectName, core, ("cpi" + component).c_str()))
+      m_cpi_metrics[core].push_back(std::make_pair(metric, getCpiLabel(getCpiComponentLabel(component))));
+}
+
+void PowerThermalManager::updateCpiStack(SubsecondTime interval)
+{
+   const UInt32 label_total = getCpiLabel("total"), label_imbalance = getCpiLabel("imbalance");
+   std::fill(m_cpi_stack.begin(), m_cpi_stack.end(), 0);
+
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+   {
+      const UInt64 instructions = readMetric(m_core_metrics[core][STAT_INSTRUCTIONS]) - m_core_last[core][STAT_INSTRUCTIONS];
+      if (instructions == 0)
+         continue;
+
+      // Time (fs) to cycles per instruction
+      const double scale = Sim()->getDvfsManager()->getCoreDomain(core)->getPeriodInFreqMHz() * 1e-9 / instructions;
+
+      double accounted = 0;
+      for (UInt32 i = 0; i < m_cpi_metrics[core].size(); ++i)
+      {
+         const UInt64 value = readMetric(m_cpi_metrics[core][i].first);
+         const double cpi = (value - m_cpi_last[core][i]) * scale;
+         m_cpi_stack[m_cpi_metrics[core][i].second * m_num_cores + core] += cpi;
+         accounted += cpi;
+      }
+
+      // Like cpistack_data.py, whatever is not accounted for within the interval is imbalance
+      const double total = interval.getFS() * scale;
+      m_cpi_stack[label_total * m_num_cores + core] = total;
+      m_cpi_stack[label_imbalance * m_num_cores + core] += std::max(0., total - accounted);
+   }
+
+   Sim()->getTelemetry()->publishCpiStack(&m_cpi_stack[0]);
+}
+
+void PowerThermalManager::saveCheckpoint(CheckpointManager::Section &section)
+{
+   // The thermal and reliability models are updated by the epoch in flight
+   drainPipeline();
+
+   section.set("units", m_unit_names);
+   section.set("unit_power", m_unit_power);
+   section.set("cpi_stack", m_cpi_stack);
+   if (m_thermal)
+   {
+      hotspot_thermal_save(m_thermal, Sim()->getCheckpointManager()->getSaveFileName("thermal").c_str());
+      section.set("unit_temperature", m_unit_temperature);
+   }
+}
+
+void PowerThermalManager::restoreCheckpoint(const CheckpointManager::Section &section)
+{
+   LOG_ASSERT_ERROR(section.getStringArray("units") == m_unit_names, "Checkpoint has the state of another floorplan");
+
+   m_unit_power = section.getFloatArray("unit_power");
+   Sim()->getTelemetry()->publish(Telemetry::POWER, &m_unit_power[0]);
+   std::vector<double> cpi_stack = section.getFloatArray("cpi_stack");
+   if (cpi_stack.size() == m_cpi_stack.size())
+   {
+      m_cpi_stack = cpi_stack;
+      Sim()->getTelemetry()->publishCpiStack(&m_cpi_stack[0]);
+   }
+
+   if (m_thermal)
+   {
+      LOG_ASSERT_ERROR(section.has("unit_temperature"), "Checkpoint was saved without the thermal model");
+      hotspot_thermal_restore(m_thermal, Sim()->getCheckpointManager()->getRestoredFileName("thermal").c_str());
+      m_unit_temperature = section.getFloatArray("unit_temperature");
+      Sim()->getTelemetry()->publish(Telemetry::TEMPERATURE, &m_unit_temperature[0]);
+   }
+}
+
+void PowerThermalManager::saveReliabilityCheckpoint(CheckpointManager::Section &section)
+{
+   drainPipeline();
+   m_reliability->saveCheckpoint(m_unit_names, section);
+}
+
+String PowerThermalManager::getHeader() const
+{
+   String header;
+   for (std::vector<String>::const_iterator it = m_unit_names.begin(); it != m_unit_names.end(); ++it)
+      header += (it == m_unit_names.begin() ? "" : "\t") + *it;
+   return header;
+}
+
+void PowerThermalManager::writePowerLogs(const std::vector<double> &power, bool append)
+{
+   String header = getHeader();
+
+   char value[32];
+   std::ostringstream readings;
+   for (std::vector<double>::const_iterator it = power.begin(); it != power.end(); ++it)
+   {
+      snprintf(value, sizeof(value), "%.12g", *it);
+      readings << value << "\t";
+   }
+
+   std::ofstream instantaneous(Sim()->getConfig()->formatOutputFileName("InstantaneousPower.log").c_str());
+   instantaneous << header << "\n" << readings.str() << "\n";
+
+   std::ofstream periodic(Sim()->getConfig()->formatOutputFileName("PeriodicPower.log").c_str(),
+      append ? std::ios::app : std::ios::trunc);
+   if (!append)
+      periodic << header << "\n";
+   periodic << readings.str() << "\n";
+}
+
+void PowerThermalManager::writeActivityLogs(bool append)
+{
+   // Same format as tools/mcpat.py:log_frequencies and log_cpi_stack
+   String header = "Core0";
+   for (UInt32 core = 1; core < m_num_cores; ++core)
+      header += "\tCore" + itostr(core);
+
+   char value[32];
+   std::ofstream frequencies(Sim()->getConfig()->formatOutputFileName("PeriodicFrequency.log").c_str(),
+      append ? std::ios::app : std::ios::trunc);
+   if (!append)
+      frequencies << header << "\n";
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+   {
+      snprintf(value, sizeof(value), "%.3f", Sim()->getDvfsManager()->getCoreDomain(core)->getPeriodInFreqMHz() / 1000.);
+      frequencies << (core ? "\t" : "") << value;
+   }
+   frequencies << "\n";
+
+   std::ofstream cpi_stack(Sim()->getConfig()->formatOutputFileName("PeriodicCPIStack.log").c_str(),
+      append ? std::ios::app : std::ios::trunc);
+   if (!append)
+      cpi_stack << "Metric\t" << header << "\n";
+   for (UInt32 label = 0; label < m_cpi_labels.size(); ++label)
+   {
+      const double *values = &m_cpi_stack[label * m_num_cores];
+      bool any = false;
+      for (UInt32 core = 0; core < m_num_cores; ++core)
+         any |= values[core] > 0.001;
+
+      cpi_stack << m_cpi_labels[label] << "\t";
+      if (!any)
+         cpi_stack << "-";
+      else
+         for (UInt32 core = 0; core < m_num_cores; ++core)
+         {
+            snprintf(value, sizeof(value), "%.3f", values[core]);
+            cpi_stack << (core ? "\t" : "") << value;
+         }
+      cpi_stack << "\n";
+   }
+}
+
+void PowerThermalManager::initThermal()
+{
+   const char *sniper_root = getenv("SNIPER_ROOT");
+   LOG_ASSERT_ERROR(sniper_root, "Please make sure SNIPER_ROOT is set");
+
+   String hotspot_dir = String(sniper_root) + "/hotspot";
+   String config_file = hotspot_dir + "/" + Sim()->getCfg()->getString("periodic_thermal/hotspot_config");
+   String floorplan = hotspot_dir + "/" + Sim()->getCfg()->getString("periodic_thermal/floorplan");
+   String reduced_model = Sim()->getCfg()->getString("periodic_thermal/reduced_model");
+
+   std::vector<const char*> names;
+   for (std::vector<String>::const_iterator it = m_unit_names.begin(); it != m_unit_names.end(); ++it)
+      names.push_back(it->c_str());
+
+   // The RC model is built once; temperatures are kept in memory from one epoch to the next
+   if (reduced_model != "")
+      m_thermal = hotspot_thermal_alloc_reduced((hotspot_dir + "/" + reduced_model).c_str(), &names[0], names.size());
+   else
+      m_thermal = hotspot_thermal_alloc(config_file.c_str(), floorplan.c_str(), NULL, &names[0], names.size());
+}
+
+void PowerThermalManager::runThermal(const std::vector<double> &power, SubsecondTime interval, bool append_logs)
+{
+   hotspot_thermal_step(m_thermal, &power[0], interval.getFS() * 1e-15, &m_unit_temperature[0]);
+   for (std::vector<double>::iterator it = m_unit_temperature.begin(); it != m_unit_temperature.end(); ++it)
+      *it -= 273.15;
+   Sim()->getTelemetry()->publish(Telemetry::TEMPERATURE, &m_unit_temperature[0]);
+
+   // The external reliability model reads the temperatures from file
+   if (!m_export_logs && !(m_reliability_enabled && !m_reliability))
+      return;
+
+   // Same format as the hotspot binary's transient trace (write_vals in hotspot/hotspot.c)
+   char value[32];
+   std::ostringstream readings;
+   for (std::vector<double>::const_iterator it = m_unit_temperature.begin(); it != m_unit_temperature.end(); ++it)
+   {
+      snprintf(value, sizeof(value), "%.2f", *it);
+      readings << (it == m_unit_temperature.begin() ? "" : "\t") << value;
+   }
+
+   std::ofstream instantaneous(Sim()->getConfig()->formatOutputFileName("InstantaneousTemperature.log").c_str());
+   instantaneous << getHeader() << "\n" << readings.str() << "\n";
+
+   if (!m_export_logs)
+      return;
+
+   std::ofstream periodic(Sim()->getConfig()->formatOutputFileName("PeriodicThermal.log").c_str(),
+      append_logs ? std::ios::app : std::ios::trunc);
+   if (!append_logs)
+      periodic << getHeader() << "\n";
+   periodic << readings.str() << "\n";
+}
+
+void PowerThermalManager::runReliability(SubsecondTime interval, bool append_logs)
+{
+   if (m_reliability)
+   {
+      m_reliability->update(&m_unit_temperature[0], interval);
+      m_reliability->getRValues(&m_unit_rvalue[0]);
+      Sim()->getTelemetry()->publish(Telemetry::RVALUE, &m_unit_rvalue[0]);
+      if (m_export_logs)
+         m_reliability->writeLogs(m_unit_names, append_logs);
+      return;
+   }
+
+   const char *sniper_root = getenv("SNIPER_ROOT");
+   LOG_ASSERT_ERROR(sniper_root, "Please make sure SNIPER_ROOT is set");
+
+   String rvalues = Sim()->getConfig()->formatOutputFileName("InstantaneousRvalue.log");
+
+   char args[64];
+   snprintf(args, sizeof(args), " %.12g ", interval.getFS() * 1e-12);
+   String cmd = String(sniper_root) + "/" + Sim()->getCfg()->getString("reliability/reliability_executable")
+      + args + Sim()->getConfig()->formatOutputFileName("InstantaneousTemperature.log")
+      + " " + Sim()->getConfig()->formatOutputFileName(Sim()->getCfg()->getString("reliability/sum_file"))
+      + " " + rvalues
+      + " " + Sim()->getCfg()->getString("reliability/acceleration_factor");
+   LOG_ASSERT_ERROR(system(cmd.c_str()) == 0, "Reliability model failed: %s", cmd.c_str());
+
+   std::ifstream instantaneous(rvalues.c_str());
+   std::string header, readings;
+   std::getline(instantaneous, header);
+   std::getline(instantaneous, readings);
+
+   // Map the columns back onto the floorplan units
+   std::istringstream iss_header(header), iss_readings(readings);
+   std::string name, value;
+   std::fill(m_unit_rvalue.begin(), m_unit_rvalue.end(), -1);
+   while (std::getline(iss_header, name, '\t') && std::getline(iss_readings, value, '\t'))
+   {
+      std::vector<String>::const_iterator it = std::find(m_unit_names.begin(), m_unit_names.end(), String(name.c_str()));
+      if (it != m_unit_names.end())
+         m_unit_rvalue[it - m_unit_names.begin()] = atof(value.c_str());
+   }
+   Sim()->getTelemetry()->publish(Telemetry::RVALUE, &m_unit_rvalue[0]);
+
+   if (!m_export_logs)
+      return;
+
+   std::ofstream periodic(Sim()->getConfig()->formatOutputFileName("PeriodicRvalue.log").c_str(),
+      append_logs ? std::ios::app : std::ios::trunc);
+   if (!append_logs)
+      periodic << getHeader() << "\n";
+   periodic << readings << "\n";
+}
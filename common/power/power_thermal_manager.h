@@ -0,0 +1,160 @@
+#ifndef __POWER_THERMAL_MANAGER_H
+#define __POWER_THERMAL_MANAGER_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "native_power_model.h"
+#include "native_reliability_model.h"
+#include "hotspot_lib.h"
+#include "checkpoint_manager.h"
+#include "_thread.h"
+#include "lock.h"
+#include "cond.h"
+
+#include <vector>
+
+class StatsMetricBase;
+
+// Drives the periodic power -> temperature -> reliability pipeline from inside the simulator
+// when [periodic_power/engine] = native, replacing scripts/energystats.py + tools/mcpat.py.
+// Produces the same Instantaneous*.log / Periodic*.log files as the McPAT-based flow.
+// Temperatures come from a HotSpot model that is built once and kept in memory (hotspot/hotspot_lib.h).
+// Every epoch's power, temperature, R-values and CPI stack are published to the Telemetry snapshot;
+// the log files are an optional export ([telemetry] export_logs).
+//
+// With [periodic_power] pipeline = lag or block, the thermal and reliability models (and the log export)
+// of epoch N run in a background thread while the cores simulate epoch N+1. Power and the CPI stack are
+// always published at the end of their epoch; temperatures and R-values lag by up to one epoch (lag),
+// or consumers wait for them in waitForResults (block). At most one epoch is in flight.
+
+class PowerThermalManager : public Runnable
+{
+   public:
+      static PowerThermalManager* create();
+
+      PowerThermalManager();
+      ~PowerThermalManager();
+
+      // Called by consumers of the telemetry before reading it
+      void waitForResults();
+
+   private:
+      enum pipeline_t {
+         PIPELINE_OFF,     // synchronous, inside the periodic callback
+         PIPELINE_LAG,     // consumers see the last completed epoch
+         PIPELINE_BLOCK,   // consumers wait for the epoch in flight
+      };
+
+      // Raw per-core statistics the activity vector is derived from
+      enum raw_stat_t {
+         STAT_INSTRUCTIONS,
+         STAT_ELAPSED_TIME,
+         STAT_IDLE_ELAPSED_TIME,
+         STAT_UOP_FP_ADDSUB,
+         STAT_UOP_FP_MULDIV,
+         STAT_UOP_LOAD,
+         STAT_UOP_STORE,
+         STAT_UOP_GENERIC,
+         STAT_UOP_BRANCH,
+         STAT_L1I_LOADS,
+         STAT_L1D_LOADS,
+         STAT_L1D_STORES,
+         STAT_L2_LOADS,
+         STAT_L2_STORES,
+         NUM_RAW_STATS
+      };
+
+      struct Energy
+      {
+         UInt64 core_static, core_dynamic;
+         UInt64 l1i_static, l1i_dynamic;
+         UInt64 l1d_static, l1d_dynamic;
+         UInt64 l2_static, l2_dynamic;
+      };
+
+      const UInt32 m_num_cores;
+      const SubsecondTime m_interval;
+      const bool m_has_l3;
+      const bool m_thermal_enabled;
+      const bool m_reliability_enabled;
+      const bool m_export_logs;
+      pipeline_t m_pipeline;
+
+      NativePowerModel m_power_model;
+
+      std::vector<std::vector<StatsMetricBase*> > m_core_metrics;
+      std::vector<std::vector<UInt64> > m_core_last;
+      std::vector<StatsMetricBase*> m_l3_metrics;
+      UInt64 m_l3_last;
+
+      bool m_have_snapshot;
+      bool m_logs_initialized;
+      SubsecondTime m_last_update;
+      SubsecondTime m_next_update;
+
+      // Per-epoch results: [core * NUM_COMPONENTS + component]
+      std::vector<double> m_static_power, m_dynamic_power;
+      double m_l3_static_power, m_l3_dynamic_power;
+
+      std::vector<Energy> m_energy;
+      UInt64 m_processor_static_energy, m_processor_dynamic_energy;
+
+      // Power log order: [L3,] C_<core>_<component>...
+      std::vector<String> m_unit_names;
+      hotspot_thermal_t *m_thermal;
+      std::vector<double> m_unit_power, m_unit_temperature, m_unit_rvalue;
+      // NULL when the external reliability executable is used ([reliability] engine = external)
+      NativeReliabilityModel *m_reliability;
+
+      // CPI stack: per core, the cpi* time metrics and the label each of them accumulates into
+      std::vector<String> m_cpi_labels;
+      std::vector<std::vector<std::pair<StatsMetricBase*, UInt32> > > m_cpi_metrics;
+      std::vector<std::vector<UInt64> > m_cpi_last;
+      std::vector<double> m_cpi_stack;   // [label * num_cores + core]
+
+      // Pipeline state, protected by m_pipeline_lock
+      _Thread *m_pipeline_thread;
+      Lock m_pipeline_lock;
+      ConditionVariable m_pipeline_submitted, m_pipeline_done;
+      bool m_pipeline_running, m_pipeline_quit;
+      bool m_job_pending, m_job_append_logs;
+      std::vector<double> m_job_power;
+      SubsecondTime m_job_interval;
+
+      static SInt64 hook_periodic(UInt64 self, UInt64 time) { ((PowerThermalManager*)self)->periodic(*(subsecond_time_t*)&time); return 0; }
+      static void checkpoint_save(UInt64 self, CheckpointManager::Section &section) { ((PowerThermalManager*)self)->saveCheckpoint(section); }
+      static void checkpoint_save_reliability(UInt64 self, CheckpointManager::Section &section) { ((PowerThermalManager*)self)->saveReliabilityCheckpoint(section); }
+
+      void periodic(SubsecondTime time);
+      void snapshot();
+      void update(SubsecondTime time);
+      void updateEnergy(SubsecondTime interval);
+      void updateCpiStack(SubsecondTime interval);
+
+      void initCpiStack();
+      void addCpiMetric(UInt32 core, const char *objectName, const String &component);
+
+      // Thermal, reliability and log export of one epoch; runs in the pipeline thread if enabled
+      void processEpoch(const std::vector<double> &power, SubsecondTime interval, bool append_logs);
+      void submitEpoch(SubsecondTime interval);
+      void drainPipeline();
+      void run();
+
+      void writePowerLogs(const std::vector<double> &power, bool append);
+      // PeriodicFrequency.log and PeriodicCPIStack.log, written from the simulation thread
+      void writeActivityLogs(bool append);
+      void initThermal();
+      void runThermal(const std::vector<double> &power, SubsecondTime interval, bool append_logs);
+      void runReliability(SubsecondTime interval, bool append_logs);
+
+      // Thermal model state and the results of the last epoch, which are published again when restored
+      void saveCheckpoint(CheckpointManager::Section &section);
+      void restoreCheckpoint(const CheckpointManager::Section &section);
+      void saveReliabilityCheckpoint(CheckpointManager::Section &section);
+
+      String getHeader() const;
+      static StatsMetricBase* findMetric(const char *objectName, UInt32 index, const char *metricName);
+      static UInt64 readMetric(StatsMetricBase *metric);
+};
+
+#endif // __POWER_THERMAL_MANAGER_H
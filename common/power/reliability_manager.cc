@@ -0,0 +1,121 @@
+#include "reliability_manager.h"
+#include "power_thermal_manager.h"
+#include "telemetry.h"
+#include "simulator.h"
+#include "hooks_manager.h"
+#include "config.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+ReliabilityManager* ReliabilityManager::create()
+{
+   if (!Sim()->getCfg()->getBool("reliability/enabled") || Sim()->getCfg()->getString("reliability/engine") != "native")
+      return NULL;
+   // The native power engine runs the reliability model itself
+   if (Sim()->getPowerThermalManager())
+      return NULL;
+
+   return new ReliabilityManager();
+}
+
+ReliabilityManager::ReliabilityManager()
+   : m_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("periodic_power/interval")))
+   , m_temperature_file(Sim()->getConfig()->formatOutputFileName("InstantaneousTemperature.log"))
+   , m_model(NULL)
+   , m_restored(Sim()->getCheckpointManager()->getRestoredSection("reliability"))
+   , m_mtime(-1)
+   , m_have_update(false)
+   , m_last_update(SubsecondTime::Zero())
+{
+   // Python hooks (energystats.py) are registered as ORDER_NOTIFY_PRE: by the time we run, the epoch's temperatures are written
+   Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, hook_periodic, (UInt64)this, HooksManager::ORDER_NOTIFY_POST);
+   Sim()->getCheckpointManager()->registerComponent("reliability", checkpoint_save, (UInt64)this);
+}
+
+ReliabilityManager::~ReliabilityManager()
+{
+   if (m_model)
+   {
+      m_model->writeSums(m_unit_names);
+      delete m_model;
+   }
+}
+
+void ReliabilityManager::periodic(SubsecondTime time)
+{
+   std::vector<double> temperatures;
+   if (!readTemperatures(temperatures))
+      return;
+
+   // Temperatures cover the time since the previous epoch
+   SubsecondTime interval = m_have_update ? time - m_last_update : m_interval;
+   m_last_update = time;
+   m_model->update(&temperatures[0], interval);
+   m_model->getRValues(&m_unit_rvalue[0]);
+   m_model->writeLogs(m_unit_names, m_have_update);
+   m_have_update = true;
+
+   // Publish in the order of the snapshot's units (set by the first imported log)
+   Telemetry *telemetry = Sim()->getTelemetry();
+   if (telemetry->getUnitNames().empty())
+      telemetry->setUnits(m_unit_names);
+   std::vector<double> rvalues(telemetry->getUnitNames().size(), -1);
+   for (UInt32 i = 0; i < m_unit_names.size(); ++i)
+   {
+      SInt32 index = telemetry->getUnitIndex(m_unit_names[i]);
+      if (index >= 0)
+         rvalues[index] = m_unit_rvalue[i];
+   }
+   telemetry->publish(Telemetry::RVALUE, &rvalues[0]);
+}
+
+void ReliabilityManager::saveCheckpoint(CheckpointManager::Section &section)
+{
+   // Empty until the first temperatures were read
+   if (m_model)
+      m_model->saveCheckpoint(m_unit_names, section);
+}
+
+// Read InstantaneousTemperature.log if it was rewritten since the last call
+bool ReliabilityManager::readTemperatures(std::vector<double> &temperatures)
+{
+   struct stat st;
+   if (stat(m_temperature_file.c_str(), &st) != 0)
+      return false;
+   long long mtime = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+   if (mtime == m_mtime)
+      return false;
+
+   std::ifstream file(m_temperature_file.c_str());
+   std::string header, readings;
+   if (!std::getline(file, header) || !std::getline(file, readings))
+      return false;
+   m_mtime = mtime;
+
+   std::istringstream iss_header(header), iss_readings(readings);
+   std::string name, value;
+   std::vector<String> names;
+   while (std::getline(iss_header, name, '\t') && std::getline(iss_readings, value, '\t'))
+   {
+      names.push_back(String(name.c_str()));
+      temperatures.push_back(atof(value.c_str()));
+   }
+
+   // The floorplan does not change during a run
+   if (!m_model)
+   {
+      m_unit_names = names;
+      m_unit_rvalue.resize(names.size());
+      m_model = new NativeReliabilityModel(names.size());
+      if (m_restored && m_restored->has("units"))
+         m_model->restoreCheckpoint(names, *m_restored);
+   }
+   LOG_ASSERT_ERROR(names == m_unit_names, "Units of %s changed during the run", m_temperature_file.c_str());
+
+   return true;
+}
@@ -0,0 +1,49 @@
+#ifndef __RELIABILITY_MANAGER_H
+#define __RELIABILITY_MANAGER_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "native_reliability_model.h"
+#include "checkpoint_manager.h"
+
+#include <vector>
+
+// Runs the native reliability model in the McPAT flow ([periodic_power] engine = mcpat), where the
+// temperatures come from the HotSpot run in tools/mcpat.py. After every epoch of scripts/energystats.py,
+// the new InstantaneousTemperature.log is folded into the in-memory damage sums, and the R-values are
+// published to the Telemetry snapshot and written to Instantaneous/PeriodicRvalue.log.
+// (With the native power engine, PowerThermalManager drives the model directly.)
+
+class ReliabilityManager
+{
+   public:
+      static ReliabilityManager* create();
+
+      ReliabilityManager();
+      ~ReliabilityManager();
+
+   private:
+      const SubsecondTime m_interval;
+      const String m_temperature_file;
+
+      NativeReliabilityModel *m_model;
+      std::vector<String> m_unit_names;
+      std::vector<double> m_unit_rvalue;
+
+      // Damage sums to continue from, applied once the units are known
+      const CheckpointManager::Section *m_restored;
+
+      long long m_mtime;
+      bool m_have_update;
+      SubsecondTime m_last_update;
+
+      static SInt64 hook_periodic(UInt64 self, UInt64 time) { ((ReliabilityManager*)self)->periodic(*(subsecond_time_t*)&time); return 0; }
+
+      static void checkpoint_save(UInt64 self, CheckpointManager::Section &section) { ((ReliabilityManager*)self)->saveCheckpoint(section); }
+
+      void periodic(SubsecondTime time);
+      void saveCheckpoint(CheckpointManager::Section &section);
+      bool readTemperatures(std::vector<double> &temperatures);
+};
+
+#endif // __RELIABILITY_MANAGER_H
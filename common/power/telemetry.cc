@@ -0,0 +1,281 @@
+#include "telemetry.h"
+#include "simulator.h"
+#include "config.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+Telemetry::Telemetry()
+   : m_num_cores(Sim()->getConfig()->getApplicationCores())
+   , m_mirror_filename(Sim()->getCfg()->getString("telemetry/mirror_file"))
+   , m_mirror_fd(-1)
+   , m_mirror(NULL)
+   , m_mirror_size(0)
+{
+   for (UInt32 i = 0; i <= NUM_CHANNELS; ++i)
+      m_versions[i] = 0;
+   for (UInt32 c = 0; c < NUM_CHANNELS; ++c)
+   {
+      m_core_values[c].resize(m_num_cores, -1);
+      m_peak_values[c] = -1;
+   }
+   m_core_ranges.resize(m_num_cores, std::make_pair(0, 0));
+
+   if (m_mirror_filename != "")
+   {
+      if (m_mirror_filename[0] != '/')
+         m_mirror_filename = Sim()->getConfig()->formatOutputFileName(m_mirror_filename);
+      m_mirror_fd = open(m_mirror_filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      LOG_ASSERT_ERROR(m_mirror_fd >= 0, "Cannot create telemetry mirror %s", m_mirror_filename.c_str());
+      updateMirror();
+   }
+}
+
+Telemetry::~Telemetry()
+{
+   if (m_mirror)
+      munmap(m_mirror, m_mirror_size);
+   if (m_mirror_fd >= 0)
+      close(m_mirror_fd);
+}
+
+void Telemetry::setUnits(const std::vector<String> &names)
+{
+   ScopedLock sl(m_lock);
+
+   if (names == m_unit_names)
+      return;
+
+   m_unit_names = names;
+   m_unit_index.clear();
+   m_unit_core.resize(names.size());
+   std::fill(m_core_ranges.begin(), m_core_ranges.end(), std::make_pair(0, 0));
+   for (UInt32 i = 0; i < names.size(); ++i)
+   {
+      m_unit_index[names[i].c_str()] = i;
+
+      // Core components are named C_<core>_<component>
+      SInt32 core = -1;
+      if (names[i].compare(0, 2, "C_") == 0)
+      {
+         size_t end = names[i].find('_', 2);
+         if (end != String::npos)
+            core = atoi(names[i].substr(2, end - 2).c_str());
+         if (core >= (SInt32)m_num_cores)
+            core = -1;
+      }
+      m_unit_core[i] = core;
+
+      if (core >= 0)
+      {
+         std::pair<UInt32, UInt32> &range = m_core_ranges[core];
+         if (range.first == range.second)
+            range.first = i;
+         range.second = i + 1;
+      }
+   }
+
+   for (UInt32 c = 0; c < NUM_CHANNELS; ++c)
+   {
+      m_unit_values[c].assign(names.size(), -1);
+      std::fill(m_core_values[c].begin(), m_core_values[c].end(), -1);
+      m_peak_values[c] = -1;
+   }
+
+   updateMirror();
+}
+
+void Telemetry::publish(channel_t channel, const double *values)
+{
+   ScopedLock sl(m_lock);
+
+   std::vector<double> &unit_values = m_unit_values[channel];
+   std::vector<double> &core_values = m_core_values[channel];
+   double peak = -1;
+   bool have_peak = false;
+
+   std::copy(values, values + unit_values.size(), unit_values.begin());
+
+   for (UInt32 core = 0; core < m_num_cores; ++core)
+   {
+      double aggregate = -1;
+      bool seen = false;
+      for (UInt32 i = m_core_ranges[core].first; i < m_core_ranges[core].second; ++i)
+      {
+         // Ranges are contiguous for all floorplans we generate, but do not rely on it
+         if (m_unit_core[i] != (SInt32)core)
+            continue;
+
+         const double value = unit_values[i];
+         if (!seen)
+            aggregate = value;
+         else if (channel == POWER)
+            aggregate += value;
+         else if (channel == TEMPERATURE)
+            aggregate = std::max(aggregate, value);
+         else
+            aggregate = std::min(aggregate, value);
+         seen = true;
+
+         peak = have_peak ? std::max(peak, value) : value;
+         have_peak = true;
+      }
+      core_values[core] = aggregate;
+   }
+   m_peak_values[channel] = peak;
+
+   ++m_versions[channel];
+   updateMirror();
+}
+
+void Telemetry::setCpiStackLabels(const std::vector<String> &labels)
+{
+   ScopedLock sl(m_lock);
+
+   if (labels == m_cpi_labels)
+      return;
+
+   m_cpi_labels = labels;
+   m_cpi_index.clear();
+   for (UInt32 i = 0; i < labels.size(); ++i)
+      m_cpi_index[labels[i].c_str()] = i;
+   m_cpi_values.assign(labels.size() * m_num_cores, -1);
+
+   updateMirror();
+}
+
+void Telemetry::publishCpiStack(const double *values)
+{
+   ScopedLock sl(m_lock);
+
+   std::copy(values, values + m_cpi_values.size(), m_cpi_values.begin());
+
+   ++m_versions[NUM_CHANNELS];
+   updateMirror();
+}
+
+SInt32 Telemetry::getUnitIndex(const String &name) const
+{
+   ScopedLock sl(m_lock);
+
+   std::unordered_map<std::string, UInt32>::const_iterator it = m_unit_index.find(name.c_str());
+   return it == m_unit_index.end() ? -1 : it->second;
+}
+
+double Telemetry::getUnitValue(channel_t channel, const String &name) const
+{
+   ScopedLock sl(m_lock);
+
+   std::unordered_map<std::string, UInt32>::const_iterator it = m_unit_index.find(name.c_str());
+   if (it == m_unit_index.end())
+      return -1;
+   return m_unit_values[channel][it->second];
+}
+
+double Telemetry::getCoreValue(channel_t channel, UInt32 core) const
+{
+   ScopedLock sl(m_lock);
+
+   if (core >= m_num_cores)
+      return -1;
+   return m_core_values[channel][core];
+}
+
+std::vector<String> Telemetry::getCoreUnitNames(UInt32 core) const
+{
+   ScopedLock sl(m_lock);
+
+   std::vector<String> names;
+   if (core < m_num_cores)
+      for (UInt32 i = m_core_ranges[core].first; i < m_core_ranges[core].second; ++i)
+         if (m_unit_core[i] == (SInt32)core)
+            names.push_back(m_unit_names[i]);
+   return names;
+}
+
+std::vector<double> Telemetry::getCoreUnitValues(channel_t channel, UInt32 core) const
+{
+   ScopedLock sl(m_lock);
+
+   std::vector<double> values;
+   if (core < m_num_cores)
+      for (UInt32 i = m_core_ranges[core].first; i < m_core_ranges[core].second; ++i)
+         if (m_unit_core[i] == (SInt32)core)
+            values.push_back(m_unit_values[channel][i]);
+   return values;
+}
+
+double Telemetry::getPeakValue(channel_t channel) const
+{
+   ScopedLock sl(m_lock);
+
+   return m_peak_values[channel];
+}
+
+double Telemetry::getCpiStackPart(UInt32 core, const String &label) const
+{
+   ScopedLock sl(m_lock);
+
+   std::unordered_map<std::string, UInt32>::const_iterator it = m_cpi_index.find(label.c_str());
+   if (it == m_cpi_index.end() || core >= m_num_cores)
+      return -1;
+   return m_cpi_values[it->second * m_num_cores + core];
+}
+
+void Telemetry::updateMirror()
+{
+   if (m_mirror_fd < 0)
+      return;
+
+   const UInt32 num_units = m_unit_names.size(), num_labels = m_cpi_labels.size();
+   const size_t size = sizeof(TelemetryMirrorHeader)
+      + sizeof(double) * (NUM_CHANNELS * (m_num_cores + num_units) + num_labels * m_num_cores)
+      + NAME_LENGTH * (num_units + num_labels);
+
+   // (Re)map when the layout changed
+   if (size != m_mirror_size)
+   {
+      if (m_mirror)
+         munmap(m_mirror, m_mirror_size);
+      LOG_ASSERT_ERROR(ftruncate(m_mirror_fd, size) == 0, "Cannot resize telemetry mirror %s", m_mirror_filename.c_str());
+      m_mirror = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_mirror_fd, 0);
+      LOG_ASSERT_ERROR(m_mirror != MAP_FAILED, "Cannot map telemetry mirror %s", m_mirror_filename.c_str());
+      m_mirror_size = size;
+      memset(m_mirror, 0, size);
+   }
+
+   TelemetryMirrorHeader *header = (TelemetryMirrorHeader*)m_mirror;
+   volatile UInt64 *sequence = &header->sequence;
+   ++*sequence;
+   __sync_synchronize();
+
+   memcpy(header->magic, "HSTELEM", 8);
+   header->layout_version = 1;
+   header->num_cores = m_num_cores;
+   header->num_units = num_units;
+   header->num_cpi_labels = num_labels;
+   for (UInt32 i = 0; i <= NUM_CHANNELS; ++i)
+      header->versions[i] = m_versions[i];
+
+   double *values = (double*)(header + 1);
+   for (UInt32 c = 0; c < NUM_CHANNELS; ++c, values += m_num_cores)
+      std::copy(m_core_values[c].begin(), m_core_values[c].end(), values);
+   for (UInt32 c = 0; c < NUM_CHANNELS; ++c, values += num_units)
+      std::copy(m_unit_values[c].begin(), m_unit_values[c].end(), values);
+   std::copy(m_cpi_values.begin(), m_cpi_values.end(), values);
+   values += m_cpi_values.size();
+
+   char *names = (char*)values;
+   for (UInt32 i = 0; i < num_units; ++i, names += NAME_LENGTH)
+      strncpy(names, m_unit_names[i].c_str(), NAME_LENGTH - 1);
+   for (UInt32 i = 0; i < num_labels; ++i, names += NAME_LENGTH)
+      strncpy(names, m_cpi_labels[i].c_str(), NAME_LENGTH - 1);
+
+   __sync_synchronize();
+   ++*sequence;
+}
@@ -0,0 +1,101 @@
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include "fixed_types.h"
+#include "lock.h"
+
+#include <vector>
+#include <unordered_map>
+
+// In-memory snapshot of the per-epoch power, temperature, reliability and CPI-stack data.
+// Producers (PowerThermalManager, or PerformanceCounters importing the McPAT-flow log files)
+// publish complete vectors once per epoch; per-core aggregates are computed at publish time so
+// that consumers (the open scheduler and its policies) get O(1) lookups.
+//
+// Optionally, every snapshot is mirrored into an mmap'ed file ([telemetry] mirror_file) for
+// external tools. Layout (native endianness), see TelemetryMirrorHeader:
+//    header
+//    double core_values[NUM_CHANNELS][num_cores]
+//    double unit_values[NUM_CHANNELS][num_units]
+//    double cpi_stack[num_cpi_labels][num_cores]
+//    char   unit_names[num_units][NAME_LENGTH]
+//    char   cpi_labels[num_cpi_labels][NAME_LENGTH]
+// The sequence number is odd while the mirror is being updated.
+
+struct TelemetryMirrorHeader
+{
+   char magic[8];
+   UInt32 layout_version;
+   UInt32 num_cores;
+   UInt32 num_units;
+   UInt32 num_cpi_labels;
+   UInt64 sequence;
+   UInt64 versions[4];
+};
+
+class Telemetry
+{
+   public:
+      // Per-unit channels, in the column order of the power/thermal floorplan (L3, C_<core>_<component>...)
+      enum channel_t {
+         POWER,         // W, summed per core
+         TEMPERATURE,   // Celsius, maximum per core
+         RVALUE,        // reliability, minimum per core
+         NUM_CHANNELS
+      };
+
+      static const UInt32 NAME_LENGTH = 32;
+
+      Telemetry();
+      ~Telemetry();
+
+      // Producers
+      void setUnits(const std::vector<String> &names);
+      void publish(channel_t channel, const double *values);
+      void setCpiStackLabels(const std::vector<String> &labels);
+      // values[label * num_cores + core], cycles per instruction
+      void publishCpiStack(const double *values);
+
+      // Consumers, values are -1 when not (yet) available
+      UInt64 getVersion(channel_t channel) const { return m_versions[channel]; }
+      UInt64 getCpiStackVersion() const { return m_versions[NUM_CHANNELS]; }
+      const std::vector<String>& getUnitNames() const { return m_unit_names; }
+      // Column of a unit, -1 if unknown
+      SInt32 getUnitIndex(const String &name) const;
+      // Columns [first, last) holding the C_<core>_ units of a core
+      std::pair<UInt32, UInt32> getCoreUnitRange(UInt32 core) const { return m_core_ranges[core]; }
+      double getUnitValue(channel_t channel, const String &name) const;
+      double getCoreValue(channel_t channel, UInt32 core) const;
+      // Per-unit names and values of the C_<core>_ units of a core, in column order
+      std::vector<String> getCoreUnitNames(UInt32 core) const;
+      std::vector<double> getCoreUnitValues(channel_t channel, UInt32 core) const;
+      double getPeakValue(channel_t channel) const;
+      double getCpiStackPart(UInt32 core, const String &label) const;
+
+   private:
+      const UInt32 m_num_cores;
+
+      mutable Lock m_lock;
+      UInt64 m_versions[NUM_CHANNELS + 1];
+
+      std::vector<String> m_unit_names;
+      std::unordered_map<std::string, UInt32> m_unit_index;
+      std::vector<SInt32> m_unit_core;   // -1 for units outside of the cores (L3)
+      std::vector<std::pair<UInt32, UInt32> > m_core_ranges;
+      std::vector<double> m_unit_values[NUM_CHANNELS];
+      std::vector<double> m_core_values[NUM_CHANNELS];
+      double m_peak_values[NUM_CHANNELS];
+
+      std::vector<String> m_cpi_labels;
+      std::unordered_map<std::string, UInt32> m_cpi_index;
+      std::vector<double> m_cpi_values;
+
+      String m_mirror_filename;
+      int m_mirror_fd;
+      void *m_mirror;
+      size_t m_mirror_size;
+
+      void updateMirror();
+};
+
+#endif // __TELEMETRY_H
@@ -0,0 +1,195 @@
+#include "analytic_power_model.h"
+#include "simulator.h"
+#include "config.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+AnalyticPowerModel::AnalyticPowerModel(const PerformanceCounters *performanceCounters, int numberOfCores)
+	: performanceCounters(performanceCounters), numberOfCores(numberOfCores), components(numberOfCores), fittedReadings(0) {
+	leakageBeta = Sim()->getCfg()->getFloat("scheduler/open/dvfs/power_model/leakage_beta");
+	referenceTemperature = Sim()->getCfg()->getFloat("scheduler/open/dvfs/power_model/leakage_reference_temperature");
+	forgettingFactor = Sim()->getCfg()->getFloat("scheduler/open/dvfs/power_model/forgetting_factor");
+
+	// the static power of a core is calibrated at two frequencies, i.e. at the two voltages of the DVFS table
+	int staticFreqA = (int)(Sim()->getCfg()->getFloat("power/static_frequency_a") * 1000 + 0.5);
+	int staticFreqB = (int)(Sim()->getCfg()->getFloat("power/static_frequency_b") * 1000 + 0.5);
+	double staticPowerA = Sim()->getCfg()->getFloat("power/static_power_a");
+	double staticPowerB = Sim()->getCfg()->getFloat("power/static_power_b");
+	double vddA = getVdd(staticFreqA);
+	double vddB = getVdd(staticFreqB);
+	coreLeakage = (staticPowerA * vddA + staticPowerB * vddB) / (vddA * vddA + vddB * vddB);
+}
+
+/** initComponents
+ * Set up the components of a core once their names are known, with the leakage of the calibration.
+ */
+void AnalyticPowerModel::initComponents(int coreId) {
+	vector<string> names = performanceCounters->getComponentsOfCore(coreId);
+	double totalShare = 0;
+	for (unsigned int i = 0; i < names.size(); i++) {
+		// C_<core>_<component>
+		string name = names.at(i).substr(names.at(i).find('_', 2) + 1);
+		transform(name.begin(), name.end(), name.begin(), ::tolower);
+		String key = String("periodic_power/native/leakage/") + name.c_str();
+
+		Component component;
+		component.name = names.at(i);
+		component.leakageShare = Sim()->getCfg()->hasKey(key) ? Sim()->getCfg()->getFloat(key) : 0;
+		component.fitted = false;
+		components.at(coreId).push_back(component);
+		totalShare += component.leakageShare;
+	}
+
+	for (unsigned int i = 0; i < components.at(coreId).size(); i++) {
+		Component &component = components.at(coreId).at(i);
+		double share = totalShare > 0 ? component.leakageShare / totalShare : 1.0 / names.size();
+		component.theta[0] = 0;
+		component.theta[1] = share * coreLeakage;
+	}
+}
+
+double AnalyticPowerModel::leakageFactor(double vdd, double temperature) const {
+	// -1: no temperature available
+	if (temperature == -1) {
+		temperature = referenceTemperature;
+	}
+	return vdd * exp(leakageBeta * (temperature - referenceTemperature));
+}
+
+/** fit
+ * One recursive least squares step for power = d * x1 + s * x2.
+ */
+void AnalyticPowerModel::fit(Component &component, double x1, double x2, double power) {
+	double *theta = component.theta;
+	double (*p)[2] = component.covariance;
+
+	if (!component.fitted) {
+		// dynamic power is what the calibrated leakage does not explain
+		theta[0] = x1 > 0 ? max(0.0, power - theta[1] * x2) / x1 : 0;
+		p[0][0] = (theta[0] + 1e-3) * (theta[0] + 1e-3);
+		p[1][1] = (theta[1] + 1e-3) * (theta[1] + 1e-3);
+		p[0][1] = p[1][0] = 0;
+		component.initialCovarianceTrace = p[0][0] + p[1][1];
+		component.fitted = true;
+		return;
+	}
+
+	double px[2] = { p[0][0] * x1 + p[0][1] * x2, p[1][0] * x1 + p[1][1] * x2 };
+	double denominator = forgettingFactor + x1 * px[0] + x2 * px[1];
+	double gain[2] = { px[0] / denominator, px[1] / denominator };
+	double error = power - (theta[0] * x1 + theta[1] * x2);
+
+	theta[0] = max(0.0, theta[0] + gain[0] * error);
+	theta[1] = max(0.0, theta[1] + gain[1] * error);
+	for (int i = 0; i < 2; i++) {
+		for (int j = 0; j < 2; j++) {
+			p[i][j] = (p[i][j] - gain[i] * px[j]) / forgettingFactor;
+		}
+	}
+
+	// while the frequency does not change, forgetting inflates the covariance in the direction without new information
+	double trace = p[0][0] + p[1][1];
+	if (trace > component.initialCovarianceTrace) {
+		double scale = component.initialCovarianceTrace / trace;
+		for (int i = 0; i < 2; i++) {
+			for (int j = 0; j < 2; j++) {
+				p[i][j] *= scale;
+			}
+		}
+	}
+}
+
+/** update
+ * Fit the components of all cores to the last power readings.
+ */
+void AnalyticPowerModel::update(const std::vector<int> &frequencies) {
+	unsigned long long readings = performanceCounters->getPowerReadings();
+	if (readings == fittedReadings) {
+		return;
+	}
+	fittedReadings = readings;
+
+	for (int coreId = 0; coreId < numberOfCores; coreId++) {
+		if (components.at(coreId).empty()) {
+			initComponents(coreId);
+		}
+		vector<double> powers = performanceCounters->getPowerOfComponentsOfCore(coreId);
+		vector<double> temperatures = performanceCounters->getTemperatureOfComponentsOfCore(coreId);
+		if (powers.size() != components.at(coreId).size()) {
+			continue;
+		}
+
+		double vdd = getVdd(frequencies.at(coreId));
+		double x1 = vdd * vdd * frequencies.at(coreId) / 1000.0;
+		for (unsigned int i = 0; i < powers.size(); i++) {
+			if (powers.at(i) < 0) {
+				continue;
+			}
+			double temperature = i < temperatures.size() ? temperatures.at(i) : -1;
+			fit(components.at(coreId).at(i), x1, leakageFactor(vdd, temperature), powers.at(i));
+		}
+	}
+}
+
+double AnalyticPowerModel::estimateComponentPower(int coreId, int component, int frequency, double vdd, double temperature) const {
+	const Component &c = components.at(coreId).at(component);
+	return c.theta[0] * vdd * vdd * frequency / 1000.0 + c.theta[1] * leakageFactor(vdd, temperature);
+}
+
+double AnalyticPowerModel::estimateCorePower(int coreId, int frequency, double vdd, double temperature) const {
+	double power = 0;
+	for (unsigned int i = 0; i < components.at(coreId).size(); i++) {
+		power += estimateComponentPower(coreId, i, frequency, vdd, temperature);
+	}
+	return power;
+}
+
+double AnalyticPowerModel::estimateCorePower(int coreId, int frequency) const {
+	vector<double> temperatures = performanceCounters->getTemperatureOfComponentsOfCore(coreId);
+	double vdd = getVdd(frequency);
+	double power = 0;
+	for (unsigned int i = 0; i < components.at(coreId).size(); i++) {
+		double temperature = i < temperatures.size() ? temperatures.at(i) : -1;
+		power += estimateComponentPower(coreId, i, frequency, vdd, temperature);
+	}
+	return power;
+}
+
+bool AnalyticPowerModel::isFitted(int coreId) const {
+	const vector<Component> &coreComponents = components.at(coreId);
+	for (unsigned int i = 0; i < coreComponents.size(); i++) {
+		if (coreComponents.at(i).fitted) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** getExpectedGoodFrequency
+ * Calculate the frequency that is expected to cause a power consumption as close as possible to the power budget, but still respecting it.
+ */
+int AnalyticPowerModel::getExpectedGoodFrequency(int coreId, float powerBudget, int minFrequency, int maxFrequency, int frequencyStepSize) const {
+	vector<double> temperatures = performanceCounters->getTemperatureOfComponentsOfCore(coreId);
+	const vector<Component> &coreComponents = components.at(coreId);
+
+	// the temperatures do not change during the search: sum the dynamic coefficients, and the leakage per unit of voltage
+	double dynamic = 0;
+	double leakage = 0;
+	for (unsigned int i = 0; i < coreComponents.size(); i++) {
+		double temperature = i < temperatures.size() ? temperatures.at(i) : -1;
+		dynamic += coreComponents.at(i).theta[0];
+		leakage += coreComponents.at(i).theta[1] * leakageFactor(1, temperature);
+	}
+
+	int expectedGoodFrequency = minFrequency;
+	for (int f = minFrequency; f <= maxFrequency; f += frequencyStepSize) {
+		double vdd = getVdd(f);
+		if (dynamic * vdd * vdd * f / 1000.0 + leakage * vdd <= powerBudget) {
+			expectedGoodFrequency = f;
+		}
+	}
+	return expectedGoodFrequency;
+}
@@ -0,0 +1,79 @@
+/**
+ * analytic_power_model
+ * This header implements the power model that DVFS policies query for arbitrary frequency, voltage and temperature points.
+ */
+
+#ifndef __ANALYTIC_POWER_MODEL_H
+#define __ANALYTIC_POWER_MODEL_H
+
+#include "performance_counters.h"
+#include "native_power_model.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Power of every component of a core as dynamic plus leakage power:
+ *   P(f, V, T) = d * V^2 * f + s * V * exp(beta * (T - Tref))
+ * with f in GHz, V in Volt and T in °C. The leakage term follows calc_leakage in hotspot/temperature.c.
+ * The supply voltage of a frequency comes from the DVFS table of the power model (build_dvfs_table in scripts/energystats.py).
+ *
+ * The coefficients d and s are fitted online (recursive least squares with forgetting) to the power readings seen so far,
+ * from McPAT or the native power engine. s starts from the static power calibration in [power], split over the components
+ * like periodic_power/native/leakage, and d from the first reading. Estimating a point costs a few flops per component,
+ * so a policy can search the whole frequency range every epoch.
+ */
+class AnalyticPowerModel {
+public:
+    AnalyticPowerModel(const PerformanceCounters *performanceCounters, int numberOfCores);
+
+    // Fit the model to the readings of the last epoch, during which the cores ran at the given frequencies (MHz).
+    // Readings that were already fitted are skipped, so every policy can call this at the start of its epoch.
+    void update(const std::vector<int> &frequencies);
+
+    // Supply voltage (V) at a frequency (MHz)
+    double getVdd(int frequency) const { return dvfsTable.getVdd(frequency < 0 ? 0 : frequency); }
+
+    // Estimated power (W) of a core at a frequency (MHz), supply voltage (V) and temperature (°C) of all its components
+    double estimateCorePower(int coreId, int frequency, double vdd, double temperature) const;
+    // Same at the voltage of the DVFS table and the current temperatures of the components
+    double estimateCorePower(int coreId, int frequency) const;
+    // Estimated power (W) of one component of a core (in the order of PerformanceCounters::getComponentsOfCore)
+    double estimateComponentPower(int coreId, int component, int frequency, double vdd, double temperature) const;
+
+    // Whether a power reading of the core has been fitted; before that, the model only knows the calibrated leakage
+    bool isFitted(int coreId) const;
+
+    // Highest frequency (MHz) in [minFrequency, maxFrequency] whose estimated power stays within the budget, minFrequency if none
+    int getExpectedGoodFrequency(int coreId, float powerBudget, int minFrequency, int maxFrequency, int frequencyStepSize) const;
+
+private:
+    struct Component {
+        std::string name;
+        double leakageShare;
+        bool fitted;
+        // coefficients (d, s) and their covariance
+        double theta[2];
+        double covariance[2][2];
+        double initialCovarianceTrace;
+    };
+
+    const PerformanceCounters *performanceCounters;
+    int numberOfCores;
+    NativePowerModel dvfsTable;
+
+    double leakageBeta;
+    double referenceTemperature;
+    double forgettingFactor;
+    // leakage coefficient (W/V) of a core at the reference temperature, from power/static_*
+    double coreLeakage;
+
+    std::vector<std::vector<Component> > components;
+    unsigned long long fittedReadings;
+
+    void initComponents(int coreId);
+    double leakageFactor(double vdd, double temperature) const;
+    void fit(Component &component, double x1, double x2, double power);
+};
+
+#endif
@@ -1,10 +1,15 @@
 #include "performance_counters.h"
+#include "simulator.h"
+#include "power_thermal_manager.h"
 
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <numeric>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -13,79 +18,168 @@ PerformanceCounters::PerformanceCounters(const char* output_dir,
         std::string instTemperatureFileNameParam,
         std::string instCPIStackFileNameParam,
         std::string instRvalueFileNameParam) :
-            instPowerFileName(instPowerFileNameParam),
-            instTemperatureFileName(instTemperatureFileNameParam),
-            instCPIStackFileName(instCPIStackFileNameParam) {
-
-    //gkothar1: fix log file path names
-    std::string temp = instPowerFileName;
-    instPowerFileName = std::string(output_dir);
-    instPowerFileName.append("/");
-    instPowerFileName.append(temp);
-
-    temp = instTemperatureFileName;
-    instTemperatureFileName = std::string(output_dir);
-    instTemperatureFileName.append("/");
-    instTemperatureFileName.append(temp);
-
-    temp = instCPIStackFileName;
-    instCPIStackFileName = std::string(output_dir);
-    instCPIStackFileName.append("/");
-    instCPIStackFileName.append(temp);
-
-    instRvalueFileName = std::string(output_dir) + "/" +
-        instRvalueFileNameParam;
+            telemetry(Sim()->getTelemetry()),
+            // the native power engine publishes straight into the telemetry snapshot
+            importLogs(Sim()->getPowerThermalManager() == NULL),
+            //gkothar1: fix log file path names
+            instPowerFile(std::string(output_dir) + "/" + instPowerFileNameParam),
+            instTemperatureFile(std::string(output_dir) + "/" + instTemperatureFileNameParam),
+            instCPIStackFile(std::string(output_dir) + "/" + instCPIStackFileNameParam),
+            instRvalueFile(std::string(output_dir) + "/" + instRvalueFileNameParam) {
 }
 
-/** Return a vector of all the values that match the prefix pattern. */
-vector<double> getValues(string filename, string prefix) {
-    ifstream LogFile(filename);
+/** Return true (once) if the file was rewritten since the last call. */
+bool PerformanceCounters::LogFile::changed() {
+    struct stat st;
+    if (stat(fileName.c_str(), &st) != 0) {
+        return false;
+    }
+
+    long long newMtime = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    if ((long long)st.st_dev == device && (long long)st.st_ino == inode && st.st_size == size && newMtime == mtime) {
+        return false;
+    }
+
+    device = st.st_dev;
+    inode = st.st_ino;
+    size = st.st_size;
+    mtime = newMtime;
+    return true;
+}
+
+/** Bring the telemetry snapshot up to date with the instantaneous log files (McPAT engine only). */
+void PerformanceCounters::sync() const {
+    if (!importLogs) {
+        // the native engine may still be computing the temperatures of the last epoch
+        Sim()->getPowerThermalManager()->waitForResults();
+        return;
+    }
+
+    if (instPowerFile.changed()) {
+        importUnitLog(instPowerFile, Telemetry::POWER);
+    }
+    if (instTemperatureFile.changed()) {
+        importUnitLog(instTemperatureFile, Telemetry::TEMPERATURE);
+    }
+    if (instRvalueFile.changed()) {
+        importUnitLog(instRvalueFile, Telemetry::RVALUE);
+    }
+    if (instCPIStackFile.changed()) {
+        importCPIStackLog(instCPIStackFile);
+    }
+}
+
+/** Publish the values of a header + readings log file (power, temperature or rvalue). */
+void PerformanceCounters::importUnitLog(LogFile &logFile, Telemetry::channel_t channel) const {
+    ifstream LogFile(logFile.fileName);
     string header;
     string footer;
-    vector<double> v;
 
     if (LogFile.good()) {
         getline(LogFile, header);
         getline(LogFile, footer);
     }
 
-    std::istringstream issHeader(header);
-    std::istringstream issFooter(footer);
-    std::string token;
+    if (header.empty() || footer.empty()) {
+        // file is being rewritten, retry on the next query
+        logFile.mtime = -1;
+        return;
+    }
+
+    // the header only changes when the floorplan does: map its columns onto the snapshot once
+    if (header != logFile.header) {
+        std::istringstream issHeader(header);
+        std::string token;
+        std::vector<String> names;
+        while (getline(issHeader, token, '\t')) {
+            names.push_back(String(token.c_str()));
+        }
+
+        // all logs share the floorplan order; the first one seen defines the units
+        if (telemetry->getUnitNames().empty()) {
+            telemetry->setUnits(names);
+        }
+
+        logFile.columns.resize(names.size());
+        for (unsigned int i = 0; i < names.size(); i++) {
+            logFile.columns[i] = telemetry->getUnitIndex(names[i]);
+        }
+        logFile.header = header;
+    }
 
-    while(getline(issHeader, token, '\t')) {
-        std::string value;
-        getline(issFooter, value, '\t');
-        if (token.find(prefix) == 0) {
-            v.push_back(stod(value));
+    std::vector<double> values(telemetry->getUnitNames().size(), -1);
+    const char *field = footer.c_str();
+    for (unsigned int column = 0; column < logFile.columns.size(); column++) {
+        char *end;
+        double value = strtod(field, &end);
+        if (end != field && logFile.columns[column] >= 0) {
+            values[logFile.columns[column]] = value;
+        }
+        field = strchr(end, '\t');
+        if (field == NULL) {
+            break;
         }
+        field++;
     }
 
-    return v;
+    telemetry->publish(channel, &values[0]);
 }
 
-/** Return the value of a component in the instantanious `logfile`.
- * Return -1 if the component is not found and throw an exception if
- * the component is found multiple times.
- */
-double getValue(string logfile, string component) {
-    vector<double> values = getValues(logfile, component);
+/** Publish the CPI stack of InstantaneousCPIStack.log (one metric per line, one column per core). */
+void PerformanceCounters::importCPIStackLog(LogFile &logFile) const {
+    ifstream cpiStackLogFile(logFile.fileName);
+    const unsigned int numberOfCores = Sim()->getConfig()->getApplicationCores();
+    string line;
+    std::string labelColumn;
+    std::vector<String> labels;
+    std::vector<double> values;
 
-    if (values.size() < 1) {
-        return -1;
-    } else if (values.size() > 1) {
-        throw std::runtime_error{"ERROR: Duplicate components found in " + \
-            logfile};
+    // skip the header (Metric, Core0, Core1, ...)
+    getline(cpiStackLogFile, line);
+
+    while (getline(cpiStackLogFile, line)) {
+        size_t tab = line.find('\t');
+        if (tab == 0 || line.empty()) {
+            continue;
+        }
+        labelColumn.append(line, 0, tab).push_back('\n');
+        labels.push_back(String(line.substr(0, tab).c_str()));
+
+        values.resize(values.size() + numberOfCores, 0);
+        double *row = &values[values.size() - numberOfCores];
+        // a line with a single '-' means all cores are (close to) zero
+        const char *field = tab == std::string::npos ? NULL : line.c_str() + tab + 1;
+        if (field != NULL && strcmp(field, "-") == 0) {
+            field = NULL;
+        }
+        for (unsigned int c = 0; c < numberOfCores && field != NULL; c++) {
+            row[c] = strtod(field, NULL);
+            field = strchr(field, '\t');
+            if (field != NULL) {
+                field++;
+            }
+        }
     }
 
-    return values[0];
+    if (labels.empty()) {
+        logFile.mtime = -1;
+        return;
+    }
+
+    // the metrics (rows) are fixed for a run, only re-index them when they change
+    if (labelColumn != logFile.header) {
+        telemetry->setCpiStackLabels(labels);
+        logFile.header = labelColumn;
+    }
+    telemetry->publishCpiStack(&values[0]);
 }
 
 /** getPowerOfComponent
     Returns the latest power consumption of a component being tracked using base.cfg. Return -1 if power value not found.
 */
 double PerformanceCounters::getPowerOfComponent (string component) const {
-    return getValue(instPowerFileName, component);
+    sync();
+    return telemetry->getUnitValue(Telemetry::POWER, String(component.c_str()));
 }
 
 /** getPowerOfCore
@@ -95,14 +189,48 @@ double PerformanceCounters::getPowerOfComponent (string component) const {
  * usage of all the subcomponents of the core.
  */
 double PerformanceCounters::getPowerOfCore(int coreId) const {
-    string prefix = "C_" + std::to_string(coreId) + "_";
-    vector<double> power_values = getValues(instPowerFileName, prefix);
+    sync();
+    return telemetry->getCoreValue(Telemetry::POWER, coreId);
+}
 
-    if (power_values.size() == 0) {
-        return -1;
+/** getComponentsOfCore
+ * Return the names of the components of the Core 'coreId', in the order
+ * of the values returned by getPowerOfComponentsOfCore.
+ */
+vector<string> PerformanceCounters::getComponentsOfCore(int coreId) const {
+    sync();
+    vector<string> components;
+    vector<String> names = telemetry->getCoreUnitNames(coreId);
+    for (unsigned int i = 0; i < names.size(); i++) {
+        components.push_back(names.at(i).c_str());
     }
+    return components;
+}
 
-    return std::accumulate(power_values.begin(), power_values.end(), 0.0);
+/** getPowerOfComponentsOfCore
+ * Return the current power usage of each component of the Core 'coreId'
+ * (-1 if no value was found).
+ */
+vector<double> PerformanceCounters::getPowerOfComponentsOfCore(int coreId) const {
+    sync();
+    return telemetry->getCoreUnitValues(Telemetry::POWER, coreId);
+}
+
+/** getTemperatureOfComponentsOfCore
+ * Return the latest temperature of each component of the Core 'coreId'
+ * (-1 if no value was found).
+ */
+vector<double> PerformanceCounters::getTemperatureOfComponentsOfCore(int coreId) const {
+    sync();
+    return telemetry->getCoreUnitValues(Telemetry::TEMPERATURE, coreId);
+}
+
+/** getPowerReadings
+ * Return the number of power readings so far.
+ */
+unsigned long long PerformanceCounters::getPowerReadings() const {
+    sync();
+    return telemetry->getVersion(Telemetry::POWER);
 }
 
 /** getPeakTemperature
@@ -110,14 +238,8 @@ double PerformanceCounters::getPowerOfCore(int coreId) const {
  * temperature value is found.
 */
 double PerformanceCounters::getPeakTemperature () const {
-    // The pattern 'C_' will match all components in the logfile.
-    vector<double> temperatures = getValues(instTemperatureFileName, "C_");
-
-    if (temperatures.size() == 0) {
-        return -1;
-    }
-
-    return *std::max_element(temperatures.begin(), temperatures.end());
+    sync();
+    return telemetry->getPeakValue(Telemetry::TEMPERATURE);
 }
 
 
@@ -125,7 +247,8 @@ double PerformanceCounters::getPeakTemperature () const {
     Returns the latest temperature of a component being tracked using base.cfg. Return -1 if power value not found.
 */
 double PerformanceCounters::getTemperatureOfComponent (string component) const {
-    return getValue(instTemperatureFileName, component);
+    sync();
+    return telemetry->getUnitValue(Telemetry::TEMPERATURE, String(component.c_str()));
 }
 
 /** getTemperatureOfCore
@@ -135,57 +258,29 @@ double PerformanceCounters::getTemperatureOfComponent (string component) const {
  * taking the maximum of all the subcomponents of the core.
  */
 double PerformanceCounters::getTemperatureOfCore(int coreId) const {
-    string prefix = "C_" + std::to_string(coreId) + "_";
-    vector<double> temperatures = getValues(instTemperatureFileName, prefix);
-
-    if (temperatures.size() == 0) {
-        return -1;
-    }
-
-    return *std::max_element(temperatures.begin(), temperatures.end());
+    sync();
+    return telemetry->getCoreValue(Telemetry::TEMPERATURE, coreId);
 }
 
 /**
  * Get a performance metric for the given core.
- * Available performance metrics can be checked in InstantaneousPerformanceCounters.log
+ * Available performance metrics can be checked in InstantaneousCPIStack.log
  */
 double PerformanceCounters::getCPIStackPartOfCore(int coreId, std::string metric) const {
-    ifstream cpiStackLogFile(instCPIStackFileName);
-    string line;
-    std::istringstream issLine;
-
-    // first find the line in the logfile that contains the desired metric
-    bool metricFound = false;
-    while (!metricFound) {
-        if (cpiStackLogFile.good()) {
-            getline(cpiStackLogFile, line);
-            issLine.str(line);
-            issLine.clear();
-            std::string m;
-            getline(issLine, m, '\t');
-            metricFound = (m == metric);
-        } else {
-            return -1;
-        }
-    }
-    
-    // then split the coreId-th value from this line (first value is metric name, but already consumed above)
-    std::string value;
-    for (int i = 0; i < coreId + 1; i++) {
-        getline(issLine, value, '\t');
-        if ((i == 0) && (value == "-")) {
-            return 0;
-        }
-    }
-
-    return stod(value);
+    sync();
+    return telemetry->getCpiStackPart(coreId, String(metric.c_str()));
 }
 
 /**
  * Get the utilization of the given core.
  */
 double PerformanceCounters::getUtilizationOfCore(int coreId) const {
-    return getCPIStackPartOfCore(coreId, "base") / getCPIOfCore(coreId);
+    double cpi = getCPIOfCore(coreId);
+    // no instructions executed during the last epoch
+    if (cpi <= 0) {
+        return 0;
+    }
+    return getCPIStackPartOfCore(coreId, "base") / cpi;
 }
 
 /**
@@ -199,7 +294,11 @@ double PerformanceCounters::getCPIOfCore(int coreId) const {
  * Get the rel. NUCA part of the CPI stack of the given core.
  */
 double PerformanceCounters::getRelNUCACPIOfCore(int coreId) const {
-    return getCPIStackPartOfCore(coreId, "mem-nuca") / getCPIOfCore(coreId);
+    double cpi = getCPIOfCore(coreId);
+    if (cpi <= 0) {
+        return 0;
+    }
+    return getCPIStackPartOfCore(coreId, "mem-nuca") / cpi;
 }
 
 /**
@@ -232,7 +331,8 @@ double PerformanceCounters::getIPSOfCore(int coreId) const {
     Return -1 if rvalue value not found.
 */
 double PerformanceCounters::getRvalueOfComponent (std::string component) const {
-    return getValue(instRvalueFileName, component);
+    sync();
+    return telemetry->getUnitValue(Telemetry::RVALUE, String(component.c_str()));
 }
 
 /** getRvalueOfCore
@@ -242,16 +342,14 @@ double PerformanceCounters::getRvalueOfComponent (std::string component) const {
  * values of its subcomponents.
  */
 double PerformanceCounters::getRvalueOfCore (int coreId) const {
-    string prefix = "C_" + std::to_string(coreId) + "_";
-    vector<double> r_values = getValues(instRvalueFileName, prefix);
-
-    if (r_values.size() == 0) {
-        return -1;
-    }
-
-    return *std::min_element(r_values.begin(), r_values.end());
+    sync();
+    return telemetry->getCoreValue(Telemetry::RVALUE, coreId);
 }
 
+/**
+ * Get the timestamp of the last heartbeat of the given application.
+ * The log is read incrementally: only records appended since the previous call are parsed.
+ */
 int PerformanceCounters::getLastBeat(int appId) const {
 	std::string target = std::to_string(appId) + ".hb.log";
 	std::ifstream appIdHbLogfile(target);
@@ -260,32 +358,55 @@ int PerformanceCounters::getLastBeat(int appId) const {
 		return -1;
 	}
 
-	std::string header;
-	std::getline(appIdHbLogfile, header);
+	HeartbeatLog &log = heartbeatLogs[appId];
 
-	std::string line;
-	std::string footer;
-	while (std::getline(appIdHbLogfile, line)) {
-		footer = line;
+	// start over if the log was recreated or truncated (e.g., the application was restarted)
+	struct stat st;
+	if (stat(target.c_str(), &st) == 0 && ((long long)st.st_ino != log.inode || st.st_size < log.offset)) {
+		log = HeartbeatLog();
+		log.inode = st.st_ino;
 	}
 
-	if (footer == "") {
-		return 0; // No heartbeat data logged yet.
-	}
+	if (log.timestampColumn < 0) {
+		std::string header;
+		if (!std::getline(appIdHbLogfile, header) || appIdHbLogfile.eof()) {
+			return 0; // header not (completely) written yet
+		}
 
-	std::istringstream issHeader(header);
-	std::istringstream issFooter(footer);
-	std::string token;
-	while (std::getline(issHeader, token, '\t')) {
-		std::string value;
-		std::getline(issFooter, value, '\t');
+		std::istringstream issHeader(header);
+		std::string token;
+		for (int column = 0; std::getline(issHeader, token, '\t'); column++) {
+			if (token == "Timestamp") {
+				log.timestampColumn = column;
+				break;
+			}
+		}
+		if (log.timestampColumn < 0) {
+			std::cerr << "[PerformanceCounters] Could not find timestamp column in hb file " << target << endl;
+			return -1;
+		}
+		log.offset = appIdHbLogfile.tellg();
+	}
 
-		if (token == "Timestamp") {
-			return std::stoi(value);
+	appIdHbLogfile.seekg(log.offset);
+	std::string line;
+	std::string footer;
+	// only consume complete lines, a partially written record is picked up on the next call
+	while (std::getline(appIdHbLogfile, line) && !appIdHbLogfile.eof()) {
+		log.offset += line.size() + 1;
+		if (!line.empty()) {
+			footer = line;
 		}
 	}
 
-	std::cerr << "[PerformanceCounters] Could not find timestamp column in hb file " << target << endl;
+	if (footer != "") {
+		std::istringstream issFooter(footer);
+		std::string value;
+		for (int column = 0; column <= log.timestampColumn; column++) {
+			std::getline(issFooter, value, '\t');
+		}
+		log.lastBeat = std::stoi(value);
+	}
 
-  return -1;
+	return log.lastBeat; // 0 if no heartbeat data logged yet
 }
@@ -6,14 +6,29 @@
 #ifndef __PERFORMANCECOUNTERS_H
 #define __PERFORMANCECOUNTERS_H
 
+#include "telemetry.h"
+
+#include <map>
 #include <string>
 #include <vector>
 
+/**
+ * Values are read from the in-memory telemetry snapshot (see common/power/telemetry.h).
+ * With the native power engine, the snapshot is published directly by the simulator.
+ * With the McPAT engine, the Instantaneous*.log files written by the energystats script
+ * are imported into the snapshot once after every change, instead of on every query.
+ */
 class PerformanceCounters {
 public:
     PerformanceCounters(const char* output_dir, std::string instPowerFileNameParam, std::string instTemperatureFileNameParam, std::string instCPIStackFileNameParam, std::string instRvalueFileNameParam);
     double getPowerOfComponent (std::string component) const;
     double getPowerOfCore(int coreId) const;
+    /** Names (C_<core>_<component>), power and temperature of the components of a core, in floorplan order. */
+    std::vector<std::string> getComponentsOfCore(int coreId) const;
+    std::vector<double> getPowerOfComponentsOfCore(int coreId) const;
+    std::vector<double> getTemperatureOfComponentsOfCore(int coreId) const;
+    /** Number of power readings so far, to tell whether a new one arrived. */
+    unsigned long long getPowerReadings() const;
     double getPeakTemperature () const;
     double getTemperatureOfComponent (std::string component) const;
     double getTemperatureOfCore (int coreId) const;
@@ -31,13 +46,40 @@ public:
     int getLastBeat(int appId) const;
 
 private:
+    /** An instantaneous log file and the state it was last imported in. */
+    struct LogFile {
+        std::string fileName;
+        long long device, inode, size, mtime;
+        /** Header (or CPI stack label column) seen last, and the snapshot index of each of its columns (-1 if unknown),
+            so that the header is only tokenized and looked up again when it changes. */
+        std::string header;
+        std::vector<int> columns;
+        LogFile(std::string fileName) : fileName(fileName), device(-1), inode(-1), size(-1), mtime(-1) {}
+        bool changed();
+    };
+
+    /** Read position in an application's heartbeat log, so that only appended records are parsed. */
+    struct HeartbeatLog {
+        long long inode;
+        long long offset;
+        int timestampColumn;
+        int lastBeat;
+        HeartbeatLog() : inode(-1), offset(0), timestampColumn(-1), lastBeat(0) {}
+    };
+
     std::vector<int> frequencies;
+    mutable std::map<int, HeartbeatLog> heartbeatLogs;
+
+    Telemetry *telemetry;
+    bool importLogs;
+    mutable LogFile instPowerFile;
+    mutable LogFile instTemperatureFile;
+    mutable LogFile instCPIStackFile;
+    mutable LogFile instRvalueFile;
 
-    std::string outputDir;
-    std::string instPowerFileName;
-    std::string instTemperatureFileName;
-    std::string instCPIStackFileName;
-    std::string instRvalueFileName;
+    void sync() const;
+    void importUnitLog(LogFile &logFile, Telemetry::channel_t channel) const;
+    void importCPIStackLog(LogFile &logFile) const;
 };
 
 #endif
@@ -5,13 +5,16 @@
 
 using namespace std;
 
-DVFSFixedPower::DVFSFixedPower(const PerformanceCounters *performanceCounters, int coreRows, int coreColumns, int minFrequency, int maxFrequency, int frequencyStepSize, float perCorePowerBudget)
-	: performanceCounters(performanceCounters), coreRows(coreRows), coreColumns(coreColumns), minFrequency(minFrequency), maxFrequency(maxFrequency), frequencyStepSize(frequencyStepSize), perCorePowerBudget(perCorePowerBudget) {
+DVFSFixedPower::DVFSFixedPower(const PerformanceCounters *performanceCounters, AnalyticPowerModel *powerModel, int coreRows, int coreColumns, int minFrequency, int maxFrequency, int frequencyStepSize, float perCorePowerBudget)
+	: performanceCounters(performanceCounters), powerModel(powerModel), coreRows(coreRows), coreColumns(coreColumns), minFrequency(minFrequency), maxFrequency(maxFrequency), frequencyStepSize(frequencyStepSize), perCorePowerBudget(perCorePowerBudget) {
 	
 }
 
 std::vector<int> DVFSFixedPower::getFrequencies(const std::vector<int> &oldFrequencies, const std::vector<bool> &activeCores) {
 	std::vector<int> frequencies(coreRows * coreColumns);
+	if (powerModel != NULL) {
+		powerModel->update(oldFrequencies);
+	}
 
 	for (unsigned int coreCounter = 0; coreCounter < coreRows * coreColumns; coreCounter++) {
 		if (activeCores.at(coreCounter)) {
@@ -27,7 +30,10 @@ std::vector<int> DVFSFixedPower::getFrequencies(const std::vector<int> &oldFrequ
 			cout << " T=" << fixed << setprecision(1) << temperature << " °C";
 			cout << " utilization=" << fixed << setprecision(3) << utilization << endl;
 
-			int expectedGoodFrequency = PowerModel::getExpectedGoodFrequency(frequency, power, perCorePowerBudget, minFrequency, maxFrequency, frequencyStepSize);
+			// without a fitted reading, the analytic model has no dynamic power yet and would pick the maximum frequency
+			int expectedGoodFrequency = powerModel != NULL && powerModel->isFitted(coreCounter)
+				? powerModel->getExpectedGoodFrequency(coreCounter, perCorePowerBudget, minFrequency, maxFrequency, frequencyStepSize)
+				: PowerModel::getExpectedGoodFrequency(frequency, power, perCorePowerBudget, minFrequency, maxFrequency, frequencyStepSize);
 			frequencies.at(coreCounter) = expectedGoodFrequency;
 		} else {
 			frequencies.at(coreCounter) = minFrequency;
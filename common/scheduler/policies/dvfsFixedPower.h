@@ -7,14 +7,16 @@
 
 #include <vector>
 #include "dvfspolicy.h"
+#include "analytic_power_model.h"
 
 class DVFSFixedPower : public DVFSPolicy {
 public:
-    DVFSFixedPower(const PerformanceCounters *performanceCounters, int coreRows, int coreColumns, int minFrequency, int maxFrequency, int frequencyStepSize, float perCorePowerBudget);
+    DVFSFixedPower(const PerformanceCounters *performanceCounters, AnalyticPowerModel *powerModel, int coreRows, int coreColumns, int minFrequency, int maxFrequency, int frequencyStepSize, float perCorePowerBudget);
     virtual std::vector<int> getFrequencies(const std::vector<int> &oldFrequencies, const std::vector<bool> &activeCores);
 
 private:
     const PerformanceCounters *performanceCounters;
+    AnalyticPowerModel *powerModel; // NULL: cubic scaling of the current power (PowerModel), which is also used until the model has fitted a reading of the core
     unsigned int coreRows;
     unsigned int coreColumns;
     int minFrequency;
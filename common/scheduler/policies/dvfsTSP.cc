@@ -0,0 +1,44 @@
+#include "dvfsTSP.h"
+#include "powermodel.h"
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+DVFSTSP::DVFSTSP(const PerformanceCounters *performanceCounters, const ThermalModel *thermalModel, AnalyticPowerModel *powerModel, int coreRows, int coreColumns, int minFrequency, int maxFrequency, int frequencyStepSize)
+	: performanceCounters(performanceCounters), thermalModel(thermalModel), powerModel(powerModel), coreRows(coreRows), coreColumns(coreColumns), minFrequency(minFrequency), maxFrequency(maxFrequency), frequencyStepSize(frequencyStepSize) {
+
+}
+
+std::vector<int> DVFSTSP::getFrequencies(const std::vector<int> &oldFrequencies, const std::vector<bool> &activeCores) {
+	std::vector<int> frequencies(coreRows * coreColumns);
+	if (powerModel != NULL) {
+		powerModel->update(oldFrequencies);
+	}
+
+	float perCorePowerBudget = thermalModel->tsp(activeCores);
+
+	for (unsigned int coreCounter = 0; coreCounter < coreRows * coreColumns; coreCounter++) {
+		if (activeCores.at(coreCounter)) {
+			float power = performanceCounters->getPowerOfCore(coreCounter);
+			float temperature = performanceCounters->getTemperatureOfCore(coreCounter);
+			int frequency = oldFrequencies.at(coreCounter);
+
+			cout << "[Scheduler][DVFSTSP]: Core " << setw(2) << coreCounter << ":";
+			cout << " P=" << fixed << setprecision(3) << power << " W";
+			cout << " (TSP: " << fixed << setprecision(3) << perCorePowerBudget << " W)";
+			cout << " f=" << frequency << " MHz";
+			cout << " T=" << fixed << setprecision(1) << temperature << " °C" << endl;
+
+			// without a fitted reading, the analytic model has no dynamic power yet and would pick the maximum frequency
+			int expectedGoodFrequency = powerModel != NULL && powerModel->isFitted(coreCounter)
+				? powerModel->getExpectedGoodFrequency(coreCounter, perCorePowerBudget, minFrequency, maxFrequency, frequencyStepSize)
+				: PowerModel::getExpectedGoodFrequency(frequency, power, perCorePowerBudget, minFrequency, maxFrequency, frequencyStepSize);
+			frequencies.at(coreCounter) = expectedGoodFrequency;
+		} else {
+			frequencies.at(coreCounter) = minFrequency;
+		}
+	}
+
+	return frequencies;
+}
@@ -0,0 +1,30 @@
+/**
+ * This header implements the TSP DVFS policy: every active core gets the Thermal Safe Power
+ * of the current set of active cores as its power budget.
+ */
+
+#ifndef __DVFS_TSP_H
+#define __DVFS_TSP_H
+
+#include <vector>
+#include "dvfspolicy.h"
+#include "thermalModel.h"
+#include "analytic_power_model.h"
+
+class DVFSTSP : public DVFSPolicy {
+public:
+    DVFSTSP(const PerformanceCounters *performanceCounters, const ThermalModel *thermalModel, AnalyticPowerModel *powerModel, int coreRows, int coreColumns, int minFrequency, int maxFrequency, int frequencyStepSize);
+    virtual std::vector<int> getFrequencies(const std::vector<int> &oldFrequencies, const std::vector<bool> &activeCores);
+
+private:
+    const PerformanceCounters *performanceCounters;
+    const ThermalModel *thermalModel;
+    AnalyticPowerModel *powerModel; // NULL: cubic scaling of the current power (PowerModel), which is also used until the model has fitted a reading of the core
+    unsigned int coreRows;
+    unsigned int coreColumns;
+    int minFrequency;
+    int maxFrequency;
+    int frequencyStepSize;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#include "mapTSP.h"
+#include <iostream>
+
+using namespace std;
+
+MapTSP::MapTSP(unsigned int coreRows, unsigned int coreColumns, const ThermalModel *thermalModel)
+	: coreRows(coreRows), coreColumns(coreColumns), thermalModel(thermalModel) {
+}
+
+std::vector<int> MapTSP::map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores) {
+	std::vector<int> cores;
+	std::vector<bool> available = availableCores;
+	std::vector<bool> active = activeCores;
+
+	while ((int)cores.size() < taskCoreRequirement) {
+		std::vector<int> candidates;
+		for (unsigned int c = 0; c < coreRows * coreColumns; c++) {
+			if (available.at(c)) {
+				candidates.push_back(c);
+			}
+		}
+		if (candidates.empty()) {
+			std::vector<int> empty;
+			return empty;
+		}
+
+		std::vector<double> tsps = thermalModel->tspForManyCandidates(active, candidates);
+		unsigned int best = 0;
+		for (unsigned int i = 1; i < candidates.size(); i++) {
+			if (tsps.at(i) > tsps.at(best)) {
+				best = i;
+			}
+		}
+
+		cout << "[Scheduler][MapTSP]: Core " << candidates.at(best) << " (TSP after mapping: " << tsps.at(best) << " W)" << endl;
+		cores.push_back(candidates.at(best));
+		available.at(candidates.at(best)) = false;
+		active.at(candidates.at(best)) = true;
+	}
+
+	return cores;
+}
@@ -0,0 +1,23 @@
+/**
+ * This header implements the "maximize TSP" mapping policy: cores are added one by one,
+ * each time picking the available core that leaves the highest Thermal Safe Power.
+ */
+
+#ifndef __MAP_TSP_H
+#define __MAP_TSP_H
+
+#include "mappingpolicy.h"
+#include "thermalModel.h"
+
+class MapTSP : public MappingPolicy {
+public:
+    MapTSP(unsigned int coreRows, unsigned int coreColumns, const ThermalModel *thermalModel);
+    virtual std::vector<int> map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores);
+
+private:
+    unsigned int coreRows;
+    unsigned int coreColumns;
+    const ThermalModel *thermalModel;
+};
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * policy_factory
+ * This class implements the instantiation of the open scheduler's policies.
+ */
+
+#include "policy_factory.h"
+#include "simulator.h"
+#include "config.hpp"
+
+#include "policies/dvfsMaxFreq.h"
+#include "policies/dvfsFixedPower.h"
+#include "policies/dvfsTestStaticPower.h"
+#include "policies/dvfsTSP.h"
+#include "policies/mapFirstUnused.h"
+#include "policies/mapTSP.h"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+PolicyFactory::PolicyFactory(const PerformanceCounters *performanceCounters, int coreRows, int coreColumns)
+	: performanceCounters(performanceCounters), coreRows(coreRows), coreColumns(coreColumns), thermalModel(NULL), powerModel(NULL) {
+	minFrequency = (int)(1000 * Sim()->getCfg()->getFloat("scheduler/open/dvfs/min_frequency") + 0.5);
+	maxFrequency = (int)(1000 * Sim()->getCfg()->getFloat("scheduler/open/dvfs/max_frequency") + 0.5);
+	frequencyStepSize = (int)(1000 * Sim()->getCfg()->getFloat("scheduler/open/dvfs/frequency_step_size") + 0.5);
+}
+
+/** requireThermalModel
+ * Load the thermal model used for TSP-based power budgets. Abort if it is not enabled.
+ */
+ThermalModel *PolicyFactory::requireThermalModel(String policyName) {
+	if (thermalModel != NULL) {
+		return thermalModel;
+	}
+
+	if (!Sim()->getCfg()->getBool("scheduler/open/thermal_model/enabled")) {
+		cout << "\n[Scheduler] [Error]: Policy '" << policyName << "' requires scheduler/open/thermal_model/enabled = true" << endl;
+		exit (1);
+	}
+
+	cout << "[Scheduler] [Info]: Initializing thermal model" << endl;
+	String thermalModelFilename = Sim()->getCfg()->getString("scheduler/open/thermal_model/file");
+	if (thermalModelFilename[0] != '/') {
+		const char *sniper_root = getenv("SNIPER_ROOT");
+		if (sniper_root == NULL) {
+			cout << "\n[Scheduler] [Error]: Please make sure SNIPER_ROOT is set" << endl;
+			exit (1);
+		}
+		thermalModelFilename = String(sniper_root) + "/config/" + thermalModelFilename;
+	}
+
+	double ambientTemperature = Sim()->getCfg()->getFloat("scheduler/open/thermal_model/ambient_temperature");
+	double maxTemperature = Sim()->getCfg()->getFloat("scheduler/open/thermal_model/max_temperature");
+	double inactivePower = Sim()->getCfg()->getFloat("scheduler/open/thermal_model/inactive_power");
+	double tdp = Sim()->getCfg()->getFloat("scheduler/open/thermal_model/tdp");
+	thermalModel = new ThermalModel((unsigned int)coreRows, (unsigned int)coreColumns, thermalModelFilename, ambientTemperature, maxTemperature, inactivePower, tdp);
+	return thermalModel;
+}
+
+/** getPowerModel
+ * Create the power model the power budget based DVFS policies estimate the power of frequencies with.
+ */
+AnalyticPowerModel *PolicyFactory::getPowerModel() {
+	String type = Sim()->getCfg()->getString("scheduler/open/dvfs/power_model/type");
+	if (type == "cubic") {
+		return NULL;
+	} else if (type != "analytic") {
+		cout << "\n[Scheduler] [Error]: Unknown power model '" << type << "'" << endl;
+		exit (1);
+	}
+
+	if (powerModel == NULL) {
+		powerModel = new AnalyticPowerModel(performanceCounters, coreRows * coreColumns);
+	}
+	return powerModel;
+}
+
+/** createMappingPolicy
+ * Initialize the mapping policy with the given name
+ */
+MappingPolicy *PolicyFactory::createMappingPolicy(String policyName) {
+	cout << "[Scheduler] [Info]: Initializing mapping policy" << endl;
+	if (policyName == "first_unused") {
+		vector<int> preferredCoresOrder;
+		for (core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); core_id++) {
+			int p = Sim()->getCfg()->getIntArray("scheduler/open/preferred_core", core_id);
+			if (p != -1) {
+				preferredCoresOrder.push_back(p);
+			} else {
+				break;
+			}
+		}
+		return new MapFirstUnused(coreRows, coreColumns, preferredCoresOrder);
+	} else if (policyName == "tsp") {
+		return new MapTSP(coreRows, coreColumns, requireThermalModel(policyName));
+	} //else if (policyName ="XYZ") {... } //Place to instantiate a new mapping logic. Implementation is put in "policies" package.
+	else {
+		cout << "\n[Scheduler] [Error]: Unknown Mapping Algorithm" << endl;
+ 		exit (1);
+	}
+}
+
+/** createDVFSPolicy
+ * Initialize the DVFS policy with the given name
+ */
+DVFSPolicy *PolicyFactory::createDVFSPolicy(String policyName) {
+	cout << "[Scheduler] [Info]: Initializing DVFS policy" << endl;
+	if (policyName == "off") {
+		return NULL;
+	} else if (policyName == "maxFreq") {
+		return new DVFSMaxFreq(performanceCounters, coreRows, coreColumns, maxFrequency);
+	} else if (policyName == "testStaticPower") {
+		return new DVFSTestStaticPower(performanceCounters, coreRows, coreColumns, minFrequency, maxFrequency);
+	} else if (policyName == "fixedPower") {
+		float perCorePowerBudget = Sim()->getCfg()->getFloat("scheduler/open/dvfs/fixed_power/per_core_power_budget");
+		return new DVFSFixedPower(performanceCounters, getPowerModel(), coreRows, coreColumns, minFrequency, maxFrequency, frequencyStepSize, perCorePowerBudget);
+	} else if (policyName == "tsp") {
+		return new DVFSTSP(performanceCounters, requireThermalModel(policyName), getPowerModel(), coreRows, coreColumns, minFrequency, maxFrequency, frequencyStepSize);
+	} else {
+		cout << "\n[Scheduler] [Error]: Unknown DVFS Algorithm" << endl;
+ 		exit (1);
+	}
+}
+
+/** createMigrationPolicy
+ * Initialize the migration policy with the given name
+ */
+MigrationPolicy *PolicyFactory::createMigrationPolicy(String policyName) {
+	cout << "[Scheduler] [Info]: Initializing migration policy" << endl;
+	if (policyName == "off") {
+		return NULL;
+	} //else if (policyName ="XYZ") {... } //Place to instantiate a new migration logic. Implementation is put in "policies" package.
+	else {
+		cout << "\n[Scheduler] [Error]: Unknown Migration Algorithm" << endl;
+ 		exit (1);
+	}
+}
@@ -0,0 +1,51 @@
+/**
+ * policy_factory
+ * This header implements the instantiation of the open scheduler's policies by their configured names.
+ */
+
+#ifndef __POLICY_FACTORY_H
+#define __POLICY_FACTORY_H
+
+#include "fixed_types.h"
+#include "thermalModel.h"
+#include "analytic_power_model.h"
+#include "performance_counters.h"
+#include "policies/dvfspolicy.h"
+#include "policies/mappingpolicy.h"
+#include "policies/migrationpolicy.h"
+
+/**
+ * Shared by the open scheduler and the policy replay (policy_replay.h), so that both drive identical policies.
+ * Policies are never deleted, so neither are the thermal and power models they keep a pointer to.
+ */
+class PolicyFactory {
+public:
+    PolicyFactory(const PerformanceCounters *performanceCounters, int coreRows, int coreColumns);
+
+    // Policy names as in scheduler/open/logic, scheduler/open/dvfs/logic and scheduler/open/migration/logic.
+    // The DVFS and migration policies are NULL when "off".
+    MappingPolicy *createMappingPolicy(String policyName);
+    DVFSPolicy *createDVFSPolicy(String policyName);
+    MigrationPolicy *createMigrationPolicy(String policyName);
+
+    int getMinFrequency() const { return minFrequency; }
+    int getMaxFrequency() const { return maxFrequency; }
+    int getFrequencyStepSize() const { return frequencyStepSize; }
+
+private:
+    const PerformanceCounters *performanceCounters;
+    int coreRows;
+    int coreColumns;
+    int minFrequency;
+    int maxFrequency;
+    int frequencyStepSize;
+
+    // Loaded on first use by a policy that needs it
+    ThermalModel *thermalModel;
+    ThermalModel *requireThermalModel(String policyName);
+    AnalyticPowerModel *powerModel;
+    // NULL when scheduler/open/dvfs/power_model/type = cubic (PowerModel)
+    AnalyticPowerModel *getPowerModel();
+};
+
+#endif
@@ -0,0 +1,687 @@
+/**
+ * policy_replay
+ * This class implements the trace-driven replay of the open scheduler's DVFS and migration policies.
+ */
+
+#include "policy_replay.h"
+#include "policy_factory.h"
+#include "powermodel.h"
+#include "telemetry.h"
+#include "simulator.h"
+#include "config.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+/** CPI stack labels whose time does not scale with the core frequency (see PowerThermalManager::initCpiStack). */
+static const char* timeBoundLabels[] = {
+	"mem-l3", "mem-l4", "mem-remote", "mem-nuca", "mem-dram-cache", "mem-dram", "sync", "imbalance",
+};
+
+/** splitLine
+ * Split a tab-separated log line, skipping empty fields (the power logs have a trailing tab).
+ */
+static vector<string> splitLine(const string &line) {
+	vector<string> fields;
+	istringstream iss(line);
+	string field;
+	while (getline(iss, field, '\t')) {
+		if (!field.empty() && field != "\r") {
+			fields.push_back(field);
+		}
+	}
+	return fields;
+}
+
+/** readUnitLog
+ * Read a header + readings log (PeriodicPower.log, PeriodicThermal.log). Incomplete lines end the log.
+ */
+static void readUnitLog(const string &fileName, vector<String> &unitNames, vector<vector<double> > &values) {
+	ifstream file(fileName.c_str());
+	if (!file.good()) {
+		cout << "\n[Scheduler] [Error]: Cannot open " << fileName << endl;
+		exit (1);
+	}
+
+	string line;
+	getline(file, line);
+	vector<string> header = splitLine(line);
+	unitNames.clear();
+	for (unsigned int i = 0; i < header.size(); i++) {
+		unitNames.push_back(String(header.at(i).c_str()));
+	}
+
+	while (getline(file, line)) {
+		vector<string> fields = splitLine(line);
+		if (fields.size() != unitNames.size()) {
+			break;
+		}
+		vector<double> readings;
+		for (unsigned int i = 0; i < fields.size(); i++) {
+			readings.push_back(atof(fields.at(i).c_str()));
+		}
+		values.push_back(readings);
+	}
+}
+
+PolicyReplay::PolicyReplay() : performanceCounters(NULL), dvfsPolicy(NULL), migrationPolicy(NULL), thermal(NULL), reliability(NULL) {
+	numberOfCores = Sim()->getConfig()->getApplicationCores();
+	interval = SubsecondTime::NS(Sim()->getCfg()->getInt("periodic_power/interval"));
+	referenceDir = Sim()->getCfg()->getString("scheduler/open/replay/reference");
+	validateDir = Sim()->getCfg()->getString("scheduler/open/replay/validate");
+	inactivePower = Sim()->getCfg()->getFloat("scheduler/open/thermal_model/inactive_power");
+	reservedCoresAreActive = Sim()->getCfg()->getBool("scheduler/open/dvfs/reserved_cores_are_active");
+
+	String outputDir = Sim()->getCfg()->getString("general/output_dir");
+	if (referenceDir == outputDir) {
+		cout << "\n[Scheduler] [Error]: The replay would overwrite the logs of its reference run, use a different output directory" << endl;
+		exit (1);
+	}
+
+	cout << "[Scheduler] [Info]: Replaying the reference run in " << referenceDir << endl;
+	readTrace(referenceDir, false, reference);
+	if (reference.frequency.empty() || reference.frequency.at(0).size() != numberOfCores) {
+		cout << "\n[Scheduler] [Error]: The reference run does not have " << numberOfCores << " cores" << endl;
+		exit (1);
+	}
+
+	// The policies query the replayed epochs through the telemetry only, there are no log files to import
+	performanceCounters = new PerformanceCounters(outputDir.c_str(),
+		"InstantaneousPower.log", "InstantaneousTemperature.log", "InstantaneousCPIStack.log", "InstantaneousRvalue.log");
+
+	int coreRows = (int)sqrt(numberOfCores);
+	while ((numberOfCores % coreRows) != 0) {
+		coreRows -= 1;
+	}
+	PolicyFactory policyFactory(performanceCounters, coreRows, numberOfCores / coreRows);
+	dvfsPolicy = policyFactory.createDVFSPolicy(Sim()->getCfg()->getString("scheduler/open/dvfs/logic"));
+	migrationPolicy = policyFactory.createMigrationPolicy(Sim()->getCfg()->getString("scheduler/open/migration/logic"));
+	minFrequency = policyFactory.getMinFrequency();
+	maxFrequency = policyFactory.getMaxFrequency();
+
+	// Same event order as SchedulerOpen
+	if (migrationPolicy != NULL) {
+		events.add(MIGRATION_EPOCH, SubsecondTime::NS(atol(Sim()->getCfg()->getString("scheduler/open/migration/epoch").c_str())));
+	}
+	if (dvfsPolicy != NULL) {
+		events.add(DVFS_EPOCH, SubsecondTime::NS(atol(Sim()->getCfg()->getString("scheduler/open/dvfs/dvfs_epoch").c_str())));
+	}
+
+	initUnits();
+
+	if (Sim()->getCfg()->getBool("periodic_thermal/enabled")) {
+		initThermal();
+		if (Sim()->getCfg()->getBool("reliability/enabled") && Sim()->getCfg()->getString("reliability/engine") == "native") {
+			reliability = new NativeReliabilityModel(reference.unitNames.size());
+		}
+	}
+
+	// Stream i starts on core i, at the frequency core i started with in the reference run
+	for (unsigned int stream = 0; stream < numberOfCores; stream++) {
+		unsigned int epochs = 0;
+		for (unsigned int epoch = 0; epoch < reference.epochs; epoch++) {
+			if (reference.cpiStack.at(epoch).at(totalLabel * numberOfCores + stream) > 0) {
+				epochs = epoch + 1;
+			}
+		}
+		streamEpochs.push_back(epochs);
+		streamOnCore.push_back(epochs > 0 ? stream : -1);
+		progress.push_back(0);
+		completionTime.push_back(epochs > 0 ? -1 : 0);
+		frequencies.push_back(reference.frequency.at(0).at(stream));
+	}
+	performanceCounters->notifyFreqsOfCores(frequencies);
+}
+
+PolicyReplay::~PolicyReplay() {
+	if (thermal) {
+		hotspot_thermal_free(thermal);
+	}
+	if (reliability) {
+		reliability->writeSums(reference.unitNames);
+		delete reliability;
+	}
+	delete performanceCounters;
+}
+
+/** isEnabled
+ * Return whether the standalone frontend should replay a reference run instead of simulating.
+ */
+bool PolicyReplay::isEnabled() {
+	return Sim()->getCfg()->getString("scheduler/open/replay/reference") != "";
+}
+
+/** readTrace
+ * Read the periodic logs of a run. The CPI stack is only needed for the reference, the temperatures only for validation.
+ */
+void PolicyReplay::readTrace(const String &dir, bool validation, Trace &trace) {
+	const string prefix = string(dir.c_str()) + "/";
+
+	readUnitLog(prefix + "PeriodicPower.log", trace.unitNames, trace.power);
+	trace.epochs = trace.power.size();
+
+	if (validation) {
+		vector<String> unitNames;
+		readUnitLog(prefix + "PeriodicThermal.log", unitNames, trace.temperature);
+		if (unitNames != trace.unitNames) {
+			cout << "\n[Scheduler] [Error]: Power and thermal logs in " << dir << " have different units" << endl;
+			exit (1);
+		}
+		trace.epochs = min(trace.epochs, (unsigned int)trace.temperature.size());
+	}
+
+	// Same format as tools/mcpat.py:log_frequencies, in GHz
+	vector<String> cores;
+	vector<vector<double> > frequencies;
+	readUnitLog(prefix + "PeriodicFrequency.log", cores, frequencies);
+	for (unsigned int epoch = 0; epoch < frequencies.size(); epoch++) {
+		vector<int> frequency;
+		for (unsigned int core = 0; core < frequencies.at(epoch).size(); core++) {
+			frequency.push_back((int)(1000 * frequencies.at(epoch).at(core) + 0.5));
+		}
+		trace.frequency.push_back(frequency);
+	}
+	trace.epochs = min(trace.epochs, (unsigned int)trace.frequency.size());
+
+	if (validation) {
+		return;
+	}
+
+	// Same format as tools/mcpat.py:log_cpi_stack: every epoch is a block of label lines starting with total, "-" for all zeros
+	const string cpiFileName = prefix + "PeriodicCPIStack.log";
+	ifstream cpiFile(cpiFileName.c_str());
+	if (!cpiFile.good()) {
+		cout << "\n[Scheduler] [Error]: Cannot open " << cpiFileName << endl;
+		exit (1);
+	}
+	string line;
+	getline(cpiFile, line);
+	const unsigned int numberOfCores = cores.size();
+	vector<double> block;
+	bool firstBlock = true;
+	while (getline(cpiFile, line)) {
+		vector<string> fields = splitLine(line);
+		if (fields.empty()) {
+			continue;
+		}
+		const String label = fields.at(0).c_str();
+		if (label == "total") {
+			if (!block.empty()) {
+				trace.cpiStack.push_back(block);
+				firstBlock = false;
+			}
+			block.assign(trace.cpiLabels.size() * numberOfCores, 0);
+		}
+
+		vector<String>::iterator it = find(trace.cpiLabels.begin(), trace.cpiLabels.end(), label);
+		if (it == trace.cpiLabels.end()) {
+			// The labels are those of the first block, labels that only show up later are dropped
+			if (!firstBlock) {
+				continue;
+			}
+			trace.cpiLabels.push_back(label);
+			block.resize(trace.cpiLabels.size() * numberOfCores, 0);
+			it = trace.cpiLabels.end() - 1;
+		}
+		if (fields.size() == numberOfCores + 1) {
+			for (unsigned int core = 0; core < numberOfCores; core++) {
+				block.at((it - trace.cpiLabels.begin()) * numberOfCores + core) = atof(fields.at(core + 1).c_str());
+			}
+		}
+	}
+	if (!block.empty()) {
+		trace.cpiStack.push_back(block);
+	}
+	trace.epochs = min(trace.epochs, (unsigned int)trace.cpiStack.size());
+}
+
+/** initUnits
+ * Group the floorplan units by core, and derive how the power of an inactive core is spread over its units.
+ */
+void PolicyReplay::initUnits() {
+	coreUnits.resize(numberOfCores);
+	vector<vector<String> > coreUnitSuffixes(numberOfCores);
+	for (unsigned int unit = 0; unit < reference.unitNames.size(); unit++) {
+		const String &name = reference.unitNames.at(unit);
+		String::size_type separator = name.find('_', 2);
+		if (name.compare(0, 2, "C_") != 0 || separator == String::npos) {
+			uncoreUnits.push_back(unit);
+			continue;
+		}
+		unsigned int core = atoi(name.substr(2, separator - 2).c_str());
+		if (core >= numberOfCores) {
+			cout << "\n[Scheduler] [Error]: Unit " << name << " of the reference run does not belong to any of the " << numberOfCores << " cores" << endl;
+			exit (1);
+		}
+		coreUnits.at(core).push_back(unit);
+		coreUnitSuffixes.at(core).push_back(name.substr(separator));
+	}
+
+	// Streams move their unit powers from one core to another by position
+	for (unsigned int core = 0; core < numberOfCores; core++) {
+		if (coreUnitSuffixes.at(core).empty() || (migrationPolicy != NULL && coreUnitSuffixes.at(core) != coreUnitSuffixes.at(0))) {
+			cout << "\n[Scheduler] [Error]: The replay requires the same floorplan units on every core" << endl;
+			exit (1);
+		}
+	}
+
+	totalLabel = -1;
+	for (unsigned int label = 0; label < reference.cpiLabels.size(); label++) {
+		if (reference.cpiLabels.at(label) == "total") {
+			totalLabel = label;
+		}
+		bool timeBound = false;
+		for (unsigned int i = 0; i < sizeof(timeBoundLabels) / sizeof(timeBoundLabels[0]); i++) {
+			timeBound |= reference.cpiLabels.at(label) == timeBoundLabels[i];
+		}
+		timeBoundLabel.push_back(timeBound);
+	}
+	if (totalLabel == -1) {
+		cout << "\n[Scheduler] [Error]: The CPI stack of the reference run has no total" << endl;
+		exit (1);
+	}
+
+	for (unsigned int core = 0; core < numberOfCores; core++) {
+		vector<double> share(coreUnits.at(core).size(), 0);
+		double sum = 0;
+		for (unsigned int epoch = 0; epoch < reference.epochs; epoch++) {
+			for (unsigned int k = 0; k < share.size(); k++) {
+				share.at(k) += reference.power.at(epoch).at(coreUnits.at(core).at(k));
+				sum += reference.power.at(epoch).at(coreUnits.at(core).at(k));
+			}
+		}
+		for (unsigned int k = 0; k < share.size(); k++) {
+			share.at(k) = sum > 0 ? share.at(k) / sum : 1.0 / share.size();
+		}
+		inactivePowerShare.push_back(share);
+	}
+
+	unitPower.resize(reference.unitNames.size(), 0);
+	unitTemperature.resize(reference.unitNames.size(), 0);
+	unitRvalue.resize(reference.unitNames.size(), -1);
+	cpiStack.resize(reference.cpiLabels.size() * numberOfCores, 0);
+	replayed.unitNames = reference.unitNames;
+	replayed.cpiLabels = reference.cpiLabels;
+
+	Sim()->getTelemetry()->setUnits(reference.unitNames);
+	Sim()->getTelemetry()->setCpiStackLabels(reference.cpiLabels);
+}
+
+/** initThermal
+ * Build the same HotSpot model as the native power engine (PowerThermalManager::initThermal).
+ */
+void PolicyReplay::initThermal() {
+	const char *sniper_root = getenv("SNIPER_ROOT");
+	if (sniper_root == NULL) {
+		cout << "\n[Scheduler] [Error]: Please make sure SNIPER_ROOT is set" << endl;
+		exit (1);
+	}
+
+	String hotspotDir = String(sniper_root) + "/hotspot";
+	String configFile = hotspotDir + "/" + Sim()->getCfg()->getString("periodic_thermal/hotspot_config");
+	String floorplan = hotspotDir + "/" + Sim()->getCfg()->getString("periodic_thermal/floorplan");
+	String reducedModel = Sim()->getCfg()->getString("periodic_thermal/reduced_model");
+
+	vector<const char*> names;
+	for (unsigned int unit = 0; unit < reference.unitNames.size(); unit++) {
+		names.push_back(reference.unitNames.at(unit).c_str());
+	}
+
+	if (reducedModel != "") {
+		thermal = hotspot_thermal_alloc_reduced((hotspotDir + "/" + reducedModel).c_str(), &names[0], names.size());
+	} else {
+		thermal = hotspot_thermal_alloc(configFile.c_str(), floorplan.c_str(), NULL, &names[0], names.size());
+	}
+}
+
+/** run
+ * Replay epochs until all streams completed, invoking the policies at their epochs.
+ */
+void PolicyReplay::run() {
+	SubsecondTime time = SubsecondTime::Zero();
+	while (find(completionTime.begin(), completionTime.end(), -1) != completionTime.end()) {
+		replayEpoch(time);
+		time += interval;
+
+		int event;
+		while ((event = events.popDue(time)) != -1) {
+			switch (event) {
+			case MIGRATION_EPOCH:
+				executeMigrationPolicy(time);
+				break;
+			case DVFS_EPOCH:
+				executeDVFSPolicy();
+				break;
+			}
+		}
+	}
+
+	writeReport();
+}
+
+/** replayEpoch
+ * Derive the power and CPI stack of one epoch from the reference epochs the streams are at, and advance the streams.
+ */
+void PolicyReplay::replayEpoch(SubsecondTime time) {
+	const unsigned int uncoreEpoch = min(replayed.epochs, reference.epochs - 1);
+	for (unsigned int i = 0; i < uncoreUnits.size(); i++) {
+		unitPower.at(uncoreUnits.at(i)) = reference.power.at(uncoreEpoch).at(uncoreUnits.at(i));
+	}
+	fill(cpiStack.begin(), cpiStack.end(), 0);
+
+	for (unsigned int core = 0; core < numberOfCores; core++) {
+		const vector<int> &units = coreUnits.at(core);
+		const int stream = streamOnCore.at(core);
+		if (stream == -1) {
+			for (unsigned int k = 0; k < units.size(); k++) {
+				unitPower.at(units.at(k)) = inactivePower * inactivePowerShare.at(core).at(k);
+			}
+			continue;
+		}
+
+		const unsigned int epoch = (unsigned int)progress.at(stream);
+		const int frequency = frequencies.at(core);
+		int referenceFrequency = reference.frequency.at(epoch).at(stream);
+		if (referenceFrequency <= 0) {
+			referenceFrequency = frequency;
+		}
+		const double ratio = (double)frequency / referenceFrequency;
+
+		// Core-bound cycles stay the same, time-bound cycles scale with the frequency
+		const vector<double> &referenceStack = reference.cpiStack.at(epoch);
+		double timeBound = 0;
+		for (unsigned int label = 0; label < reference.cpiLabels.size(); label++) {
+			if ((int)label == totalLabel) {
+				continue;
+			}
+			double cpi = referenceStack.at(label * numberOfCores + stream);
+			if (timeBoundLabel.at(label)) {
+				timeBound += cpi;
+				cpi *= ratio;
+			}
+			cpiStack.at(label * numberOfCores + core) = cpi;
+		}
+		const double referenceCPI = referenceStack.at(totalLabel * numberOfCores + stream);
+		const double cpi = referenceCPI - timeBound + timeBound * ratio;
+		cpiStack.at(totalLabel * numberOfCores + core) = cpi;
+
+		double referencePower = 0;
+		for (unsigned int k = 0; k < units.size(); k++) {
+			referencePower += reference.power.at(epoch).at(coreUnits.at(stream).at(k));
+		}
+		const double powerScale = referencePower > 0 ? PowerModel::estimatePower(referenceFrequency, referencePower, frequency) / referencePower : 1;
+		for (unsigned int k = 0; k < units.size(); k++) {
+			unitPower.at(units.at(k)) = reference.power.at(epoch).at(coreUnits.at(stream).at(k)) * powerScale;
+		}
+
+		// Reference epochs per replay epoch: the ratio of the instructions per second (idle epochs take their time)
+		const double rate = (referenceCPI > 0 && cpi > 0) ? ratio * referenceCPI / cpi : 1;
+		const double remaining = streamEpochs.at(stream) - progress.at(stream);
+		if (rate >= remaining) {
+			completionTime.at(stream) = (time.getFS() + interval.getFS() * remaining / rate) * 1e-15;
+			progress.at(stream) = streamEpochs.at(stream);
+			streamOnCore.at(core) = -1;
+			cout << "[Scheduler] Stream " << stream << " completed at " << completionTime.at(stream) * 1e3 << " ms" << endl;
+		} else {
+			progress.at(stream) += rate;
+		}
+	}
+
+	Sim()->getTelemetry()->publish(Telemetry::POWER, &unitPower[0]);
+	Sim()->getTelemetry()->publishCpiStack(&cpiStack[0]);
+	replayed.power.push_back(unitPower);
+	replayed.frequency.push_back(frequencies);
+
+	if (thermal) {
+		hotspot_thermal_step(thermal, &unitPower[0], interval.getFS() * 1e-15, &unitTemperature[0]);
+		for (unsigned int unit = 0; unit < unitTemperature.size(); unit++) {
+			unitTemperature.at(unit) -= 273.15;
+		}
+		Sim()->getTelemetry()->publish(Telemetry::TEMPERATURE, &unitTemperature[0]);
+		replayed.temperature.push_back(unitTemperature);
+
+		if (reliability) {
+			reliability->update(&unitTemperature[0], interval);
+			reliability->getRValues(&unitRvalue[0]);
+			Sim()->getTelemetry()->publish(Telemetry::RVALUE, &unitRvalue[0]);
+		}
+	}
+
+	replayed.epochs++;
+	writeLogs();
+}
+
+/** isActive
+ * Return whether a core executes instructions, or, with reserved_cores_are_active, whether it holds a stream.
+ */
+bool PolicyReplay::isActive(int coreId) const {
+	const int stream = streamOnCore.at(coreId);
+	if (stream == -1) {
+		return false;
+	}
+	return reservedCoresAreActive || reference.cpiStack.at((unsigned int)progress.at(stream)).at(totalLabel * numberOfCores + stream) > 0;
+}
+
+/** executeDVFSPolicy
+ * Set DVFS levels according to the used policy, limited as in SchedulerOpen::limitFrequency.
+ */
+void PolicyReplay::executeDVFSPolicy() {
+	vector<bool> activeCores;
+	for (unsigned int core = 0; core < numberOfCores; core++) {
+		activeCores.push_back(isActive(core));
+	}
+	vector<int> newFrequencies = dvfsPolicy->getFrequencies(frequencies, activeCores);
+	for (unsigned int core = 0; core < numberOfCores; core++) {
+		int frequency = newFrequencies.at(core);
+		if (frequency > frequencies.at(core) + 1000) {
+			frequency = frequencies.at(core) + 1000;
+		}
+		if (frequency < minFrequency) {
+			frequency = minFrequency;
+		}
+		if (frequency > maxFrequency) {
+			frequency = maxFrequency;
+		}
+		frequencies.at(core) = frequency;
+	}
+	performanceCounters->notifyFreqsOfCores(newFrequencies);
+}
+
+/** executeMigrationPolicy
+ * Move streams according to the used policy. Migrations take effect at the next epoch, without overhead.
+ */
+void PolicyReplay::executeMigrationPolicy(SubsecondTime time) {
+	vector<int> taskIds;
+	vector<bool> activeCores;
+	for (unsigned int core = 0; core < numberOfCores; core++) {
+		taskIds.push_back(streamOnCore.at(core));
+		activeCores.push_back(isActive(core));
+	}
+	vector<migration> migrations = migrationPolicy->migrate(time, taskIds, activeCores);
+
+	for (unsigned int i = 0; i < migrations.size(); i++) {
+		const migration &m = migrations.at(i);
+		if (m.fromCore >= numberOfCores || m.toCore >= numberOfCores) {
+			cout << "\n[Scheduler][Error]: Migration Policy ordered migration with non-existing core.\n";
+			exit (1);
+		}
+		if (streamOnCore.at(m.fromCore) == -1) {
+			cout << "\n[Scheduler][Error]: Migration Policy ordered migration from unused core.\n";
+			exit (1);
+		}
+		if (m.swap) {
+			if (streamOnCore.at(m.toCore) == -1) {
+				cout << "\n[Scheduler][Error]: Migration Policy ordered swap with unused core.\n";
+				exit (1);
+			}
+		} else if (streamOnCore.at(m.toCore) != -1) {
+			cout << "\n[Scheduler][Error]: Migration Policy ordered migration to already used core.\n";
+			exit (1);
+		}
+		swap(streamOnCore.at(m.fromCore), streamOnCore.at(m.toCore));
+	}
+}
+
+/** writeLogs
+ * Append the last replayed epoch to the Periodic*.log files, in the format of the reference run.
+ */
+void PolicyReplay::writeLogs() const {
+	const bool append = replayed.epochs > 1;
+	const ios::openmode mode = append ? ios::app : ios::trunc;
+	char value[32];
+
+	String header;
+	for (unsigned int unit = 0; unit < replayed.unitNames.size(); unit++) {
+		header += (unit ? "\t" : "") + replayed.unitNames.at(unit);
+	}
+
+	ofstream powerLog(Sim()->getConfig()->formatOutputFileName("PeriodicPower.log").c_str(), mode);
+	if (!append) {
+		powerLog << header << "\n";
+	}
+	for (unsigned int unit = 0; unit < unitPower.size(); unit++) {
+		snprintf(value, sizeof(value), "%.12g", unitPower.at(unit));
+		powerLog << value << "\t";
+	}
+	powerLog << "\n";
+
+	if (thermal) {
+		ofstream thermalLog(Sim()->getConfig()->formatOutputFileName("PeriodicThermal.log").c_str(), mode);
+		if (!append) {
+			thermalLog << header << "\n";
+		}
+		for (unsigned int unit = 0; unit < unitTemperature.size(); unit++) {
+			snprintf(value, sizeof(value), "%.2f", unitTemperature.at(unit));
+			thermalLog << (unit ? "\t" : "") << value;
+		}
+		thermalLog << "\n";
+	}
+
+	ofstream frequencyLog(Sim()->getConfig()->formatOutputFileName("PeriodicFrequency.log").c_str(), mode);
+	if (!append) {
+		for (unsigned int core = 0; core < numberOfCores; core++) {
+			frequencyLog << (core ? "\t" : "") << "Core" << core;
+		}
+		frequencyLog << "\n";
+	}
+	for (unsigned int core = 0; core < numberOfCores; core++) {
+		snprintf(value, sizeof(value), "%.3f", frequencies.at(core) / 1000.);
+		frequencyLog << (core ? "\t" : "") << value;
+	}
+	frequencyLog << "\n";
+}
+
+/** summarize
+ * Aggregate the metrics of a run for the report.
+ */
+PolicyReplay::Summary PolicyReplay::summarize(const Trace &trace, double makespan) const {
+	Summary summary;
+	summary.makespan = makespan;
+	summary.averagePower = 0;
+	summary.peakTemperature = -1;
+	summary.averagePeakTemperature = -1;
+
+	for (unsigned int epoch = 0; epoch < trace.epochs; epoch++) {
+		for (unsigned int unit = 0; unit < trace.power.at(epoch).size(); unit++) {
+			summary.averagePower += trace.power.at(epoch).at(unit);
+		}
+	}
+	const double length = interval.getFS() * 1e-15;
+	summary.energy = summary.averagePower * length;
+	summary.averagePower /= max(trace.epochs, 1u);
+
+	if (trace.temperature.size() >= trace.epochs && trace.epochs > 0) {
+		summary.averagePeakTemperature = 0;
+		for (unsigned int epoch = 0; epoch < trace.epochs; epoch++) {
+			const double peak = *max_element(trace.temperature.at(epoch).begin(), trace.temperature.at(epoch).end());
+			summary.peakTemperature = max(summary.peakTemperature, peak);
+			summary.averagePeakTemperature += peak / trace.epochs;
+		}
+	}
+	return summary;
+}
+
+/** writeReport
+ * Write the summary of the replay, and its error against a real run of the same policies if given.
+ */
+void PolicyReplay::writeReport() {
+	double makespan = 0;
+	for (unsigned int stream = 0; stream < numberOfCores; stream++) {
+		makespan = max(makespan, completionTime.at(stream));
+	}
+	Summary replay = summarize(replayed, makespan);
+
+	String fileName = Sim()->getConfig()->formatOutputFileName(Sim()->getCfg()->getString("scheduler/open/replay/report"));
+	ofstream report(fileName.c_str());
+	report << "reference = " << referenceDir << "\n";
+	report << "reference.epochs = " << reference.epochs << "\n";
+	report << "replay.epochs = " << replayed.epochs << "\n";
+	report << "replay.makespan = " << replay.makespan << "\n";
+	for (unsigned int stream = 0; stream < numberOfCores; stream++) {
+		report << "replay.completion[" << stream << "] = " << completionTime.at(stream) << "\n";
+	}
+	report << "replay.average_power = " << replay.averagePower << "\n";
+	report << "replay.energy = " << replay.energy << "\n";
+	report << "replay.peak_temperature = " << replay.peakTemperature << "\n";
+	report << "replay.average_peak_temperature = " << replay.averagePeakTemperature << "\n";
+
+	if (validateDir != "") {
+		Trace real;
+		readTrace(validateDir, true, real);
+		if (real.unitNames != replayed.unitNames) {
+			cout << "\n[Scheduler] [Error]: The validation run in " << validateDir << " has different units than the reference run" << endl;
+			exit (1);
+		}
+		Summary summary = summarize(real, real.epochs * interval.getFS() * 1e-15);
+
+		report << "validate = " << validateDir << "\n";
+		report << "validate.epochs = " << real.epochs << "\n";
+		report << "validate.makespan = " << summary.makespan << "\n";
+		report << "validate.average_power = " << summary.averagePower << "\n";
+		report << "validate.energy = " << summary.energy << "\n";
+		report << "validate.peak_temperature = " << summary.peakTemperature << "\n";
+		report << "validate.average_peak_temperature = " << summary.averagePeakTemperature << "\n";
+
+		// Relative errors of the totals, and the mean absolute per-epoch errors over the epochs both runs have
+		report << "error.makespan = " << (replay.makespan - summary.makespan) / summary.makespan << "\n";
+		report << "error.energy = " << (replay.energy - summary.energy) / summary.energy << "\n";
+		report << "error.average_power = " << (replay.averagePower - summary.averagePower) / summary.averagePower << "\n";
+
+		const unsigned int epochs = min(replayed.epochs, real.epochs);
+		const bool temperatures = replayed.temperature.size() >= epochs;
+		double powerError = 0, temperatureError = 0, frequencyError = 0;
+		for (unsigned int epoch = 0; epoch < epochs; epoch++) {
+			double replayPower = 0, realPower = 0;
+			for (unsigned int unit = 0; unit < replayed.unitNames.size(); unit++) {
+				replayPower += replayed.power.at(epoch).at(unit);
+				realPower += real.power.at(epoch).at(unit);
+			}
+			powerError += fabs(replayPower - realPower) / epochs;
+
+			if (temperatures) {
+				const double replayPeak = *max_element(replayed.temperature.at(epoch).begin(), replayed.temperature.at(epoch).end());
+				const double realPeak = *max_element(real.temperature.at(epoch).begin(), real.temperature.at(epoch).end());
+				temperatureError += fabs(replayPeak - realPeak) / epochs;
+			}
+
+			for (unsigned int core = 0; core < numberOfCores; core++) {
+				frequencyError += fabs((double)replayed.frequency.at(epoch).at(core) - real.frequency.at(epoch).at(core)) / (epochs * numberOfCores);
+			}
+		}
+		report << "error.epochs = " << epochs << "\n";
+		report << "error.power = " << powerError << "\n";
+		if (temperatures) {
+			report << "error.peak_temperature = " << temperatureError << "\n";
+		}
+		report << "error.frequency = " << frequencyError << "\n";
+	}
+
+	cout << "[Scheduler] [Info]: Replay completed after " << replayed.epochs << " epochs, report in " << fileName << endl;
+}
@@ -0,0 +1,121 @@
+/**
+ * policy_replay
+ * This header implements the trace-driven replay of the open scheduler's DVFS and migration policies.
+ */
+
+#ifndef __POLICY_REPLAY_H
+#define __POLICY_REPLAY_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "hotspot_lib.h"
+#include "native_reliability_model.h"
+#include "performance_counters.h"
+#include "scheduler_event_queue.h"
+#include "policies/dvfspolicy.h"
+#include "policies/migrationpolicy.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Approximates a run with other DVFS or migration policies from the Periodic*.log files of a reference run,
+ * without simulating instructions ([scheduler/open/replay] reference, started from the standalone frontend).
+ *
+ * The work of reference core i is replayed as stream i, which starts on core i and moves with the migrations.
+ * Each replay epoch, a stream executes the reference epoch it has progressed to at the frequency of its core:
+ *  - the core-bound part of its CPI stack stays the same in cycles, the time-bound part (uncore memory,
+ *    synchronization, imbalance) stays the same in time and therefore scales with the frequency,
+ *  - the power of its core scales with PowerModel::estimatePower,
+ *  - it progresses by the ratio of its instructions per second to those of the reference epoch.
+ * Power, temperatures (the configured HotSpot model), R-values (native reliability engine) and the scaled CPI
+ * stack are published to the telemetry, so the policies see the same PerformanceCounters interface as in a
+ * simulation. The replay ends when all streams completed the reference trace. Migration costs are not modeled.
+ *
+ * Writes PeriodicPower/Thermal/Frequency.log and a report, which includes the approximation error when the
+ * output directory of a real run with the replayed policies is given ([scheduler/open/replay] validate).
+ */
+class PolicyReplay {
+public:
+    PolicyReplay();
+    ~PolicyReplay();
+
+    static bool isEnabled();
+    void run();
+
+private:
+    // The Periodic*.log files of a run
+    struct Trace {
+        std::vector<String> unitNames;
+        std::vector<std::vector<double> > power;        // [epoch][unit], W
+        std::vector<std::vector<double> > temperature;  // [epoch][unit], Celsius (validation run only)
+        std::vector<std::vector<int> > frequency;       // [epoch][core], MHz
+        std::vector<String> cpiLabels;
+        std::vector<std::vector<double> > cpiStack;     // [epoch][label * numberOfCores + core]
+        unsigned int epochs;
+        Trace() : epochs(0) {}
+    };
+
+    // Summary of a (replayed or real) run, for the report
+    struct Summary {
+        double makespan;            // s
+        double averagePower;        // W
+        double energy;              // J
+        double peakTemperature;     // Celsius, -1 without temperatures
+        double averagePeakTemperature;
+    };
+
+    enum ReplayEvent { MIGRATION_EPOCH, DVFS_EPOCH };
+
+    unsigned int numberOfCores;
+    SubsecondTime interval;
+    String referenceDir;
+    String validateDir;
+    Trace reference;
+
+    // Units of each core (C_<core>_*), in the same component order for all cores
+    std::vector<std::vector<int> > coreUnits;
+    std::vector<int> uncoreUnits;
+    std::vector<bool> timeBoundLabel;
+    int totalLabel;
+    // Per core and unit, the share of the inactive core power
+    std::vector<std::vector<double> > inactivePowerShare;
+    double inactivePower;
+    bool reservedCoresAreActive;
+
+    PerformanceCounters *performanceCounters;
+    DVFSPolicy *dvfsPolicy;
+    MigrationPolicy *migrationPolicy;
+    SchedulerEventQueue events;
+    int minFrequency;
+    int maxFrequency;
+
+    hotspot_thermal_t *thermal;
+    NativeReliabilityModel *reliability;
+
+    // Replay state
+    std::vector<int> streamOnCore;          // -1 if no stream
+    std::vector<unsigned int> streamEpochs; // per stream, up to and including its last epoch with instructions
+    std::vector<double> progress;           // per stream, in reference epochs
+    std::vector<double> completionTime;     // per stream, s (-1 while running)
+    std::vector<int> frequencies;           // per core, MHz
+    std::vector<double> unitPower, unitTemperature, unitRvalue, cpiStack;
+    // The replayed epochs, in the same form as the reference
+    Trace replayed;
+
+    static void readTrace(const String &dir, bool validation, Trace &trace);
+    void initUnits();
+    void initThermal();
+
+    void replayEpoch(SubsecondTime time);
+    void executeDVFSPolicy();
+    void executeMigrationPolicy(SubsecondTime time);
+    bool isActive(int coreId) const;
+
+    void writeLogs() const;
+
+    Summary summarize(const Trace &trace, double makespan) const;
+    void writeReport();
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "scheduler_event_queue.h"
+
+void SchedulerEventQueue::add(int id, SubsecondTime period) {
+	Event event;
+	event.deadline = period;
+	event.period = period;
+	event.id = id;
+	events.push(event);
+}
+
+int SchedulerEventQueue::popDue(SubsecondTime time) {
+	if (events.empty() || events.top().deadline > time) {
+		return -1;
+	}
+
+	Event event = events.top();
+	events.pop();
+	do {
+		event.deadline += event.period;
+	} while (event.deadline <= time);
+	events.push(event);
+
+	return event.id;
+}
+
+SubsecondTime SchedulerEventQueue::getNextDeadline() const {
+	return events.empty() ? SubsecondTime::MaxTime() : events.top().deadline;
+}
@@ -0,0 +1,41 @@
+/**
+ * scheduler_event_queue
+ * This header implements the periodic events (mapping, DVFS and migration epochs, consistency checks) of the open scheduler.
+ */
+
+#ifndef __SCHEDULER_EVENT_QUEUE_H
+#define __SCHEDULER_EVENT_QUEUE_H
+
+#include "subsecond_time.h"
+
+#include <queue>
+#include <vector>
+
+/**
+ * Priority queue of periodic events, ordered by their next deadline.
+ * The scheduler is only invoked at barriers, which do not necessarily fall on multiples of an epoch
+ * (the barrier skips ahead when all cores are idle). An event therefore fires at the first barrier
+ * at or after its deadline, and fires once even if several of its deadlines passed since.
+ */
+class SchedulerEventQueue {
+public:
+    // Events with equal deadlines fire in ascending id order.
+    void add(int id, SubsecondTime period);
+    // Returns the next event with a deadline at or before the given time and re-arms it, or -1.
+    int popDue(SubsecondTime time);
+    SubsecondTime getNextDeadline() const;
+
+private:
+    struct Event {
+        SubsecondTime deadline;
+        SubsecondTime period;
+        int id;
+
+        bool operator>(const Event &other) const {
+            return deadline > other.deadline || (deadline == other.deadline && id > other.id);
+        }
+    };
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+};
+
+#endif
@@ -12,10 +12,7 @@
 #include "magic_server.h"
 #include "thread_manager.h"
 
-#include "policies/dvfsMaxFreq.h"
-#include "policies/dvfsFixedPower.h"
-#include "policies/dvfsTestStaticPower.h"
-#include "policies/mapFirstUnused.h"
+#include "policy_factory.h"
 
 #include <iomanip>
 #include <random>
@@ -26,100 +23,8 @@
 
 using namespace std;
 
-int k=0;
-
-String queuePolicy; //Stores Queuing Policy for Open System from base.cfg.
-String distribution; //Stores the arrival distribution of the open workload from base.cfg.
-
-bool randomPriority; //Stores 1 if priority to be assigned randomly or 0 if priority is to be set by user explicitly from base.cfg.
-
-int arrivalRate; //Stores the arrival rate of the workload from base.cfg.
-int arrivalInterval; //Stores the arrival interval of the workload from base.cfg.
-
-int numberOfTasks; //Stores the number of tasks in the open workload.
-int numberOfCores; //Stores the number of cores in the system.
-
 int coreRequirementTranslation (String compositionString);
 
-//This data structure maintains the state of the tasks.
-struct openTask {
-
-	openTask(int taskIDInput, String taskNameInput) : taskID(taskIDInput), taskName(taskNameInput) {}
-
-	int taskID;
-        String taskName;
-	bool waitingToSchedule = true;
-	bool waitingInQueue = false;
-	bool active = false;
-	bool completed = false;
-	int taskCoreRequirement = coreRequirementTranslation(taskName);
-	UInt64 taskArrivalTime;
-	UInt64 taskStartTime;
-	UInt64 taskDepartureTime; 
-	int priority;
-	
-};
-
-vector <openTask> openTasks;
-
-struct ComparePriority {															//custom comparator for waitingTaskQ
-			bool operator()(openTask p1, openTask p2){
-			// return "true" if "p1" is ordered
-			// before "p2", for example:
-				if(p1.priority == p2.priority){
-					return p1.taskArrivalTime > p2.taskArrivalTime;
-				}
-				else{
-					return p1.priority < p2.priority;
-				}
-			}
-		};
-
-struct ComparePriorityAQ {															//custom comparator for ActiveTaskQ
-			bool operator()(openTask p1, openTask p2){
-			// return "true" if "p1" is ordered
-			// before "p2", for example:
-				return p1.priority > p2.priority;
-			}
-		};
-
-void showAQ(priority_queue<openTask, vector<openTask>, ComparePriorityAQ> gq)		//display taskID of tasks in ActiveTaskQ
-{
-    priority_queue<openTask, vector<openTask>, ComparePriorityAQ> g = gq;
-    while (!g.empty()) {
-        cout << g.top().taskID;
-        g.pop();
-    }
-    cout << '\n';
-};
-
-void showtaskID(priority_queue<openTask, vector<openTask>, ComparePriority> gq)		//display taskID of tasks in waitingTaskQ
-{
-    priority_queue<openTask, vector<openTask>, ComparePriority> g = gq;
-    while (!g.empty()) {
-        cout << g.top().taskID;
-        g.pop();
-    }
-    cout << '\n';
-};
-
-
-priority_queue<openTask, vector<openTask>, ComparePriority> waitingTaskQ;			//This priority queue holds the tasks in waiting queue in order of priority (with highest priority at top)
-priority_queue<openTask, vector<openTask>, ComparePriorityAQ> ActiveTaskQ;		//This priority queue holds the tasks that are active in order of priority (with lowest priority at top)
-
-		
-//This data structure maintains the state of the cores.
-struct systemCore {
-
-	systemCore(int coreIDInput) : coreID(coreIDInput) {}
-
-	int coreID;
-	int assignedTaskID = -1; // -1 means core assigned to no task
-	int assignedThreadID = -1;// -1 means core assigned to no thread.
-};
-
-vector <systemCore> systemCores;
-
 
 
 /** SchedulerOpen
@@ -173,16 +78,13 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
 		exit (1);
 	}
 
-	//Initialize the cores in the system.
-	for (int coreIterator=0; coreIterator < numberOfCores; coreIterator++) {
-		systemCores.push_back (coreIterator);
-	}
-
-	//Initialize the task state array.
+	//Initialize the cores in the system and the task state array.
+	taskState = new SchedulerTaskState(numberOfCores, queuePolicy == "priority");
 	String benchmarks = Sim()->getCfg()->getString("traceinput/benchmarks");
 	String benchmarksDelimiter = "+";
 	for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
-		openTasks.push_back (openTask (taskIterator,benchmarks.substr(0, benchmarks.find(benchmarksDelimiter))));
+		String taskName = benchmarks.substr(0, benchmarks.find(benchmarksDelimiter));
+		taskState->addTask (taskName, coreRequirementTranslation (taskName));
 		benchmarks.erase(0, benchmarks.find(benchmarksDelimiter) + benchmarksDelimiter.length());		
 	}						
 
@@ -191,16 +93,16 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
 
 		if(randomPriority == true){
 			for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
-				openTasks[taskIterator].priority = rand()%10;
+				taskState->setPriority (taskIterator, rand()%10);
 				
-				cout << "[Scheduler]: Setting Priority for Task " << taskIterator << " (" + openTasks[taskIterator].taskName + ")" << " to " << openTasks[taskIterator].priority << endl;
+				cout << "[Scheduler]: Setting Priority for Task " << taskIterator << " (" + taskState->getTask(taskIterator).taskName + ")" << " to " << taskState->getTask(taskIterator).priority << endl;
 			}
 		}
 		else{
 			for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
 			UInt64 priorityvalue = Sim()->getCfg()->getIntArray("scheduler/open/explicitPriorityValues", taskIterator);
-			cout << "[Scheduler]: Setting Priority for Task " << taskIterator << " (" + openTasks[taskIterator].taskName + ")" << " to " << priorityvalue << endl;
-			openTasks[taskIterator].priority = priorityvalue;
+			cout << "[Scheduler]: Setting Priority for Task " << taskIterator << " (" + taskState->getTask(taskIterator).taskName + ")" << " to " << priorityvalue << endl;
+			taskState->setPriority (taskIterator, priorityvalue);
 			
 			}
 		}
@@ -212,15 +114,15 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
 		UInt64 time = 0;
 		for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
 			if (taskIterator % arrivalRate == 0 && taskIterator != 0) time += arrivalInterval;  
-			cout << "[Scheduler]: Setting Arrival Time for Task " << taskIterator << " (" + openTasks[taskIterator].taskName + ")" << " to " << time << +" ns" << endl;
-			openTasks[taskIterator].taskArrivalTime = time;
+			cout << "[Scheduler]: Setting Arrival Time for Task " << taskIterator << " (" + taskState->getTask(taskIterator).taskName + ")" << " to " << time << +" ns" << endl;
+			taskState->setArrivalTime (taskIterator, time);
 							
 		}
 	} else if (distribution == "explicit") {
 		for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
 			UInt64 time = Sim()->getCfg()->getIntArray("scheduler/open/explicitArrivalTimes", taskIterator);
-			cout << "[Scheduler]: Setting Arrival Time for Task " << taskIterator << " (" + openTasks[taskIterator].taskName + ")" << " to " << time << +" ns" << endl;
-			openTasks[taskIterator].taskArrivalTime = time;
+			cout << "[Scheduler]: Setting Arrival Time for Task " << taskIterator << " (" + taskState->getTask(taskIterator).taskName + ")" << " to " << time << +" ns" << endl;
+			taskState->setArrivalTime (taskIterator, time);
 			
 		}
 	} else if (distribution == "poisson") {
@@ -243,8 +145,8 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
 			if (taskIterator % arrivalRate == 0 && taskIterator != 0) {
 				time += (UInt64)expdistribution(generator);
 			}
-			cout << "[Scheduler]: Setting Arrival Time for Task " << taskIterator << " (" + openTasks[taskIterator].taskName + ")" << " to " << time << +" ns" << endl;
-			openTasks[taskIterator].taskArrivalTime = time;
+			cout << "[Scheduler]: Setting Arrival Time for Task " << taskIterator << " (" + taskState->getTask(taskIterator).taskName + ")" << " to " << time << +" ns" << endl;
+			taskState->setArrivalTime (taskIterator, time);
 				
 		}
 
@@ -254,194 +156,44 @@ SchedulerOpen::SchedulerOpen(ThreadManager *thread_manager)
  		exit (1);
 	}
 
-	for(int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++){
-		waitingTaskQ.push(openTasks[taskIterator]);
-		cout << "Pushing Task " << taskIterator << " to the waitingTaskQ" << endl;
-	}
-	
-	initMappingPolicy(Sim()->getCfg()->getString("scheduler/open/logic").c_str());
-	initDVFSPolicy(Sim()->getCfg()->getString("scheduler/open/dvfs/logic").c_str());
-	initMigrationPolicy(Sim()->getCfg()->getString("scheduler/open/migration/logic").c_str());
-}
+	PolicyFactory policyFactory(performanceCounters, coreRows, coreColumns);
+	mappingPolicy = policyFactory.createMappingPolicy(Sim()->getCfg()->getString("scheduler/open/logic").c_str());
+	dvfsPolicy = policyFactory.createDVFSPolicy(Sim()->getCfg()->getString("scheduler/open/dvfs/logic").c_str());
+	migrationPolicy = policyFactory.createMigrationPolicy(Sim()->getCfg()->getString("scheduler/open/migration/logic").c_str());
 
-/** initMappingPolicy
- * Initialize the mapping policy to the policy with the given name
- */
-void SchedulerOpen::initMappingPolicy(String policyName) {
-	cout << "[Scheduler] [Info]: Initializing mapping policy" << endl;
-	if (policyName == "first_unused") {
-		vector<int> preferredCoresOrder;
-		for (core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); core_id++) {
-			int p = Sim()->getCfg()->getIntArray("scheduler/open/preferred_core", core_id);
-			if (p != -1) {
-				preferredCoresOrder.push_back(p);
-			} else {
-				break;
-			}
-		}
-		mappingPolicy = new MapFirstUnused(coreRows, coreColumns, preferredCoresOrder);
-	} //else if (policyName ="XYZ") {... } //Place to instantiate a new mapping logic. Implementation is put in "policies" package.
-	else {
-		cout << "\n[Scheduler] [Error]: Unknown Mapping Algorithm" << endl;
- 		exit (1);
-	}
-}
+	nextQuantumCheck = SubsecondTime::Zero();
+	reschedulePending = false;
+	quantumStart.assign(Sim()->getConfig()->getApplicationCores(), SubsecondTime::Zero());
 
-/** initDVFSPolicy
- * Initialize the DVFS policy to the policy with the given name
- */
-void SchedulerOpen::initDVFSPolicy(String policyName) {
-	cout << "[Scheduler] [Info]: Initializing DVFS policy" << endl;
-	if (policyName == "off") {
-		dvfsPolicy = NULL;
-	} else if (policyName == "maxFreq") {
-		dvfsPolicy = new DVFSMaxFreq(performanceCounters, coreRows, coreColumns, maxFrequency);
-	} else if (policyName == "testStaticPower") {
-		dvfsPolicy = new DVFSTestStaticPower(performanceCounters, coreRows, coreColumns, minFrequency, maxFrequency);
-	} else if (policyName == "fixedPower") {
-		float perCorePowerBudget = Sim()->getCfg()->getFloat("scheduler/open/dvfs/fixed_power/per_core_power_budget");
-		dvfsPolicy = new DVFSFixedPower(performanceCounters, coreRows, coreColumns, minFrequency, maxFrequency, frequencyStepSize, perCorePowerBudget);
-	} else {
-		cout << "\n[Scheduler] [Error]: Unknown DVFS Algorithm" << endl;
- 		exit (1);
+	String traceFile = Sim()->getCfg()->getString("scheduler/open/trace/file");
+	trace = new SchedulerTrace(traceFile == "" ? "" : Sim()->getConfig()->formatOutputFileName(traceFile).c_str(),
+		SubsecondTime::NS(Sim()->getCfg()->getInt("scheduler/open/trace/console_interval")));
+
+	events.add(CONSISTENCY_CHECK, SubsecondTime::NS(1000000)); //Error Checking at every 1ms. Can be faster but will have overhead in simulation time.
+	if (migrationPolicy != NULL) {
+		events.add(MIGRATION_EPOCH, SubsecondTime::NS(migrationEpoch));
 	}
+	if (dvfsPolicy != NULL) {
+		events.add(DVFS_EPOCH, SubsecondTime::NS(dvfsEpoch));
+	}
+	events.add(MAPPING_EPOCH, SubsecondTime::NS(mappingEpoch));
 }
 
-/** initMigrationPolicy
- * Initialize the migration policy to the policy with the given name
- */
-void SchedulerOpen::initMigrationPolicy(String policyName) {
-	cout << "[Scheduler] [Info]: Initializing migration policy" << endl;
-	if (policyName == "off") {
-		migrationPolicy = NULL;
-	} //else if (policyName ="XYZ") {... } //Place to instantiate a new migration logic. Implementation is put in "policies" package.
-	else {
-		cout << "\n[Scheduler] [Error]: Unknown Migration Algorithm" << endl;
- 		exit (1);
-	}
+SchedulerOpen::~SchedulerOpen() {
+	// flushes and closes the trace file
+	delete trace;
 }
 
 /** taskFrontOfQueue
-    Returns the ID of the task in front of queue. Place to implement a new queuing policy.
+    Returns the ID of the task in front of queue, -1 if the queue is empty. The queue order is set by the queuing policy.
 */
-int taskFrontOfQueue () {
-	int IDofTaskInFrontOfQueue = -1;
-
-	if (queuePolicy == "FIFO") {
-		for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
-			if (openTasks [taskIterator].waitingInQueue) {
-				IDofTaskInFrontOfQueue = taskIterator;
-				break;
-			}
-		}
-	}
-	//else if (queuePolicy ="XYZ") {... } //Place to implement a new queuing policy.
-	else if (queuePolicy == "priority"){ 
-		SubsecondTime time = Sim()->getClockSkewMinimizationServer()->getGlobalTime();
-		if ((openTasks [waitingTaskQ.top().taskID].waitingInQueue) && (openTasks[waitingTaskQ.top().taskID].taskArrivalTime <= time.getNS())){
-
-			IDofTaskInFrontOfQueue = waitingTaskQ.top().taskID;
-
-		}
-
-		else {
-			while ((!openTasks [waitingTaskQ.top().taskID].waitingInQueue) || (!(openTasks[waitingTaskQ.top().taskID].taskArrivalTime <= time.getNS()))){
-
-				waitingTaskQ.pop();
-
-			}
-			IDofTaskInFrontOfQueue = waitingTaskQ.top().taskID;
-		}
-		
-	}
-	else {
-	
+int SchedulerOpen::taskFrontOfQueue () {
+	if (queuePolicy != "FIFO" && queuePolicy != "priority") { //Place to implement a new queuing policy (see SchedulerTaskState).
 		cout<<"\n[Scheduler] [Error]: Unknown Queuing Policy"<< endl;
  		exit (1);
 	}
 
-	return IDofTaskInFrontOfQueue;
-}
-
-/** numberOfFreeCores
-    Returns number of free cores in the system.
-*/
-int numberOfFreeCores () {
-	int freeCoresCounter = 0;
-	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
-		if (systemCores[coreCounter].assignedTaskID == -1) {
-			freeCoresCounter++;
-		}
-	}
-	return freeCoresCounter;
-}
-
-/** numberOfTasksInQueue
-    Returns the number of tasks in the queue.
-*/
-int numberOfTasksInQueue () {
-	int tasksInQueue = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].waitingInQueue == true) 
-			tasksInQueue++;
-	
-	return tasksInQueue;
-}
-
-/** numberOfTasksWaitingToSchedule
-    Returns the number of tasks not yet entered into the queue.
-*/
-int numberOfTasksWaitingToSchedule () {
-	int tasksWaitingToSchedule = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].waitingToSchedule == true) 
-			tasksWaitingToSchedule++;
-
-	
-	return tasksWaitingToSchedule;
-}
-
-/** numberOfTasksCompleted
-    Returns the number of tasks completed.
-*/
-int numberOfTasksCompleted () {
-	int tasksCompleted = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].completed == true) 
-			tasksCompleted++;
-
-	
-	return tasksCompleted;
-}
-
-/** numberOfActiveTasks
-    Returns the number of active tasks.
-*/
-int numberOfActiveTasks () {
-	int activeTasks = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].active == true) 
-			activeTasks++;
-
-	
-	return activeTasks;
-}
-
-/** numberOfActiveTasks
-    Returns the number of core required by all active tasks.
-*/
-int totalCoreRequirementsOfActiveTasks () {
-	int coreRequirement = 0;
-	
-	for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) 
-		if (openTasks[taskCounter].active == true) 
-			coreRequirement += openTasks[taskCounter].taskCoreRequirement;
-
-	return coreRequirement;
+	return taskState->getFrontOfQueue ();
 }
 
 /** threadSetAffinity
@@ -489,6 +241,7 @@ bool SchedulerOpen::threadSetAffinity(thread_id_t calling_thread_id, thread_id_t
    {
       // Reschedule the thread as soon as possible
       m_quantum_left[m_thread_info[thread_id].getCoreRunning()] = SubsecondTime::Zero();
+      reschedulePending = true;
    }
    else if (m_threads_runnable[thread_id]                                  // Thread is runnable
             && !m_thread_info[thread_id].isRunning())                      // Thread is not running (we can't preempt it outside of the barrier)
@@ -514,10 +267,10 @@ int SchedulerOpen::setAffinity (thread_id_t thread_id) {
 	int coreFound = -1;
 	app_id_t app_id =  Sim()->getThreadManager()->getThreadFromID(thread_id)->getAppId();
 
-	for (int  i = 0; i<numberOfCores; i++) 
-		if (systemCores[i].assignedTaskID == app_id && systemCores[i].assignedThreadID == -1) {
-				coreFound = i;
-				break;
+	const vector<int> &taskCores = taskState->getCoresOfTask (app_id);
+	for (unsigned int i = 0; i < taskCores.size(); i++) 
+		if (!isAssignedToThread (taskCores[i]) && (coreFound == -1 || taskCores[i] < coreFound)) {
+				coreFound = taskCores[i];
 		}
 
 	
@@ -533,7 +286,7 @@ int SchedulerOpen::setAffinity (thread_id_t thread_id) {
 		CPU_ZERO(&my_set); 
 		CPU_SET(coreFound, &my_set);
 		threadSetAffinity(INVALID_THREAD_ID, thread_id, sizeof(cpu_set_t), &my_set); 
-		systemCores[coreFound].assignedThreadID = thread_id; 
+		taskState->assignThread (coreFound, thread_id); 
 	}
 
 	return coreFound;
@@ -545,13 +298,7 @@ int SchedulerOpen::setAffinity (thread_id_t thread_id) {
  */
 void SchedulerOpen::migrateThread(thread_id_t thread_id, core_id_t core_id)
 {
-	int from_core_id = -1;
-	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
-		if (systemCores[coreCounter].assignedThreadID == thread_id) {
-			from_core_id = coreCounter;
-			break;
-		}
-	}
+	int from_core_id = taskState->getCoreOfThread (thread_id);
 	if (from_core_id == -1) {
 		cout << "[Scheduler] [Error] could not find core of thread " << thread_id << endl;
 		exit(1);
@@ -570,11 +317,7 @@ void SchedulerOpen::migrateThread(thread_id_t thread_id, core_id_t core_id)
 		CPU_SET(core_id, &my_set);
 		threadSetAffinity(INVALID_THREAD_ID, thread_id, sizeof(cpu_set_t), &my_set); 
 
-		systemCores[core_id].assignedTaskID = systemCores[from_core_id].assignedTaskID;
-		systemCores[core_id].assignedThreadID = thread_id;
-
-		systemCores[from_core_id].assignedTaskID = -1;
-		systemCores[from_core_id].assignedThreadID = -1;
+		taskState->swapCores (from_core_id, core_id);
 	}
 }
 
@@ -594,14 +337,14 @@ int SchedulerOpen::getCoreNb(int y, int x) {
  * Return whether the given core is assigned to a task.
  */
 bool SchedulerOpen::isAssignedToTask(int coreId) {
-	return systemCores[coreId].assignedTaskID != -1;
+	return !taskState->isFree (coreId);
 }
 
 /** isAssignedToThread
  * Return whether the given core is assigned to a thread.
  */
 bool SchedulerOpen::isAssignedToThread(int coreId) {
-	return systemCores[coreId].assignedThreadID != -1;
+	return taskState->getCore (coreId).assignedThreadID != -1;
 }
 
 bool SchedulerOpen::executeMappingPolicy(int taskID, SubsecondTime time) {
@@ -612,8 +355,9 @@ bool SchedulerOpen::executeMappingPolicy(int taskID, SubsecondTime time) {
 		activeCores.at(i) = isAssignedToTask(i);
 	}
 	// get the cores
-	vector<int> bestCores = mappingPolicy->map(openTasks[taskID].taskName, openTasks[taskID].taskCoreRequirement, availableCores, activeCores);
-	if ((int)bestCores.size() < openTasks[taskID].taskCoreRequirement) {
+	const SchedulerTaskState::Task &task = taskState->getTask (taskID);
+	vector<int> bestCores = mappingPolicy->map(task.taskName, task.taskCoreRequirement, availableCores, activeCores);
+	if ((int)bestCores.size() < task.taskCoreRequirement) {
 		cout << "[Scheduler]: Policy returned too few cores, mapping failed." << endl;
 		return false;
 	}
@@ -621,7 +365,7 @@ bool SchedulerOpen::executeMappingPolicy(int taskID, SubsecondTime time) {
 	// assign the cores
 	for (unsigned int i = 0; i < bestCores.size(); i++) {
 		cout << "[Scheduler]: Assigning Core " << bestCores.at(i) << " to Task " << taskID << endl;
-		systemCores[bestCores.at(i)].assignedTaskID = taskID;
+		taskState->assignTask (bestCores.at(i), taskID);
 	}
 
 	return true;
@@ -634,29 +378,16 @@ bool SchedulerOpen::schedule (int taskID, bool isInitialCall, SubsecondTime time
 	cout <<"\n[Scheduler]: Trying to schedule Task " << taskID << " at Time " << formatTime(time) << endl;
 
 	bool mappingSuccesfull = false;
+	const SchedulerTaskState::Task &task = taskState->getTask (taskID);
 
-	if (openTasks [taskID].taskArrivalTime > time.getNS ()) {
+	if (task.taskArrivalTime > time.getNS ()) {
 		cout <<"\n[Scheduler]: Task " << taskID << " is not ready for execution. \n";	
 		return false; //Task not ready for mapping.
 	} 
 	
-	else {
+	else if (task.state != SchedulerTaskState::IN_QUEUE) {
 		cout <<"\n[Scheduler]: Task " << taskID << " put into execution queue. \n";
-		openTasks [taskID].waitingInQueue = true;
-		openTasks [taskID].waitingToSchedule = false;
-			
-		if(waitingTaskQ.size()>1){
-			openTask tempo = waitingTaskQ.top();
-			waitingTaskQ.pop();
-			
-			if(tempo.taskID != waitingTaskQ.top().taskID){		//making sure that one task doesn't get pushed to waitingTaskQ twice
-				waitingTaskQ.push(tempo);
-			}
-			else{
-				waitingTaskQ.pop();
-				waitingTaskQ.push(openTasks[tempo.taskID]);
-			}
-		}	
+		taskState->setTaskState (taskID, SchedulerTaskState::IN_QUEUE);
 	}
 
 	if (taskFrontOfQueue () != taskID) {
@@ -665,52 +396,17 @@ bool SchedulerOpen::schedule (int taskID, bool isInitialCall, SubsecondTime time
 		return false; //Not turn of this task to be mapped.
 	}
 
-	if (numberOfFreeCores () < openTasks[taskID].taskCoreRequirement) { //If priority queuing is adopted, then we need to check for it and readjust tasks if required
- 		if((queuePolicy == "priority") && (openTasks [ActiveTaskQ.top().taskID].priority < openTasks[taskID].priority)){
-		   	 while((numberOfFreeCores () < openTasks[taskID].taskCoreRequirement) && (openTasks[ActiveTaskQ.top().taskID].priority < openTasks[taskID].priority) ){
-				for(int t=0; t < Sim()->getThreadManager()->getNumThreads() ; t++ ){
-					app_id_t app_id =  Sim()->getThreadManager()->getThreadFromID(t)->getAppId();
-					if(ActiveTaskQ.top().taskID == app_id ){
-						 SubsecondTime time = Sim()->getClockSkewMinimizationServer()->getGlobalTime();
-						
-						for (int i = 0; i < numberOfCores; i++) {
-							if (systemCores[i].assignedThreadID == t){
-								systemCores[i].assignedThreadID = -1;
-								cout << "\n[Scheduler]: Releasing Core " << i << " from Thread " << t << "\n";
-								
-								cpu_set_t my_set; 
-								CPU_ZERO(&my_set); 
-								CPU_SET(INVALID_CORE_ID, &my_set);
-								Sim()->getThreadManager()->getLock();
-								m_thread_info[t].clearAffinity();	
-							}
-
-						}
-					
-						if (t < numberOfTasks) {									
-							
-
-							for (int i = 0; i < numberOfCores; i++) {
-								if (systemCores[i].assignedTaskID == app_id) {
-									systemCores[i].assignedTaskID = -1;
-								}
-							}
-						}				 	
-					}
-				}
-				 	
-				openTasks[ActiveTaskQ.top().taskID].active = false;
-				openTasks[ActiveTaskQ.top().taskID].waitingInQueue = true;
-				if(waitingTaskQ.top().taskID != ActiveTaskQ.top().taskID){
-					waitingTaskQ.push(ActiveTaskQ.top());
-				}
-				ActiveTaskQ.pop();
-				k++;
+	if (taskState->getNumberOfFreeCores () < task.taskCoreRequirement) { //If priority queuing is adopted, then we need to check for it and readjust tasks if required
+		int lowestPriorityTask = taskState->getLowestPriorityActiveTask ();
+ 		if((queuePolicy == "priority") && (lowestPriorityTask != -1) && (taskState->getTask (lowestPriorityTask).priority < task.priority)){
+		   	 while((taskState->getNumberOfFreeCores () < task.taskCoreRequirement) && (lowestPriorityTask != -1) && (taskState->getTask (lowestPriorityTask).priority < task.priority) ){
+				preemptTask (lowestPriorityTask);
+				lowestPriorityTask = taskState->getLowestPriorityActiveTask ();
 			}																								
 	 	}
 		 
 		else{						
-			cout <<"\n[Scheduler]: Not Enough Free Cores (" << numberOfFreeCores () << ") to Schedule the Task " << taskID << " with cores requirement " << openTasks[taskID].taskCoreRequirement  << endl;
+			cout <<"\n[Scheduler]: Not Enough Free Cores (" << taskState->getNumberOfFreeCores () << ") to Schedule the Task " << taskID << " with cores requirement " << task.taskCoreRequirement  << endl;
 			return false;
 		}
 	}
@@ -720,23 +416,31 @@ bool SchedulerOpen::schedule (int taskID, bool isInitialCall, SubsecondTime time
 			if (!isInitialCall) 
 			cout << "\n[Scheduler]: Waking Task " << taskID << " at core " << setAffinity (taskID) << endl;
 				
-		openTasks [taskID].taskStartTime = time.getNS();
-		
-		openTasks [taskID].active = true;		
-		ActiveTaskQ.push(openTasks[taskID]);
-		openTasks [taskID].waitingInQueue = false;
-		
-		if((queuePolicy=="priority") && (waitingTaskQ.top().taskID == taskID)){
-			waitingTaskQ.pop();
-		}
-			
-		openTasks [taskID].waitingToSchedule = false;
+		taskState->setStartTime (taskID, time.getNS());
+		taskState->setTaskState (taskID, SchedulerTaskState::ACTIVE);
 	} 
 
 	return mappingSuccesfull;
 
 }
 
+/** preemptTask
+    Releases the cores of an active task and puts it back into the queue.
+*/
+void SchedulerOpen::preemptTask (int taskID) {
+	vector<int> taskCores = taskState->getCoresOfTask (taskID);
+	for (unsigned int i = 0; i < taskCores.size(); i++) {
+		int thread = taskState->getCore (taskCores[i]).assignedThreadID;
+		if (thread != -1) {
+			cout << "\n[Scheduler]: Releasing Core " << taskCores[i] << " from Thread " << thread << "\n";
+			m_thread_info[thread].clearAffinity();
+		}
+		taskState->assignTask (taskCores[i], -1);
+	}
+
+	taskState->setTaskState (taskID, SchedulerTaskState::IN_QUEUE);
+}
+
 /** threadCreate
     This original Sniper function is called when a thread is created.
 */
@@ -784,6 +488,8 @@ core_id_t SchedulerOpen::threadCreate(thread_id_t thread_id) {
       		m_thread_info[thread_id].setCoreRunning(free_core_id);
       		m_core_thread_running[free_core_id] = thread_id;
       		m_quantum_left[free_core_id] = m_quantum;
+      		quantumStart[free_core_id] = time;
+      		nextQuantumCheck = std::min(nextQuantumCheck, time + m_quantum);
       		return free_core_id;
    	}
    	else {
@@ -800,42 +506,13 @@ core_id_t SchedulerOpen::threadCreate(thread_id_t thread_id) {
 }
 
 /** fetchTasksIntoQueue
-    This function pulls tasks into the openSystem Queue.
+    This function pulls the arrived tasks into the openSystem Queue.
 */
-void fetchTasksIntoQueue (SubsecondTime time) {
-
-	if(queuePolicy == "priority"){
-		for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) {
-			if (openTasks [taskCounter].waitingToSchedule && openTasks [taskCounter].taskArrivalTime <= time.getNS ()) {
-				
-				cout <<"\n[Scheduler]: Task " << taskCounter << " put into execution queue. \n";
-				openTasks [taskCounter].waitingInQueue = true;
-				
-				
-					if(waitingTaskQ.top().taskID != taskCounter){
-					waitingTaskQ.push(openTasks [taskCounter]);
-					}
-					
-					if(waitingTaskQ.top().taskID == ActiveTaskQ.top().taskID){
-						waitingTaskQ.pop();
-					}
-			
-			
-				openTasks [taskCounter].waitingToSchedule = false;
-
-				cout << "Task " << taskCounter << " has been pushed to waitingTaskQ" << endl;
-			}
-		}
-	}
-
-	else{
-		for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++) {
-			if (openTasks [taskCounter].waitingToSchedule && openTasks [taskCounter].taskArrivalTime <= time.getNS ()) {
-				cout <<"\n[Scheduler]: Task " << taskCounter << " put into execution queue. \n";
-				openTasks [taskCounter].waitingInQueue = true;
-				openTasks [taskCounter].waitingToSchedule = false;
-			}
-		}
+void SchedulerOpen::fetchTasksIntoQueue (SubsecondTime time) {
+	int taskID;
+	while ((taskID = taskState->getNextArrival ()) != -1 && taskState->getTask (taskID).taskArrivalTime <= time.getNS ()) {
+		cout <<"\n[Scheduler]: Task " << taskID << " put into execution queue. \n";
+		taskState->setTaskState (taskID, SchedulerTaskState::IN_QUEUE);
 	}
 }
 
@@ -851,17 +528,15 @@ void SchedulerOpen::threadExit(thread_id_t thread_id, SubsecondTime time) {
 	app_id_t app_id =  Sim()->getThreadManager()->getThreadFromID(thread_id)->getAppId();
 	cout << "\n[Scheduler]: Thread " << thread_id << " from Task "  << app_id << " Exiting at Time " << formatTime(time) << endl;
 
-	for (int i = 0; i < numberOfCores; i++) {
-		if (systemCores[i].assignedThreadID == thread_id) {
-			systemCores[i].assignedThreadID = -1;
-			cout << "\n[Scheduler]: Releasing Core " << i << " from Thread " << thread_id << "\n";
-			
-			cpu_set_t my_set; 
-			CPU_ZERO(&my_set); 
-			CPU_SET(INVALID_CORE_ID, &my_set);
-			threadSetAffinity(INVALID_THREAD_ID, thread_id, sizeof(cpu_set_t), &my_set);	
-		}
+	int threadCore = taskState->getCoreOfThread (thread_id);
+	if (threadCore != -1) {
+		taskState->assignThread (threadCore, -1);
+		cout << "\n[Scheduler]: Releasing Core " << threadCore << " from Thread " << thread_id << "\n";
 		
+		cpu_set_t my_set; 
+		CPU_ZERO(&my_set); 
+		CPU_SET(INVALID_CORE_ID, &my_set);
+		threadSetAffinity(INVALID_THREAD_ID, thread_id, sizeof(cpu_set_t), &my_set);	
 	}
 
 
@@ -869,81 +544,37 @@ void SchedulerOpen::threadExit(thread_id_t thread_id, SubsecondTime time) {
 		
 		cout << "\n[Scheduler]: Task " << app_id << " Finished." << "\n";
 
-			for (int i = 0; i < numberOfCores; i++) {
-				if (systemCores[i].assignedTaskID == app_id) {
-					systemCores[i].assignedTaskID = -1;
-					cout << "\n[Scheduler]: Releasing Core " << i << " from Task " << app_id << "\n";
-				}
+			vector<int> taskCores = taskState->getCoresOfTask (app_id);
+			for (unsigned int i = 0; i < taskCores.size(); i++) {
+				taskState->assignTask (taskCores[i], -1);
+				cout << "\n[Scheduler]: Releasing Core " << taskCores[i] << " from Task " << app_id << "\n";
 			}
 
-			openTasks[app_id].taskDepartureTime = time.getNS();
-			openTasks[app_id].completed = true;
-			openTasks[app_id].active = false;
-			if(queuePolicy == "priority"){
-				priority_queue<openTask, vector<openTask>, ComparePriority> tempQ;
-
-				if(ActiveTaskQ.top().taskID == app_id){
-
-					ActiveTaskQ.pop();
-
-				}
-				else{
-					while(ActiveTaskQ.top().taskID != app_id){
-
-						tempQ.push(ActiveTaskQ.top());
-						ActiveTaskQ.pop();
-
-					}
-
-					while(tempQ.size() != 0){
-
-						ActiveTaskQ.push(tempQ.top());
-						tempQ.pop();
-
-					}
-				}
-			}
+			taskState->setDepartureTime (app_id, time.getNS());
+			taskState->setTaskState (app_id, SchedulerTaskState::COMPLETED);
 			
-		cout << "\n[Scheduler][Result]: Task " << app_id << " (Response/Service/Wait) Time (ns) "  << " :\t" <<  time.getNS() - openTasks[app_id].taskArrivalTime << "\t" <<  time.getNS() - openTasks[app_id].taskStartTime << "\t" << openTasks[app_id].taskStartTime - openTasks[app_id].taskArrivalTime << "\n";
+		const SchedulerTaskState::Task &task = taskState->getTask (app_id);
+		cout << "\n[Scheduler][Result]: Task " << app_id << " (Response/Service/Wait) Time (ns) "  << " :\t" <<  time.getNS() - task.taskArrivalTime << "\t" <<  time.getNS() - task.taskStartTime << "\t" << task.taskStartTime - task.taskArrivalTime << "\n";
 	
 	}
 	
-	if (numberOfFreeCores () == numberOfCores && numberOfTasksWaitingToSchedule () != 0) {
+	if (taskState->getNumberOfFreeCores () == numberOfCores && taskState->getNumberOfTasks (SchedulerTaskState::WAITING_TO_SCHEDULE) != 0) {
 		cout << "\n[Scheduler]: System Going Empty ... Prefetching Tasks\n"; //Without Prefectching Sniper will Deadlock or End Prematurely.
 
-		if (numberOfTasksInQueue () != 0) {
+		if (taskState->getNumberOfTasks (SchedulerTaskState::IN_QUEUE) != 0) {
 			cout << "\n[Scheduler]: Prefetching Task from Queue\n";
 			schedule (taskFrontOfQueue (), false, time);
 		}
-		else if (numberOfTasksWaitingToSchedule () != 0) {
-
-			SInt64 timeJump = 0;
-
-			UInt64 nextArrivalTime = 0;
-			for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
-				if (openTasks[taskIterator].waitingToSchedule) {
-					if (nextArrivalTime == 0) { 
-						nextArrivalTime = openTasks[taskIterator].taskArrivalTime;
-					}
-					else if (nextArrivalTime > openTasks[taskIterator].taskArrivalTime) {
-						nextArrivalTime = openTasks[taskIterator].taskArrivalTime;
-					}
-				}
-
-			}
+		else {
 
-			timeJump = nextArrivalTime - time.getNS();
+			UInt64 nextArrivalTime = taskState->getTask (taskState->getNextArrival ()).taskArrivalTime;
+			SInt64 timeJump = nextArrivalTime - time.getNS();
 			if (timeJump < 0) {
                 cout << "\n[Scheduler]: Task arrival time in past, moving it forward to the current time with negative arrival time adjustment.\n";
             }
 			cout << "\n[Scheduler]: Readjusting Arrival Time by " << timeJump << " ns \n"; // This will not effect the result of response time as arrival time of all unscheduled tasks are adjusted relatively.
 
-			for (int taskIterator = 0; taskIterator < numberOfTasks; taskIterator++) {
-				if (openTasks[taskIterator].waitingToSchedule) {
-					openTasks[taskIterator].taskArrivalTime -= timeJump;
-					cout << "\n[Scheduler]: New Arrival Time from Task " << taskIterator << " set at " << openTasks[taskIterator].taskArrivalTime << " ns" <<  "\n"; 
-				}
-			}
+			taskState->shiftArrivalTimes (-timeJump);
 
 			fetchTasksIntoQueue (time);
 
@@ -954,13 +585,13 @@ void SchedulerOpen::threadExit(thread_id_t thread_id, SubsecondTime time) {
 
 	}
 
-	if (numberOfTasksCompleted ()  == numberOfTasks) {
+	if (taskState->getNumberOfTasks (SchedulerTaskState::COMPLETED) == numberOfTasks) {
 		
 		cout << "\n[Scheduler]: All tasks finished executing. \n";
 		UInt64 averageResponseTime = 0;
 
 		for (int taskCounter = 0; taskCounter < numberOfTasks; taskCounter++){
-			averageResponseTime += openTasks [taskCounter].taskDepartureTime - openTasks [taskCounter].taskArrivalTime;
+			averageResponseTime += taskState->getTask (taskCounter).taskDepartureTime - taskState->getTask (taskCounter).taskArrivalTime;
 		}
 
 
@@ -1149,11 +780,9 @@ void SchedulerOpen::DVFSTransitionNotDelayed(int coreCounter) {
 }
 
 /**
- * Set the frequency for a core.
+ * Get the frequency a core is set to when the DVFS policy requests the given frequency.
  */
-void SchedulerOpen::setFrequency(int coreCounter, int frequency) {
-	int oldFrequency = Sim()->getMagicServer()->getFrequency(coreCounter);
-
+int SchedulerOpen::limitFrequency(int coreCounter, int oldFrequency, int frequency) {
 	if (frequency > oldFrequency + 1000) {
 		frequency = oldFrequency + 1000;
 	}
@@ -1166,11 +795,10 @@ void SchedulerOpen::setFrequency(int coreCounter, int frequency) {
 
 	if (delayDVFSTransition(coreCounter, oldFrequency, frequency)) {
 		DVFSTransitionDelayed(coreCounter, oldFrequency, frequency);
+		return oldFrequency;
 	} else {
 		DVFSTransitionNotDelayed(coreCounter);
-		if (frequency != oldFrequency) {
-			Sim()->getMagicServer()->setFrequency(coreCounter, frequency);
-		}
+		return frequency;
 	}
 }
 
@@ -1187,9 +815,12 @@ void SchedulerOpen::executeDVFSPolicy() {
 		activeCores.push_back(reserved_cores_are_active ? isAssignedToTask(coreCounter) : isAssignedToThread(coreCounter));
 	}
 	vector<int> frequencies = dvfsPolicy->getFrequencies(oldFrequencies, activeCores);
+	// All cores change at once, with a single frequency change hook
+	vector<int> newFrequencies;
 	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
-		setFrequency(coreCounter, frequencies.at(coreCounter));
+		newFrequencies.push_back(limitFrequency(coreCounter, oldFrequencies.at(coreCounter), frequencies.at(coreCounter)));
 	}
+	Sim()->getMagicServer()->setFrequencies(newFrequencies);
 	performanceCounters->notifyFreqsOfCores(frequencies);
 }
 
@@ -1199,7 +830,7 @@ void SchedulerOpen::executeDVFSPolicy() {
 void SchedulerOpen::executeMigrationPolicy(SubsecondTime time) {
 	std::vector<int> taskIds;
 	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
-		taskIds.push_back(systemCores.at(coreCounter).assignedTaskID);
+		taskIds.push_back(taskState->getCore(coreCounter).assignedTaskID);
 	}
 	std::vector<bool> activeCores;
 	for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
@@ -1209,20 +840,18 @@ void SchedulerOpen::executeMigrationPolicy(SubsecondTime time) {
 	std::vector<migration> migrations = migrationPolicy->migrate(time, taskIds, activeCores);
 
 	for (migration &migration : migrations) {
-		if (systemCores.at(migration.fromCore).assignedTaskID == -1) {
+		if (!isAssignedToTask(migration.fromCore)) {
 			cout << "\n[Scheduler][Error]: Migration Policy ordered migration from unused core.\n";		
 			exit (1);
 		}
 
 		if (migration.swap) {
-			if (systemCores.at(migration.toCore).assignedTaskID == -1) {
+			if (!isAssignedToTask(migration.toCore)) {
 				cout << "\n[Scheduler][Error]: Migration Policy ordered swap with unused core.\n";		
 				exit (1);
 			}
-			int taskFrom = systemCores.at(migration.fromCore).assignedTaskID;
-			int threadFrom = systemCores.at(migration.fromCore).assignedThreadID;
-			int taskTo = systemCores.at(migration.toCore).assignedTaskID;
-			int threadTo = systemCores.at(migration.toCore).assignedThreadID;
+			int threadFrom = taskState->getCore(migration.fromCore).assignedThreadID;
+			int threadTo = taskState->getCore(migration.toCore).assignedThreadID;
 
 			if (threadFrom != -1) {
 				cout << "[Scheduler] moving thread " << threadFrom << " from core " << migration.fromCore << " to core " << migration.toCore << endl;
@@ -1238,131 +867,180 @@ void SchedulerOpen::executeMigrationPolicy(SubsecondTime time) {
 				CPU_SET(migration.fromCore, &my_set);
 				threadSetAffinity(INVALID_THREAD_ID, threadTo, sizeof(cpu_set_t), &my_set);
 			}
-			systemCores.at(migration.toCore).assignedTaskID = taskFrom;
-			systemCores.at(migration.toCore).assignedThreadID = threadFrom;
-			systemCores.at(migration.fromCore).assignedTaskID = taskTo;
-			systemCores.at(migration.fromCore).assignedThreadID = threadTo;
+			taskState->swapCores(migration.fromCore, migration.toCore);
 		} else {
-			if (systemCores.at(migration.toCore).assignedTaskID != -1) {
+			if (isAssignedToTask(migration.toCore)) {
 				cout << "\n[Scheduler][Error]: Migration Policy ordered migration to already used core.\n";
 				exit (1);
 			}
-			int thread = systemCores.at(migration.fromCore).assignedThreadID;
+			int thread = taskState->getCore(migration.fromCore).assignedThreadID;
 			if (thread != -1) {
 				migrateThread(thread, migration.toCore);
 			} else {
-				systemCores.at(migration.toCore).assignedTaskID = systemCores.at(migration.fromCore).assignedTaskID;
-				systemCores.at(migration.fromCore).assignedTaskID = -1;
+				taskState->swapCores(migration.fromCore, migration.toCore);
 			}
 		}
 	}
 }
 
 
-/** periodic
-    This function is called periodically by Sniper at Interval of 100ns.
+/** checkConsistency
+    Makes sure that the system state is not messed up.
 */
-void SchedulerOpen::periodic(SubsecondTime time) {
-	if (time.getNS () % 1000000 == 0) { //Error Checking at every 1ms. Can be faster but will have overhead in simulation time.
-		cout << "\n[Scheduler]: Time " << formatTime(time) << " [Active Tasks =  " << numberOfActiveTasks () << " | Completed Tasks = " <<  numberOfTasksCompleted () << " | Queued Tasks = "  << numberOfTasksInQueue () << " | Non-Queued Tasks  = " <<  numberOfTasksWaitingToSchedule () <<  " | Free Cores = " << numberOfFreeCores () << " | Active Tasks Requirements = " << totalCoreRequirementsOfActiveTasks () << " ] \n" << endl;
-
-		// showtaskID(waitingTaskQ);
-		// showAQ(ActiveTaskQ);
-		//Following error checking code makes sure that the system state is not messed up.
-
-		if (numberOfCores - totalCoreRequirementsOfActiveTasks () != numberOfFreeCores ()) {
-			cout <<"\n[Scheduler] [Error]: Number of Free Cores + Number of Active Tasks Requirements != Number Of Cores.\n";		
-			exit (1);
-		}
-
-		if (numberOfActiveTasks () + numberOfTasksCompleted () + numberOfTasksInQueue () + numberOfTasksWaitingToSchedule () != numberOfTasks) {
-			cout <<"\n[Scheduler] [Error]: Task State Does Not Match.\n";		
-			exit (1);
-		}
+void SchedulerOpen::checkConsistency(SubsecondTime time) {
+	int activeTasks = taskState->getNumberOfTasks (SchedulerTaskState::ACTIVE);
+	int completedTasks = taskState->getNumberOfTasks (SchedulerTaskState::COMPLETED);
+	int queuedTasks = taskState->getNumberOfTasks (SchedulerTaskState::IN_QUEUE);
+	int nonQueuedTasks = taskState->getNumberOfTasks (SchedulerTaskState::WAITING_TO_SCHEDULE);
+	int freeCores = taskState->getNumberOfFreeCores ();
+	int requirements = taskState->getCoreRequirementsOfActiveTasks ();
+
+	std::stringstream details;
+	details << "active=" << activeTasks << " completed=" << completedTasks << " queued=" << queuedTasks << " nonqueued=" << nonQueuedTasks << " freecores=" << freeCores << " requirements=" << requirements;
+	std::stringstream text;
+	text << "\n[Scheduler]: Time " << formatTime(time) << " [Active Tasks =  " << activeTasks << " | Completed Tasks = " <<  completedTasks << " | Queued Tasks = "  << queuedTasks << " | Non-Queued Tasks  = " <<  nonQueuedTasks <<  " | Free Cores = " << freeCores << " | Active Tasks Requirements = " << requirements << " ] \n" << endl;
+	trace->record(time, "status", details.str(), text.str());
+
+	if (numberOfCores - requirements != freeCores) {
+		cout <<"\n[Scheduler] [Error]: Number of Free Cores + Number of Active Tasks Requirements != Number Of Cores.\n";		
+		exit (1);
 	}
 
-	if ((migrationPolicy != NULL) && (time.getNS() % migrationEpoch == 0)) {
-		cout << "\n[Scheduler]: Migration invoked at " << formatTime(time) << endl;
-
-		executeMigrationPolicy(time);
+	if (activeTasks + completedTasks + queuedTasks + nonQueuedTasks != numberOfTasks) {
+		cout <<"\n[Scheduler] [Error]: Task State Does Not Match.\n";		
+		exit (1);
 	}
 
-	if ((dvfsPolicy != NULL) && (time.getNS() % dvfsEpoch == 0)) {
-		cout << "\n[Scheduler]: DVFS Control Loop invoked at " << formatTime(time) << endl;
-        // SP: Debug: show that rvalues are now accessible to the scheduler
-        // cout << "SP: Core 0 rvalue:" << performanceCounters->getRvalueOfCore(0) << endl;
-
-		executeDVFSPolicy();
-
-		std::vector<int> frequencies;
-		for (int coreCounter = 0; coreCounter < numberOfCores; coreCounter++) {
-			frequencies.push_back(Sim()->getMagicServer()->getFrequency(coreCounter));
-		}
+	if (!taskState->isConsistent ()) {
+		cout <<"\n[Scheduler] [Error]: Task and Core Bookkeeping Does Not Match.\n";		
+		exit (1);
 	}
+}
 
-	if (time.getNS () % mappingEpoch == 0) {
-		
-		cout << "\n[Scheduler]: Scheduler Invoked at " << formatTime(time) << "\n" << endl;
-
-		fetchTasksIntoQueue (time);
-				
-
+/** executeMappingEpoch
+    Maps the queued tasks and records the resulting mapping.
+*/
+void SchedulerOpen::executeMappingEpoch(SubsecondTime time) {
+	trace->record(time, "mapping_epoch", "", "\n[Scheduler]: Scheduler Invoked at " + formatTime(time) + "\n\n");
 
-		while (	numberOfTasksInQueue () != 0) {	
-			if (!schedule (taskFrontOfQueue (), false,time)) break; //Scheduler can't map the task in front of queue.
-		}
+	fetchTasksIntoQueue (time);
 
-		cout << "[Scheduler]: Current mapping:" << endl;
+	while (	taskState->getNumberOfTasks (SchedulerTaskState::IN_QUEUE) != 0) {	
+		if (!schedule (taskFrontOfQueue (), false,time)) break; //Scheduler can't map the task in front of queue.
+	}
 
-		for (int y = 0; y < coreRows; y++) {
-			for (int x = 0; x < coreColumns; x++) {
-				if (x > 0) {
-					cout << " ";
+	// one row of the grid per line: task ID per core, *running*, -sleeping-, (reserved), . for unassigned cores
+	std::stringstream details;
+	std::stringstream text;
+	text << "[Scheduler]: Current mapping:" << endl;
+	for (int y = 0; y < coreRows; y++) {
+		std::stringstream row;
+		for (int x = 0; x < coreColumns; x++) {
+			if (x > 0) {
+				row << " ";
+			}
+			int coreId = getCoreNb(y, x);
+			if (!isAssignedToTask(coreId)) {
+				row << "  . ";
+			} else {
+				if (taskState->getCore(coreId).assignedTaskID < 10) {
+					row << " ";
 				}
-				int coreId = getCoreNb(y, x);
-				if (!isAssignedToTask(coreId)) {
-					cout << "  . ";
-				} else {
-					if (systemCores[coreId].assignedTaskID < 10) {
-						cout << " ";
-					}
 
-					char marker1 = '?';
-					char marker2 = '?';
-					if (isAssignedToThread(coreId)) {
-						Core::State state = m_thread_manager->getThreadState(systemCores[coreId].assignedThreadID);
-						if (state == Core::State::RUNNING) {
-							marker1 = '*';
-							marker2 = '*';
-						} else {
-							marker1 = '-';
-							marker2 = '-';
-						}
+				char marker1 = '?';
+				char marker2 = '?';
+				if (isAssignedToThread(coreId)) {
+					Core::State state = m_thread_manager->getThreadState(taskState->getCore(coreId).assignedThreadID);
+					if (state == Core::State::RUNNING) {
+						marker1 = '*';
+						marker2 = '*';
 					} else {
-						marker1 = '(';
-						marker2 = ')';
+						marker1 = '-';
+						marker2 = '-';
 					}
-
-					cout << marker1 << systemCores[coreId].assignedTaskID << marker2;
+				} else {
+					marker1 = '(';
+					marker2 = ')';
 				}
+
+				row << marker1 << taskState->getCore(coreId).assignedTaskID << marker2;
 			}
-			cout << endl;
 		}
+		details << (y > 0 ? " | " : "") << row.str();
+		text << row.str() << endl;
 	}
+	trace->record(time, "mapping", details.str(), text.str());
+}
 
-
-	SubsecondTime delta = time - m_last_periodic;
+/** rescheduleCores
+    Round-robin among the threads of each core whose quantum ran out (and idle cores).
+*/
+void SchedulerOpen::rescheduleCores(SubsecondTime time) {
+	SubsecondTime minQuantumLeft = m_quantum;
+	bool idleCore = false;
 
 	for(core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); ++core_id) {
+		// a quantum handed out since the last check is only charged from when it started
+		SubsecondTime start = std::max(m_last_periodic, quantumStart[core_id]);
+		SubsecondTime delta = time > start ? time - start : SubsecondTime::Zero();
 		if (delta > m_quantum_left[core_id] || m_core_thread_running[core_id] == INVALID_THREAD_ID) {
 		         reschedule(time, core_id, true);
 		}
 		else {
 			m_quantum_left[core_id] -= delta;
 		}
+		if (m_core_thread_running[core_id] != INVALID_THREAD_ID) {
+			minQuantumLeft = std::min(minQuantumLeft, m_quantum_left[core_id]);
+		} else {
+			idleCore = true;
+		}
 	}
 
 	m_last_periodic = time;
+	// an idle core is polled at every barrier, as a thread can arrive or wake up at any time
+	nextQuantumCheck = idleCore ? time : time + minQuantumLeft;
+	reschedulePending = false;
+}
+
+/** reschedule
+    Hands out a new quantum on a core, also in between quantum checks (when a thread stalls, resumes, yields or exits).
+    The quantum counts from now, and may run out before the quantum check that is planned.
+*/
+void SchedulerOpen::reschedule(SubsecondTime time, core_id_t core_id, bool is_periodic) {
+	SchedulerPinnedBase::reschedule(time, core_id, is_periodic);
+	quantumStart[core_id] = time;
+	nextQuantumCheck = std::min(nextQuantumCheck, time + m_quantum);
+}
+
+/** periodic
+    This function is called by Sniper at every barrier (every 100ns by default).
+    Scheduler epochs fire at the first barrier at or after their deadline.
+*/
+void SchedulerOpen::periodic(SubsecondTime time) {
+	int event;
+	while ((event = events.popDue(time)) != -1) {
+		switch (event) {
+		case CONSISTENCY_CHECK:
+			checkConsistency(time);
+			break;
+		case MIGRATION_EPOCH:
+			trace->record(time, "migration_epoch", "", "\n[Scheduler]: Migration invoked at " + formatTime(time) + "\n");
+			executeMigrationPolicy(time);
+			break;
+		case DVFS_EPOCH:
+			trace->record(time, "dvfs_epoch", "", "\n[Scheduler]: DVFS Control Loop invoked at " + formatTime(time) + "\n");
+			executeDVFSPolicy();
+			break;
+		case MAPPING_EPOCH:
+			executeMappingEpoch(time);
+			break;
+		}
+	}
+
+	// a quantum runs out once more than its remaining time has passed since the last check
+	if (time > nextQuantumCheck || reschedulePending) {
+		rescheduleCores(time);
+	}
 }
 
 std::string formatLong(long l) {
@@ -8,8 +8,10 @@
 #define __SCHEDULER_OPEN_H
 
 #include "scheduler_pinned_base.h"
-#include "thermalModel.h"
 #include "performance_counters.h"
+#include "scheduler_event_queue.h"
+#include "scheduler_task_state.h"
+#include "scheduler_trace.h"
 #include "policies/dvfspolicy.h"
 #include "policies/mappingpolicy.h"
 #include "policies/migrationpolicy.h"
@@ -19,6 +21,7 @@ class SchedulerOpen : public SchedulerPinnedBase {
 
 	public:
 		SchedulerOpen (ThreadManager *thread_manager); //This function is the constructor for Open System Scheduler.
+		virtual ~SchedulerOpen();
 		virtual void periodic(SubsecondTime time);
 		virtual void threadSetInitialAffinity(thread_id_t thread_id);
 		virtual bool threadSetAffinity(thread_id_t calling_thread_id, thread_id_t thread_id, size_t cpusetsize, const cpu_set_t *mask);
@@ -28,13 +31,38 @@ class SchedulerOpen : public SchedulerPinnedBase {
 		
 
 	private:
+		String queuePolicy; //Queuing policy of the open system: FIFO or priority.
+		String distribution; //Arrival distribution of the open workload.
+		bool randomPriority; //Whether priorities are assigned randomly or set explicitly.
+		int arrivalRate;
+		int arrivalInterval;
+		int numberOfTasks;
+		int numberOfCores;
 		int coreRows;
 		int coreColumns;
 
+		SchedulerTaskState *taskState;
+		int taskFrontOfQueue();
+		void fetchTasksIntoQueue(SubsecondTime time);
+		void preemptTask(int taskID);
+
+		enum SchedulerEvent { CONSISTENCY_CHECK, MIGRATION_EPOCH, DVFS_EPOCH, MAPPING_EPOCH };
+		SchedulerEventQueue events;
+		SchedulerTrace *trace;
+		void checkConsistency(SubsecondTime time);
+		void executeMappingEpoch(SubsecondTime time);
+
+		// the per-core quanta are only checked when the first one can have run out, or when a reschedule was requested
+		// (while a core is idle, at every barrier so it picks up new or woken threads right away)
+		SubsecondTime nextQuantumCheck;
+		bool reschedulePending;
+		std::vector<SubsecondTime> quantumStart; // per core: when its current quantum was handed out
+		void rescheduleCores(SubsecondTime time);
+		virtual void reschedule(SubsecondTime time, core_id_t core_id, bool is_periodic);
+
 		PerformanceCounters *performanceCounters;
 		MappingPolicy *mappingPolicy = NULL;
 		long mappingEpoch;
-		void initMappingPolicy(String policyName);
 		bool executeMappingPolicy(int taskID, SubsecondTime time);
 		int getCoreNb(int y, int x);
 		bool isAssignedToTask(int coreId);
@@ -42,7 +70,6 @@ class SchedulerOpen : public SchedulerPinnedBase {
 
 		DVFSPolicy *dvfsPolicy = NULL;
 		long dvfsEpoch;
-		void initDVFSPolicy(String policyName);
 		void executeDVFSPolicy();
 		const int maxDVFSPatience = 0;
 		std::vector<int> downscalingPatience; // can be used by the DVFS control loop to delay DVFS downscaling for very little violations
@@ -50,15 +77,13 @@ class SchedulerOpen : public SchedulerPinnedBase {
 		bool delayDVFSTransition(int coreCounter, int oldFrequency, int newFrequency);
 		void DVFSTransitionDelayed(int coreCounter, int oldFrequency, int newFrequency);
 		void DVFSTransitionNotDelayed(int coreCounter);
-		void setFrequency(int coreCounter, int frequency);
-		ThermalModel *thermalModel;
+		int limitFrequency(int coreCounter, int oldFrequency, int frequency);
 		int minFrequency;
 		int maxFrequency;
 		int frequencyStepSize;
 
 		MigrationPolicy *migrationPolicy = NULL;
 		long migrationEpoch;
-		void initMigrationPolicy(String policyName);
 		void executeMigrationPolicy(SubsecondTime time);
 		void migrateThread(thread_id_t thread_id, core_id_t core_id);
 
@@ -80,7 +80,7 @@ class SchedulerPinnedBase : public SchedulerDynamic
       virtual void threadSetInitialAffinity(thread_id_t thread_id) = 0;
 
       core_id_t findFreeCoreForThread(thread_id_t thread_id);
-      void reschedule(SubsecondTime time, core_id_t core_id, bool is_periodic);
+      virtual void reschedule(SubsecondTime time, core_id_t core_id, bool is_periodic);
       void printState();
 };
 
@@ -0,0 +1,330 @@
+#include "scheduler_task_state.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+SchedulerTaskState::SchedulerTaskState(int numberOfCores, bool priorityQueue)
+	: activeCoreRequirements(0),
+	  waitingQueue(tasks, priorityQueue ? queuedBeforeByPriority : queuedBeforeByID),
+	  activeQueue(tasks, preemptedBefore),
+	  freeCoreMask((numberOfCores + 63) / 64, 0),
+	  freeCores(0) {
+	std::fill(taskCounts, taskCounts + NUM_TASK_STATES, 0);
+	for (int coreID = 0; coreID < numberOfCores; coreID++) {
+		cores.push_back(SystemCore(coreID));
+		setFree(coreID, true);
+	}
+}
+
+/** queuedBeforeByPriority
+ * Higher priority first, then earlier arrival.
+ */
+bool SchedulerTaskState::queuedBeforeByPriority(const Task &a, const Task &b) {
+	if (a.priority != b.priority) {
+		return a.priority > b.priority;
+	}
+	if (a.taskArrivalTime != b.taskArrivalTime) {
+		return a.taskArrivalTime < b.taskArrivalTime;
+	}
+	return a.taskID < b.taskID;
+}
+
+/** queuedBeforeByID
+ * FIFO: tasks are numbered in order of arrival.
+ */
+bool SchedulerTaskState::queuedBeforeByID(const Task &a, const Task &b) {
+	return a.taskID < b.taskID;
+}
+
+/** preemptedBefore
+ * Lower priority first, then the later task.
+ */
+bool SchedulerTaskState::preemptedBefore(const Task &a, const Task &b) {
+	if (a.priority != b.priority) {
+		return a.priority < b.priority;
+	}
+	return a.taskID > b.taskID;
+}
+
+int SchedulerTaskState::addTask(String taskName, int taskCoreRequirement) {
+	int taskID = tasks.size();
+	tasks.push_back(Task(taskID, taskName, taskCoreRequirement));
+	taskCores.push_back(std::vector<int>());
+	taskCounts[WAITING_TO_SCHEDULE]++;
+	arrivals.insert(std::make_pair(tasks[taskID].taskArrivalTime, taskID));
+	return taskID;
+}
+
+void SchedulerTaskState::setArrivalTime(int taskID, UInt64 arrivalTime) {
+	Task &task = tasks.at(taskID);
+	if (task.state != WAITING_TO_SCHEDULE) {
+		std::cout << "\n[Scheduler] [Error]: Arrival time of Task " << taskID << " changed after its arrival." << std::endl;
+		exit (1);
+	}
+	arrivals.erase(std::make_pair(task.taskArrivalTime, taskID));
+	task.taskArrivalTime = arrivalTime;
+	arrivals.insert(std::make_pair(task.taskArrivalTime, taskID));
+}
+
+void SchedulerTaskState::setPriority(int taskID, int priority) {
+	Task &task = tasks.at(taskID);
+	if (task.state != WAITING_TO_SCHEDULE) {
+		std::cout << "\n[Scheduler] [Error]: Priority of Task " << taskID << " changed after its arrival." << std::endl;
+		exit (1);
+	}
+	task.priority = priority;
+}
+
+void SchedulerTaskState::shiftArrivalTimes(SInt64 delta) {
+	std::set<std::pair<UInt64, int> > shifted;
+	for (std::set<std::pair<UInt64, int> >::const_iterator it = arrivals.begin(); it != arrivals.end(); ++it) {
+		Task &task = tasks[it->second];
+		task.taskArrivalTime += delta;
+		shifted.insert(shifted.end(), std::make_pair(task.taskArrivalTime, task.taskID));
+	}
+	arrivals.swap(shifted);
+}
+
+/** setTaskState
+ * Move the task between the counters and queues of its old and new state.
+ */
+void SchedulerTaskState::setTaskState(int taskID, TaskState state) {
+	Task &task = tasks.at(taskID);
+	if (task.state == state) {
+		return;
+	}
+
+	switch (task.state) {
+	case WAITING_TO_SCHEDULE:
+		arrivals.erase(std::make_pair(task.taskArrivalTime, taskID));
+		break;
+	case IN_QUEUE:
+		waitingQueue.remove(taskID);
+		break;
+	case ACTIVE:
+		activeQueue.remove(taskID);
+		activeCoreRequirements -= task.taskCoreRequirement;
+		break;
+	default:
+		break;
+	}
+	taskCounts[task.state]--;
+
+	task.state = state;
+
+	taskCounts[task.state]++;
+	switch (task.state) {
+	case WAITING_TO_SCHEDULE:
+		arrivals.insert(std::make_pair(task.taskArrivalTime, taskID));
+		break;
+	case IN_QUEUE:
+		waitingQueue.push(taskID);
+		break;
+	case ACTIVE:
+		activeQueue.push(taskID);
+		activeCoreRequirements += task.taskCoreRequirement;
+		break;
+	default:
+		break;
+	}
+}
+
+int SchedulerTaskState::getCoreOfThread(int threadID) const {
+	if (threadID < 0 || threadID >= (int)threadCores.size()) {
+		return -1;
+	}
+	return threadCores[threadID];
+}
+
+void SchedulerTaskState::setFree(int coreID, bool free) {
+	if (isFree(coreID) == free) {
+		return;
+	}
+	freeCoreMask[coreID / 64] ^= (UInt64)1 << (coreID % 64);
+	freeCores += free ? 1 : -1;
+}
+
+void SchedulerTaskState::assignTask(int coreID, int taskID) {
+	SystemCore &core = cores.at(coreID);
+	if (core.assignedTaskID == taskID) {
+		return;
+	}
+	if (core.assignedTaskID != -1) {
+		assignThread(coreID, -1);
+		std::vector<int> &oldCores = taskCores[core.assignedTaskID];
+		oldCores.erase(std::find(oldCores.begin(), oldCores.end(), coreID));
+	}
+	core.assignedTaskID = taskID;
+	if (taskID != -1) {
+		taskCores.at(taskID).push_back(coreID);
+	}
+	setFree(coreID, taskID == -1);
+}
+
+void SchedulerTaskState::assignThread(int coreID, int threadID) {
+	SystemCore &core = cores.at(coreID);
+	if (core.assignedThreadID == threadID) {
+		return;
+	}
+	if (core.assignedThreadID != -1) {
+		threadCores[core.assignedThreadID] = -1;
+	}
+	if (threadID != -1) {
+		if (core.assignedTaskID == -1) {
+			std::cout << "\n[Scheduler] [Error]: Thread " << threadID << " assigned to Core " << coreID << ", which is assigned to no task." << std::endl;
+			exit (1);
+		}
+		if (threadID >= (int)threadCores.size()) {
+			threadCores.resize(threadID + 16, -1);
+		}
+		// a thread runs on one core at a time
+		if (threadCores[threadID] != -1) {
+			cores[threadCores[threadID]].assignedThreadID = -1;
+		}
+		threadCores[threadID] = coreID;
+	}
+	core.assignedThreadID = threadID;
+}
+
+void SchedulerTaskState::swapCores(int coreA, int coreB) {
+	if (coreA == coreB) {
+		return;
+	}
+	SystemCore &a = cores.at(coreA);
+	SystemCore &b = cores.at(coreB);
+	if (a.assignedTaskID != -1) {
+		std::vector<int> &coresA = taskCores[a.assignedTaskID];
+		*std::find(coresA.begin(), coresA.end(), coreA) = -1;
+	}
+	if (b.assignedTaskID != -1) {
+		std::vector<int> &coresB = taskCores[b.assignedTaskID];
+		*std::find(coresB.begin(), coresB.end(), coreB) = coreA;
+	}
+	if (a.assignedTaskID != -1) {
+		std::vector<int> &coresA = taskCores[a.assignedTaskID];
+		*std::find(coresA.begin(), coresA.end(), -1) = coreB;
+	}
+	std::swap(a.assignedTaskID, b.assignedTaskID);
+	std::swap(a.assignedThreadID, b.assignedThreadID);
+	if (a.assignedThreadID != -1) {
+		threadCores[a.assignedThreadID] = coreA;
+	}
+	if (b.assignedThreadID != -1) {
+		threadCores[b.assignedThreadID] = coreB;
+	}
+	setFree(coreA, a.assignedTaskID == -1);
+	setFree(coreB, b.assignedTaskID == -1);
+}
+
+/** isConsistent
+ * Recount the derived state from scratch, to catch bookkeeping errors.
+ */
+bool SchedulerTaskState::isConsistent() const {
+	int counts[NUM_TASK_STATES] = {0};
+	int requirements = 0;
+	for (unsigned int taskID = 0; taskID < tasks.size(); taskID++) {
+		const Task &task = tasks[taskID];
+		counts[task.state]++;
+		if (task.state == ACTIVE) {
+			requirements += task.taskCoreRequirement;
+		}
+		if ((task.state == WAITING_TO_SCHEDULE) != (arrivals.count(std::make_pair(task.taskArrivalTime, task.taskID)) == 1)
+				|| (task.state == IN_QUEUE) != waitingQueue.contains(taskID)
+				|| (task.state == ACTIVE) != activeQueue.contains(taskID)) {
+			return false;
+		}
+		for (unsigned int i = 0; i < taskCores[taskID].size(); i++) {
+			if (cores[taskCores[taskID][i]].assignedTaskID != (int)taskID) {
+				return false;
+			}
+		}
+	}
+	for (int state = 0; state < NUM_TASK_STATES; state++) {
+		if (counts[state] != taskCounts[state]) {
+			return false;
+		}
+	}
+	if (requirements != activeCoreRequirements) {
+		return false;
+	}
+
+	int free = 0;
+	for (unsigned int coreID = 0; coreID < cores.size(); coreID++) {
+		const SystemCore &core = cores[coreID];
+		if ((core.assignedTaskID == -1) != isFree(coreID)) {
+			return false;
+		}
+		if (core.assignedTaskID == -1) {
+			free++;
+		} else if (std::count(taskCores[core.assignedTaskID].begin(), taskCores[core.assignedTaskID].end(), (int)coreID) != 1) {
+			return false;
+		}
+		if (core.assignedThreadID != -1 && getCoreOfThread(core.assignedThreadID) != (int)coreID) {
+			return false;
+		}
+	}
+	for (unsigned int threadID = 0; threadID < threadCores.size(); threadID++) {
+		if (threadCores[threadID] != -1 && cores[threadCores[threadID]].assignedThreadID != (int)threadID) {
+			return false;
+		}
+	}
+	return free == freeCores && (int)arrivals.size() == taskCounts[WAITING_TO_SCHEDULE]
+		&& waitingQueue.size() == taskCounts[IN_QUEUE] && activeQueue.size() == taskCounts[ACTIVE];
+}
+
+void SchedulerTaskState::TaskQueue::push(int taskID) {
+	if (taskID >= (int)positions.size()) {
+		positions.resize(tasks.size(), -1);
+	}
+	heap.push_back(taskID);
+	positions[taskID] = heap.size() - 1;
+	siftUp(heap.size() - 1);
+}
+
+void SchedulerTaskState::TaskQueue::remove(int taskID) {
+	int position = positions[taskID];
+	int last = heap.back();
+	heap.pop_back();
+	positions[taskID] = -1;
+	if (last != taskID) {
+		place(position, last);
+		siftUp(position);
+		siftDown(positions[last]);
+	}
+}
+
+void SchedulerTaskState::TaskQueue::place(int position, int taskID) {
+	heap[position] = taskID;
+	positions[taskID] = position;
+}
+
+void SchedulerTaskState::TaskQueue::siftUp(int position) {
+	int taskID = heap[position];
+	while (position > 0) {
+		int parent = (position - 1) / 2;
+		if (!before(tasks[taskID], tasks[heap[parent]])) {
+			break;
+		}
+		place(position, heap[parent]);
+		position = parent;
+	}
+	place(position, taskID);
+}
+
+void SchedulerTaskState::TaskQueue::siftDown(int position) {
+	int taskID = heap[position];
+	int size = heap.size();
+	while (2 * position + 1 < size) {
+		int child = 2 * position + 1;
+		if (child + 1 < size && before(tasks[heap[child + 1]], tasks[heap[child]])) {
+			child++;
+		}
+		if (!before(tasks[heap[child]], tasks[taskID])) {
+			break;
+		}
+		place(position, heap[child]);
+		position = child;
+	}
+	place(position, taskID);
+}
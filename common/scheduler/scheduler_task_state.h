@@ -0,0 +1,143 @@
+/**
+ * scheduler_task_state
+ * This header implements the task and core bookkeeping of the open scheduler.
+ */
+
+#ifndef __SCHEDULER_TASK_STATE_H
+#define __SCHEDULER_TASK_STATE_H
+
+#include "fixed_types.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+ * State of the tasks of an open workload and of the cores they are mapped to.
+ * Every state change goes through this class, which keeps the derived state up to date incrementally:
+ * per-state task counters, the summed core requirements of the active tasks, a free-core bitset,
+ * the cores of every task and the core of every thread, the waiting queue and the active tasks
+ * (indexed heaps that support the removal of any task), and the not yet arrived tasks by arrival time.
+ * All queries are O(1), all updates at most O(log(tasks)) or O(cores of the task).
+ */
+class SchedulerTaskState {
+public:
+    enum TaskState { WAITING_TO_SCHEDULE, IN_QUEUE, ACTIVE, COMPLETED, NUM_TASK_STATES };
+
+    struct Task {
+        Task(int taskID, String taskName, int taskCoreRequirement)
+            : taskID(taskID), taskName(taskName), state(WAITING_TO_SCHEDULE), taskCoreRequirement(taskCoreRequirement),
+              taskArrivalTime(0), taskStartTime(0), taskDepartureTime(0), priority(0) {}
+
+        int taskID;
+        String taskName;
+        TaskState state;
+        int taskCoreRequirement;
+        UInt64 taskArrivalTime;
+        UInt64 taskStartTime;
+        UInt64 taskDepartureTime;
+        int priority;
+    };
+
+    struct SystemCore {
+        SystemCore(int coreID) : coreID(coreID), assignedTaskID(-1), assignedThreadID(-1) {}
+
+        int coreID;
+        int assignedTaskID;   // -1 means core assigned to no task
+        int assignedThreadID; // -1 means core assigned to no thread
+    };
+
+    // With priorityQueue, the queue is ordered by priority (highest first, then by arrival time), else by task ID (FIFO).
+    SchedulerTaskState(int numberOfCores, bool priorityQueue);
+
+    /** Tasks */
+    int addTask(String taskName, int taskCoreRequirement);
+    int getNumberOfTasks() const { return tasks.size(); }
+    const Task &getTask(int taskID) const { return tasks.at(taskID); }
+    // Only while the task waits to be scheduled (the arrival time and priority order the queues)
+    void setArrivalTime(int taskID, UInt64 arrivalTime);
+    void setPriority(int taskID, int priority);
+    // Move the arrival time of all tasks waiting to be scheduled
+    void shiftArrivalTimes(SInt64 delta);
+    void setStartTime(int taskID, UInt64 time) { tasks.at(taskID).taskStartTime = time; }
+    void setDepartureTime(int taskID, UInt64 time) { tasks.at(taskID).taskDepartureTime = time; }
+
+    void setTaskState(int taskID, TaskState state);
+    int getNumberOfTasks(TaskState state) const { return taskCounts[state]; }
+    int getCoreRequirementsOfActiveTasks() const { return activeCoreRequirements; }
+
+    // The next task to map, -1 if the queue is empty
+    int getFrontOfQueue() const { return waitingQueue.top(); }
+    // The active task with the lowest priority (the first to be preempted), -1 if there is none
+    int getLowestPriorityActiveTask() const { return activeQueue.top(); }
+    // The task waiting to be scheduled with the earliest arrival time (by task ID if equal), -1 if there is none
+    int getNextArrival() const { return arrivals.empty() ? -1 : arrivals.begin()->second; }
+
+    /** Cores */
+    int getNumberOfCores() const { return cores.size(); }
+    const SystemCore &getCore(int coreID) const { return cores.at(coreID); }
+    int getNumberOfFreeCores() const { return freeCores; }
+    bool isFree(int coreID) const { return (freeCoreMask[coreID / 64] >> (coreID % 64)) & 1; }
+    // Cores assigned to the task, in the order they were assigned
+    const std::vector<int> &getCoresOfTask(int taskID) const { return taskCores.at(taskID); }
+    // The core the thread is assigned to, -1 if none
+    int getCoreOfThread(int threadID) const;
+
+    // Assign the core to a task (-1: release it, together with its thread)
+    void assignTask(int coreID, int taskID);
+    // Assign the core to a thread of its task (-1: release the thread)
+    void assignThread(int coreID, int threadID);
+    // Exchange the tasks and threads of two cores
+    void swapCores(int coreA, int coreB);
+
+    // Recount all derived state from the tasks and cores, return whether it matches
+    bool isConsistent() const;
+
+private:
+    SchedulerTaskState(const SchedulerTaskState &);
+    SchedulerTaskState &operator=(const SchedulerTaskState &);
+
+    typedef bool (*TaskOrder)(const Task &a, const Task &b);
+
+    /** Binary heap of task IDs with the position of every task, so that any task can be removed. */
+    class TaskQueue {
+    public:
+        TaskQueue(const std::vector<Task> &tasks, TaskOrder before) : tasks(tasks), before(before) {}
+        void push(int taskID);
+        void remove(int taskID);
+        bool contains(int taskID) const { return taskID < (int)positions.size() && positions[taskID] != -1; }
+        int top() const { return heap.empty() ? -1 : heap.front(); }
+        int size() const { return heap.size(); }
+
+    private:
+        const std::vector<Task> &tasks;
+        TaskOrder before;
+        std::vector<int> heap;
+        std::vector<int> positions;
+
+        void place(int position, int taskID);
+        void siftUp(int position);
+        void siftDown(int position);
+    };
+
+    static bool queuedBeforeByPriority(const Task &a, const Task &b);
+    static bool queuedBeforeByID(const Task &a, const Task &b);
+    static bool preemptedBefore(const Task &a, const Task &b);
+
+    std::vector<Task> tasks;
+    int taskCounts[NUM_TASK_STATES];
+    int activeCoreRequirements;
+    TaskQueue waitingQueue;
+    TaskQueue activeQueue;
+    std::set<std::pair<UInt64, int> > arrivals;
+
+    std::vector<SystemCore> cores;
+    std::vector<UInt64> freeCoreMask;
+    int freeCores;
+    std::vector<std::vector<int> > taskCores;
+    std::vector<int> threadCores;
+
+    void setFree(int coreID, bool free);
+};
+
+#endif
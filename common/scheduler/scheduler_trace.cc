@@ -0,0 +1,42 @@
+#include "scheduler_trace.h"
+
+#include <iostream>
+
+using namespace std;
+
+SchedulerTrace::SchedulerTrace(std::string fileName, SubsecondTime consoleInterval)
+	: consoleInterval(consoleInterval) {
+	if (fileName != "") {
+		file.open(fileName.c_str());
+		if (!file.is_open()) {
+			cout << "\n[Scheduler] [Error]: Cannot open trace file " << fileName << endl;
+			exit(1);
+		}
+		file << "time_ns\tevent\tdetails" << endl;
+	}
+}
+
+void SchedulerTrace::record(SubsecondTime time, const std::string &event, const std::string &details, const std::string &consoleText) {
+	if (file.is_open()) {
+		file << time.getNS() << '\t' << event << '\t' << details << '\n';
+	}
+
+	std::map<std::string, ConsoleState>::iterator it = console.find(event);
+	if (it == console.end()) {
+		ConsoleState state;
+		state.lastPrinted = time;
+		state.suppressed = 0;
+		console[event] = state;
+	} else if (time - it->second.lastPrinted >= consoleInterval) {
+		it->second.lastPrinted = time;
+	} else {
+		it->second.suppressed++;
+		return;
+	}
+
+	cout << consoleText;
+	if (it != console.end() && it->second.suppressed > 0) {
+		cout << "[Scheduler]: (" << it->second.suppressed << " '" << event << "' records since the last one on the console, see the scheduler trace)" << endl;
+		it->second.suppressed = 0;
+	}
+}
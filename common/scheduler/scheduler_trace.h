@@ -0,0 +1,37 @@
+/**
+ * scheduler_trace
+ * This header implements the trace of the open scheduler epochs.
+ */
+
+#ifndef __SCHEDULER_TRACE_H
+#define __SCHEDULER_TRACE_H
+
+#include "subsecond_time.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+
+/**
+ * Every record is written to the trace file (one line per record: time in ns, event type, details; tab-separated).
+ * On the console, each event type is printed at most once per console interval, with a count of the records
+ * that were suppressed in between.
+ */
+class SchedulerTrace {
+public:
+    SchedulerTrace(std::string fileName, SubsecondTime consoleInterval);
+
+    void record(SubsecondTime time, const std::string &event, const std::string &details, const std::string &consoleText);
+
+private:
+    std::ofstream file;
+    SubsecondTime consoleInterval;
+
+    struct ConsoleState {
+        SubsecondTime lastPrinted;
+        int suppressed;
+    };
+    std::map<std::string, ConsoleState> console;
+};
+
+#endif
@@ -1,6 +1,54 @@
 #include "thermalModel.h"
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <sstream>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/** dot
+ * Return the dot product of two contiguous vectors of length n.
+ */
+inline double dot(const double *a, const double *b, unsigned int n) {
+    unsigned int i = 0;
+    double sum = 0;
+#ifdef __SSE2__
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/** axpy
+ * y += alpha * x for contiguous vectors of length n.
+ */
+inline void axpy(double alpha, const double *x, double *y, unsigned int n) {
+    unsigned int i = 0;
+#ifdef __SSE2__
+    __m128d a = _mm_set1_pd(alpha);
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a, _mm_loadu_pd(x + i))));
+    }
+#endif
+    for (; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+}
 
 ThermalModel::ThermalModel(unsigned int coreRows, unsigned int coreColumns, const String thermalModelFilename, double ambientTemperature, double maxTemperature, double inactivePower, double tdp)
     : ambientTemperature(ambientTemperature), maxTemperature(maxTemperature), inactivePower(inactivePower), tdp(tdp) {
@@ -33,10 +81,32 @@ ThermalModel::ThermalModel(unsigned int coreRows, unsigned int coreColumns, cons
         //height = readDouble(f);
     }
 
-    readDoubleMatrix(f, &BInv, numberThermalNodes, numberThermalNodes);
+    this->numberUnits = numberUnits;
+    readBInv(f, numberThermalNodes);
 
     // remaining file is not read
     f.close();
+
+    BInvTransposed.resize(numberUnits * numberUnits);
+    BInvRowSum.resize(numberUnits);
+    BInvSortedPrefixSum.resize(numberUnits * (numberUnits + 1));
+    std::vector<double> sortedRow(numberUnits);
+    for (unsigned int row = 0; row < numberUnits; row++) {
+        for (unsigned int i = 0; i < numberUnits; i++) {
+            BInvTransposed[i * numberUnits + row] = BInv[row * numberUnits + i];
+        }
+
+        std::copy(&BInv[row * numberUnits], &BInv[row * numberUnits] + numberUnits, sortedRow.begin());
+        std::sort(sortedRow.begin(), sortedRow.end(), std::greater<double>()); // sort descending
+        double *prefixSum = &BInvSortedPrefixSum[row * (numberUnits + 1)];
+        prefixSum[0] = 0;
+        for (unsigned int i = 0; i < numberUnits; i++) {
+            prefixSum[i + 1] = prefixSum[i] + sortedRow[i];
+        }
+        BInvRowSum[row] = prefixSum[numberUnits];
+    }
+    cachedAmtActiveCores = 0;
+    incrementalUpdates = 0;
 }
 
 template<typename T>
@@ -62,20 +132,93 @@ std::string ThermalModel::readLine(std::ifstream &file) const {
     return value;
 }
 
-void ThermalModel::readDoubleMatrix(std::ifstream &file, double ***matrix, unsigned int rows, unsigned int columns) const {
-    (*matrix) = new double*[rows];
-    for (unsigned int r = 0; r < rows; r++) {
-        (*matrix)[r] = new double[columns];
-        for (unsigned int c = 0; c < columns; c++) {
-            (*matrix)[r][c] = readValue<double>(file);
+/** readBInv
+ * Read the numberThermalNodes x numberThermalNodes inverse conductance matrix and keep the part
+ * between the core nodes (the first numberUnits rows and columns), which is all the queries use.
+ */
+void ThermalModel::readBInv(std::ifstream &file, unsigned int numberThermalNodes) {
+    std::vector<double> row(numberThermalNodes);
+    BInv.resize(numberUnits * numberUnits);
+    for (unsigned int r = 0; r < numberUnits; r++) {
+        file.read((char*)&row[0], numberThermalNodes * sizeof(double));
+        if(file.rdstate() != std::stringstream::goodbit){
+            std::cout << "Assertion error in thermal model file: file ended too early." << std::endl;
+            file.close();
+            exit(1);
         }
+        std::copy(row.begin(), row.begin() + numberUnits, &BInv[r * numberUnits]);
     }
 }
 
+/** updateActiveSums
+ * Bring cachedActiveSum up to date with the given active cores. If a single core changed state since the
+ * last query, only its row of BInv (column of BInvTransposed) is added or subtracted. Otherwise, and
+ * periodically to drop the rounding errors of the incremental updates, the sums are recomputed.
+ */
+void ThermalModel::updateActiveSums(const std::vector<bool> &activeCores) const {
+    std::vector<UInt64> activeMask((numberUnits + 63) / 64, 0);
+    int amtActiveCores = 0;
+    for (unsigned int i = 0; i < numberUnits; i++) {
+        if (activeCores[i]) {
+            activeMask[i / 64] |= 1ULL << (i % 64);
+            amtActiveCores++;
+        }
+    }
+
+    int amtChangedCores = 0;
+    int changedCore = -1;
+    if (!cachedActiveSum.empty()) {
+        for (unsigned int w = 0; w < activeMask.size(); w++) {
+            UInt64 changed = activeMask[w] ^ cachedActiveMask[w];
+            if (changed) {
+                amtChangedCores += __builtin_popcountll(changed);
+                changedCore = w * 64 + __builtin_ctzll(changed);
+            }
+        }
+    }
+
+    if (cachedActiveSum.empty() || amtChangedCores > 1 || (amtChangedCores == 1 && incrementalUpdates >= ACTIVE_SUM_RECOMPUTE_INTERVAL)) {
+        std::vector<double> active(numberUnits, 0);
+        for (unsigned int i = 0; i < numberUnits; i++) {
+            active[i] = activeCores[i] ? 1 : 0;
+        }
+        cachedActiveSum.resize(numberUnits);
+        for (unsigned int row = 0; row < numberUnits; row++) {
+            cachedActiveSum[row] = dot(&BInv[row * numberUnits], &active[0], numberUnits);
+        }
+        incrementalUpdates = 0;
+    } else if (amtChangedCores == 1) {
+        double sign = activeCores[changedCore] ? 1 : -1;
+        axpy(sign, &BInvTransposed[changedCore * numberUnits], &cachedActiveSum[0], numberUnits);
+        incrementalUpdates++;
+    }
+
+    cachedActiveMask.swap(activeMask);
+    cachedAmtActiveCores = amtActiveCores;
+}
+
 double ThermalModel::tsp(const std::vector<bool> &activeCores) const {
-    std::vector<double> powerOfInactiveCores(activeCores.size(), inactivePower);
+    if (activeCores.size() != coreRows * coreColumns) {
+        std::cout << "\n[Scheduler][TSP][Error]: Invalid system size: " << activeCores.size() << ", expected " << (coreRows * coreColumns) << "cores." << std::endl;
+		exit (1);
+    }
+
+    updateActiveSums(activeCores);
+
+    int amtActiveCores = cachedAmtActiveCores;
+    double idlePower = (numberUnits - amtActiveCores) * inactivePower;
+    double minTSP = (tdp - idlePower) / amtActiveCores; // TDP constraint
+
+    if (amtActiveCores > 0) {
+        for (unsigned int core = 0; core < numberUnits; core++) {
+            double activeSum = cachedActiveSum[core];
+            double inactiveSum = inactivePower * (BInvRowSum[core] - activeSum);
+            double coreSafePower = (maxTemperature - ambientTemperature - inactiveSum) / activeSum;
+            minTSP = std::min(minTSP, coreSafePower);
+        }
+    }
 
-    return tsp(activeCores, powerOfInactiveCores);
+    return minTSP;
 }
 
 double ThermalModel::tsp(const std::vector<bool> &activeCores, const std::vector<double> &powerOfInactiveCores) const {
@@ -84,29 +227,24 @@ double ThermalModel::tsp(const std::vector<bool> &activeCores, const std::vector
 		exit (1);
     }
 
-    int amtActiveCores = 0;
+    updateActiveSums(activeCores);
+
+    int amtActiveCores = cachedAmtActiveCores;
     double idlePower = 0;
-    for (unsigned int i = 0; i < activeCores.size(); i++) {
-        if (activeCores.at(i)) {
-            amtActiveCores++;
-        } else {
-            idlePower += powerOfInactiveCores.at(i);
+    std::vector<double> inactivePowers(numberUnits, 0);
+    for (unsigned int i = 0; i < numberUnits; i++) {
+        if (!activeCores[i]) {
+            inactivePowers[i] = powerOfInactiveCores.at(i);
+            idlePower += inactivePowers[i];
         }
     }
 
     double minTSP = (tdp - idlePower) / amtActiveCores; // TDP constraint
 
     if (amtActiveCores > 0) {
-        for (unsigned int core = 0; core < activeCores.size(); core++) {
-            double activeSum = 0;
-            double inactiveSum = 0;
-            for (unsigned int i = 0; i < activeCores.size(); i++) {
-                if (activeCores.at(i)) {
-                    activeSum += BInv[core][i];
-                } else {
-                    inactiveSum += powerOfInactiveCores.at(i) * BInv[core][i];
-                }
-            }
+        for (unsigned int core = 0; core < numberUnits; core++) {
+            double activeSum = cachedActiveSum[core];
+            double inactiveSum = dot(&BInv[core * numberUnits], &inactivePowers[0], numberUnits);
             double coreSafePower = (maxTemperature - ambientTemperature - inactiveSum) / activeSum;
             minTSP = std::min(minTSP, coreSafePower);
         }
@@ -121,32 +259,30 @@ std::vector<double> ThermalModel::tspForManyCandidates(const std::vector<bool> &
 		exit (1);
     }
 
-    int amtActiveCores = count(activeCores.begin(), activeCores.end(), true) + 1; // start at one
+    updateActiveSums(activeCores);
+
+    int amtActiveCores = cachedAmtActiveCores + 1; // start at one
 
     double idlePower = (coreRows * coreColumns - amtActiveCores) * inactivePower;
     double tdpConstraint = (tdp - idlePower) / amtActiveCores;
     std::vector<double> tsps(candidates.size(), tdpConstraint);
 
-    if (amtActiveCores > 0) {
-        for (unsigned int core = 0; core < activeCores.size(); core++) {
-            double activeSum = 0;
-            double inactiveSum = 0;
-            for (unsigned int i = 0; i < activeCores.size(); i++) {
-                if (activeCores.at(i)) {
-                    activeSum += BInv[core][i];
-                } else {
-                    inactiveSum += BInv[core][i];
-                }
-            }
+    std::vector<double> inactiveSum(numberUnits);
+    for (unsigned int core = 0; core < numberUnits; core++) {
+        inactiveSum[core] = BInvRowSum[core] - cachedActiveSum[core];
+    }
 
-            for (unsigned int candidateIdx = 0; candidateIdx < candidates.size(); candidateIdx++) {
-                int candidate = candidates.at(candidateIdx);
-                double candActiveSum = activeSum + BInv[core][candidate];
-                double candInactiveSum = inactiveSum - BInv[core][candidate];
-                double coreSafePower = (maxTemperature - ambientTemperature - inactivePower * candInactiveSum) / candActiveSum;
-                tsps.at(candidateIdx) = std::min(tsps.at(candidateIdx), coreSafePower);
-            }
+    // the column of the candidate is all that changes: O(cores) per candidate
+    for (unsigned int candidateIdx = 0; candidateIdx < candidates.size(); candidateIdx++) {
+        const double *candidateColumn = &BInvTransposed[candidates.at(candidateIdx) * numberUnits];
+        double candidateTSP = tsps[candidateIdx];
+        for (unsigned int core = 0; core < numberUnits; core++) {
+            double candActiveSum = cachedActiveSum[core] + candidateColumn[core];
+            double candInactiveSum = inactiveSum[core] - candidateColumn[core];
+            double coreSafePower = (maxTemperature - ambientTemperature - inactivePower * candInactiveSum) / candActiveSum;
+            candidateTSP = std::min(candidateTSP, coreSafePower);
         }
+        tsps[candidateIdx] = candidateTSP;
     }
 
     return tsps;
@@ -157,22 +293,12 @@ double ThermalModel::worstCaseTSP(int amtActiveCores) const {
     double minTSP = (tdp - amtIdleCores * inactivePower) / amtActiveCores; // TDP constraint
 
     if (amtActiveCores > 0) {
-        for (unsigned int core = 0; core < (unsigned int)(coreRows * coreColumns); core++) {
-            std::vector<double> BInvRow(coreRows * coreColumns);
-            for (unsigned int i = 0; i < (unsigned int)(coreRows * coreColumns); i++) {
-                BInvRow.at(i) = BInv[core][i];
-            }
-            std::sort(BInvRow.begin(), BInvRow.end(), std::greater<double>()); // sort descending
-
-            double activeSum = 0;
-            double inactiveSum = 0;
-            for (unsigned int i = 0; i < (unsigned int)(coreRows * coreColumns); i++) {
-                if (i < (unsigned int)amtActiveCores) {
-                    activeSum += BInvRow.at(i);
-                } else {
-                    inactiveSum += BInvRow.at(i) * inactivePower;
-                }
-            }
+        // the hottest cores for a row are the ones with the largest entries, see BInvSortedPrefixSum
+        unsigned int amtHottest = std::min((unsigned int)amtActiveCores, numberUnits);
+        for (unsigned int core = 0; core < numberUnits; core++) {
+            const double *prefixSum = &BInvSortedPrefixSum[core * (numberUnits + 1)];
+            double activeSum = prefixSum[amtHottest];
+            double inactiveSum = (prefixSum[numberUnits] - activeSum) * inactivePower;
 
             double coreSafePower = (maxTemperature - ambientTemperature - inactiveSum) / activeSum;
             minTSP = std::min(minTSP, coreSafePower);
@@ -182,26 +308,87 @@ double ThermalModel::worstCaseTSP(int amtActiveCores) const {
     return minTSP;
 }
 
-void inplaceGauss(std::vector<std::vector<float>> &A, std::vector<float> &b) {
-    unsigned int n = b.size();
-    for (unsigned int row = 0; row < n; row++) {
-        // divide
-        float pivot = A.at(row).at(row);
-        b.at(row) /= pivot;
-        for (unsigned int col = 0; col < n; col++) {
-            A.at(row).at(col) /= pivot;
+/** getFactorization
+ * Return the LU factorization (with partial pivoting, in double precision) of the part of BInv between the
+ * given active cores. Factorizations are cached per set of active cores, which changes far less often than
+ * budgets are queried, so that a query is a forward and a backward substitution.
+ */
+const ThermalModel::LUFactorization &ThermalModel::getFactorization(const std::vector<bool> &activeCores) const {
+    std::vector<UInt64> activeMask((numberUnits + 63) / 64, 0);
+    for (unsigned int i = 0; i < numberUnits; i++) {
+        if (activeCores.at(i)) {
+            activeMask[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+
+    std::map<std::vector<UInt64>, LUFactorization>::const_iterator it = factorizations.find(activeMask);
+    if (it != factorizations.end()) {
+        return it->second;
+    }
+
+    if (factorizations.size() >= maxCachedFactorizations) {
+        factorizations.clear();
+    }
+    LUFactorization &factorization = factorizations[activeMask];
+
+    std::vector<int> &indices = factorization.indices;
+    for (unsigned int i = 0; i < numberUnits; i++) {
+        if (activeCores.at(i)) {
+            indices.push_back(i);
         }
+    }
 
-        // add
-        for (unsigned int row2 = 0; row2 < n; row2++) {
-            if (row != row2) {
-                float factor = A.at(row2).at(row);
-                b.at(row2) -= factor * b.at(row);
-                for (unsigned int col = 0; col < n; col++) {
-                    A.at(row2).at(col) -= factor * A.at(row).at(col);
-                }
+    unsigned int n = indices.size();
+    std::vector<double> &lu = factorization.lu;
+    lu.resize(n * n);
+    for (unsigned int r = 0; r < n; r++) {
+        for (unsigned int c = 0; c < n; c++) {
+            lu[r * n + c] = BInv[indices[r] * numberUnits + indices[c]];
+        }
+    }
+
+    factorization.pivots.resize(n);
+    for (unsigned int col = 0; col < n; col++) {
+        unsigned int pivot = col;
+        for (unsigned int r = col + 1; r < n; r++) {
+            if (fabs(lu[r * n + col]) > fabs(lu[pivot * n + col])) {
+                pivot = r;
             }
         }
+        if (lu[pivot * n + col] == 0) {
+            std::cout << "\n[Scheduler][ThermalModel][Error]: Singular thermal model" << std::endl;
+            exit (1);
+        }
+        factorization.pivots[col] = pivot;
+        if (pivot != col) {
+            std::swap_ranges(&lu[col * n], &lu[col * n] + n, &lu[pivot * n]);
+        }
+
+        for (unsigned int r = col + 1; r < n; r++) {
+            double factor = lu[r * n + col] /= lu[col * n + col];
+            axpy(-factor, lu.data() + col * n + col + 1, lu.data() + r * n + col + 1, n - col - 1);
+        }
+    }
+
+    return factorization;
+}
+
+/** solve
+ * Solve A * x = b in place for the factorized matrix A.
+ */
+void ThermalModel::solve(const LUFactorization &factorization, std::vector<double> &b) const {
+    const std::vector<double> &lu = factorization.lu;
+    unsigned int n = factorization.indices.size();
+
+    for (unsigned int r = 0; r < n; r++) {
+        std::swap(b[r], b[factorization.pivots[r]]);
+    }
+    // L has a unit diagonal
+    for (unsigned int r = 1; r < n; r++) {
+        b[r] -= dot(&lu[r * n], &b[0], r);
+    }
+    for (unsigned int r = n; r-- > 0; ) {
+        b[r] = (b[r] - dot(lu.data() + r * n + r + 1, b.data() + r + 1, n - r - 1)) / lu[r * n + r];
     }
 }
 
@@ -209,48 +396,52 @@ void inplaceGauss(std::vector<std::vector<float>> &A, std::vector<float> &b) {
  * Return a per-core power budget that (if matched by the power consumption) heats every core exactly to the critical temperature.
  */
 std::vector<double> ThermalModel::powerBudgetMaxSteadyState(const std::vector<bool> &activeCores) const {
-    std::vector<int> activeIndices;
-    std::vector<double> inactivePowers(coreRows * coreColumns, 0);
-    for (unsigned int i = 0; i < coreRows * coreColumns; i++) {
-        if (activeCores.at(i)) {
-            activeIndices.push_back(i);
-        } else {
-            inactivePowers.at(i) = inactivePower;
+    const LUFactorization &factorization = getFactorization(activeCores);
+    const std::vector<int> &activeIndices = factorization.indices;
+
+    std::vector<double> inactivePowers(numberUnits, 0);
+    for (unsigned int i = 0; i < numberUnits; i++) {
+        if (!activeCores.at(i)) {
+            inactivePowers[i] = inactivePower;
         }
     }
-    std::vector<float> tInactive = getSteadyState(inactivePowers);
-    std::vector<float> headroomTrunc(activeIndices.size());
+
+    // headroom of the active cores above the temperature caused by the inactive ones
+    std::vector<double> powersTrunc(activeIndices.size());
     for (unsigned int i = 0; i < activeIndices.size(); i++) {
         int index = activeIndices.at(i);
-        headroomTrunc.at(i) = maxTemperature - tInactive.at(index);
+        powersTrunc[i] = maxTemperature - ambientTemperature - dot(&BInv[index * numberUnits], &inactivePowers[0], numberUnits);
     }
 
-    std::vector<float> powersTrunc = headroomTrunc;
-    std::vector<std::vector<float>> BInvTrunc;
-    for (unsigned int i = 0; i < activeIndices.size(); i++) {
-        std::vector<float> row;
-        for (unsigned int j = 0; j < activeIndices.size(); j++) {
-            row.push_back(BInv[activeIndices.at(i)][activeIndices.at(j)]);
-        }
-        BInvTrunc.push_back(row);
-    }
     // now solve BInvTrunc * powersTrunc = headroomTrunc
-    inplaceGauss(BInvTrunc, powersTrunc);
+    solve(factorization, powersTrunc);
 
     std::vector<double> powers(coreRows * coreColumns, inactivePower);
     for (unsigned int i = 0; i < activeIndices.size(); i++) {
-        powers.at(activeIndices.at(i)) = powersTrunc.at(i);
+        powers.at(activeIndices.at(i)) = powersTrunc[i];
     }
 
     return powers;
 }
 
 std::vector<float> ThermalModel::getSteadyState(const std::vector<double> &powers) const {
-    std::vector<float> temperatures(coreRows * coreColumns);
-    for (unsigned int core = 0; core < (unsigned int)(coreRows * coreColumns); core++) {
-        temperatures.at(core) = ambientTemperature;
-        for (unsigned int i = 0; i < (unsigned int)(coreRows * coreColumns); i++) {
-            temperatures.at(core) += powers.at(i) * BInv[core][i];
+    std::vector<float> temperatures(numberUnits);
+    for (unsigned int core = 0; core < numberUnits; core++) {
+        temperatures[core] = ambientTemperature + dot(&BInv[core * numberUnits], &powers.at(0), numberUnits);
+    }
+    return temperatures;
+}
+
+/** getSteadyStates
+ * Batched getSteadyState: the steady-state temperatures for each of the given power vectors.
+ * Every row of BInv is loaded once for the whole batch.
+ */
+std::vector<std::vector<float>> ThermalModel::getSteadyStates(const std::vector<std::vector<double>> &powers) const {
+    std::vector<std::vector<float>> temperatures(powers.size(), std::vector<float>(numberUnits));
+    for (unsigned int core = 0; core < numberUnits; core++) {
+        const double *row = &BInv[core * numberUnits];
+        for (unsigned int p = 0; p < powers.size(); p++) {
+            temperatures[p][core] = ambientTemperature + dot(row, &powers[p].at(0), numberUnits);
         }
     }
     return temperatures;
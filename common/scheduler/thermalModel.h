@@ -4,6 +4,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <vector>
 #include "fixed_types.h"
 
@@ -17,6 +18,7 @@ public:
     double worstCaseTSP(int amtActiveCores) const;
     std::vector<double> powerBudgetMaxSteadyState(const std::vector<bool> &activeCores) const;
     std::vector<float> getSteadyState(const std::vector<double> &powers) const;
+    std::vector<std::vector<float>> getSteadyStates(const std::vector<std::vector<double>> &powers) const;
 
     float getInactivePower() const { return inactivePower; }
 
@@ -27,12 +29,40 @@ private:
     double tdp;
     template<typename T> T readValue(std::ifstream &file) const;
     std::string readLine(std::ifstream &file) const;
-    void readDoubleMatrix(std::ifstream &file, double ***matrix, unsigned int rows, unsigned int columns) const;
+    void readBInv(std::ifstream &file, unsigned int numberThermalNodes);
 
     unsigned int coreRows;
     unsigned int coreColumns;
+    unsigned int numberUnits;
 
-    double **BInv;
+    // core-to-core part of the inverse conductance matrix, contiguous and row-major
+    std::vector<double> BInv;
+    // the same, column-major, to update the active sums of all rows when a core changes state
+    std::vector<double> BInvTransposed;
+    std::vector<double> BInvRowSum;
+    // per row, the sum of its k largest entries at [row * (numberUnits + 1) + k] (for worstCaseTSP)
+    std::vector<double> BInvSortedPrefixSum;
+
+    // active sums (sum of BInv[row][i] over the active cores i) of the last queried set of active cores,
+    // updated incrementally when a single core changed state, and recomputed otherwise or every
+    // ACTIVE_SUM_RECOMPUTE_INTERVAL incremental updates so rounding errors do not accumulate
+    static const unsigned int ACTIVE_SUM_RECOMPUTE_INTERVAL = 64;
+    mutable std::vector<UInt64> cachedActiveMask;
+    mutable std::vector<double> cachedActiveSum;
+    mutable int cachedAmtActiveCores;
+    mutable unsigned int incrementalUpdates;
+    void updateActiveSums(const std::vector<bool> &activeCores) const;
+
+    // LU factorization (row-major, L below and U on and above the diagonal) of BInv restricted to a set of active cores
+    struct LUFactorization {
+        std::vector<int> indices;
+        std::vector<double> lu;
+        std::vector<unsigned int> pivots;
+    };
+    static const unsigned int maxCachedFactorizations = 64;
+    mutable std::map<std::vector<UInt64>, LUFactorization> factorizations;
+    const LUFactorization &getFactorization(const std::vector<bool> &activeCores) const;
+    void solve(const LUFactorization &factorization, std::vector<double> &b) const;
 };
 
 #endif
@@ -3,6 +3,8 @@
 #include "dvfs_manager.h"
 #include "magic_server.h"
 
+#include <algorithm>
+
 
 static const ComponentPeriod * getDomain(SInt64 domain_id, bool allow_global)
 {
@@ -65,10 +67,45 @@ setFrequency(PyObject *self, PyObject *args)
    Py_RETURN_NONE;
 }
 
+static PyObject *
+setFrequencies(PyObject *self, PyObject *args)
+{
+   PyObject *pFrequencies = NULL;
+
+   if (!PyArg_ParseTuple(args, "O", &pFrequencies))
+      return NULL;
+
+   PyObject *pSequence = PySequence_Fast(pFrequencies, "Expected a sequence of frequencies");
+   if (!pSequence)
+      return NULL;
+
+   std::vector<int> freqs_mhz;
+   for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(pSequence); ++i)
+      freqs_mhz.push_back(PyInt_AsLong(PySequence_Fast_GET_ITEM(pSequence, i)));
+   Py_DECREF(pSequence);
+   if (PyErr_Occurred())
+      return NULL;
+
+   if (freqs_mhz.size() != Sim()->getConfig()->getApplicationCores()) {
+      PyErr_SetString(PyExc_ValueError, "Expected one frequency per core");
+      return NULL;
+   }
+   if (*std::min_element(freqs_mhz.begin(), freqs_mhz.end()) < 0) {
+      PyErr_SetString(PyExc_ValueError, "Frequencies cannot be negative");
+      return NULL;
+   }
+
+   // We're running in a hook so we already have the thread lock, call MagicServer directly
+   Sim()->getMagicServer()->setFrequencies(freqs_mhz);
+
+   Py_RETURN_NONE;
+}
+
 
 static PyMethodDef PyDvfsMethods[] = {
    {"get_frequency",  getFrequency, METH_VARARGS, "Get core or global frequency, in MHz."},
    {"set_frequency",  setFrequency, METH_VARARGS, "Set core frequency, in MHz."},
+   {"set_frequencies",  setFrequencies, METH_VARARGS, "Set the frequencies of all cores at once, in MHz."},
    {NULL, NULL, 0, NULL} /* Sentinel */
 };
 
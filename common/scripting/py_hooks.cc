@@ -91,6 +91,16 @@ static SInt64 hookCallbackThreadMigrateType(UInt64 pFunc, UInt64 _argument)
    return hookCallbackResult(pResult);
 }
 
+static SInt64 hookCallbackCpufreqChangeType(UInt64 pFunc, UInt64 _argument)
+{
+   HooksManager::CpufreqChange* argument = (HooksManager::CpufreqChange*)_argument;
+   PyObject *pCores = PyTuple_New(argument->num_cores);
+   for (UInt32 i = 0; i < argument->num_cores; ++i)
+      PyTuple_SetItem(pCores, i, PyInt_FromLong(argument->core_ids[i]));
+   PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(N)", pCores));
+   return hookCallbackResult(pResult);
+}
+
 static SInt64 hookCallbackSyscallEnter(UInt64 pFunc, UInt64 _argument)
 {
    SyscallMdl::HookSyscallEnter* argument = (SyscallMdl::HookSyscallEnter*)_argument;
@@ -174,6 +184,9 @@ registerHook(PyObject *self, PyObject *args)
       case HookType::HOOK_THREAD_MIGRATE:
          Sim()->getHooksManager()->registerHook(type, hookCallbackThreadMigrateType, (UInt64)pFunc);
          break;
+      case HookType::HOOK_CPUFREQ_CHANGE_BATCH:
+         Sim()->getHooksManager()->registerHook(type, hookCallbackCpufreqChangeType, (UInt64)pFunc);
+         break;
       case HookType::HOOK_SYSCALL_ENTER:
          Sim()->getHooksManager()->registerHook(type, hookCallbackSyscallEnter, (UInt64)pFunc);
          break;
@@ -0,0 +1,185 @@
+#include "checkpoint_manager.h"
+#include "simulator.h"
+#include "hooks_manager.h"
+#include "config.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+void CheckpointManager::Section::set(const String &key, const String &value)
+{
+   LOG_ASSERT_ERROR(value != "" && value.find_first_of(" \t\n") == String::npos,
+      "Checkpoint value of %s must be a single word: '%s'", key.c_str(), value.c_str());
+   m_values[key] = value;
+}
+
+void CheckpointManager::Section::set(const String &key, double value)
+{
+   char str[32];
+   snprintf(str, sizeof(str), "%.17g", value);
+   m_values[key] = str;
+}
+
+void CheckpointManager::Section::set(const String &key, const std::vector<double> &values)
+{
+   char str[32];
+   String list;
+   for (UInt32 i = 0; i < values.size(); ++i)
+   {
+      snprintf(str, sizeof(str), "%.17g", values[i]);
+      list += (i ? " " : "") + String(str);
+   }
+   m_values[key] = list;
+}
+
+void CheckpointManager::Section::set(const String &key, const std::vector<String> &values)
+{
+   String list;
+   for (UInt32 i = 0; i < values.size(); ++i)
+   {
+      LOG_ASSERT_ERROR(values[i] != "" && values[i].find_first_of(" \t\n") == String::npos,
+         "Checkpoint value of %s must be a single word: '%s'", key.c_str(), values[i].c_str());
+      list += (i ? " " : "") + values[i];
+   }
+   m_values[key] = list;
+}
+
+String CheckpointManager::Section::getString(const String &key) const
+{
+   std::map<String, String>::const_iterator it = m_values.find(key);
+   LOG_ASSERT_ERROR(it != m_values.end(), "Checkpoint entry %s not found", key.c_str());
+   return it->second;
+}
+
+double CheckpointManager::Section::getFloat(const String &key) const
+{
+   return atof(getString(key).c_str());
+}
+
+std::vector<double> CheckpointManager::Section::getFloatArray(const String &key) const
+{
+   std::vector<double> values;
+   std::istringstream iss(getString(key).c_str());
+   double value;
+   while (iss >> value)
+      values.push_back(value);
+   return values;
+}
+
+std::vector<String> CheckpointManager::Section::getStringArray(const String &key) const
+{
+   std::vector<String> values;
+   std::istringstream iss(getString(key).c_str());
+   std::string value;
+   while (iss >> value)
+      values.push_back(String(value.c_str()));
+   return values;
+}
+
+CheckpointManager::CheckpointManager()
+   : m_save_file(Sim()->getCfg()->getString("checkpoint/save"))
+   , m_save_time(SubsecondTime::NS(Sim()->getCfg()->getInt("checkpoint/save_time")))
+   , m_restore_file(Sim()->getCfg()->getString("checkpoint/restore"))
+   , m_saved(false)
+{
+   // With the McPAT engine, the temperatures live in the HotSpot init file of tools/mcpat.py, outside of the simulator
+   LOG_ASSERT_ERROR((m_save_file == "" && m_restore_file == "") || Sim()->getCfg()->getString("periodic_power/engine") == "native",
+      "Checkpoints need periodic_power/engine = native, the mcpat engine keeps its thermal state outside of the simulator");
+
+   if (m_restore_file != "")
+      restore();
+}
+
+void CheckpointManager::init()
+{
+   // Hooks of the same order are called in the order they were registered: registering last makes the save
+   // run after the ORDER_NOTIFY_POST updates of the components (e.g. the reliability damage sums)
+   if (m_save_file != "")
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, hook_periodic, (UInt64)this, HooksManager::ORDER_NOTIFY_POST);
+}
+
+void CheckpointManager::registerComponent(const String &name, SaveFunc func, UInt64 self)
+{
+   Component component = { name, func, self };
+   m_components.push_back(component);
+}
+
+const CheckpointManager::Section* CheckpointManager::getRestoredSection(const String &name) const
+{
+   std::map<String, Section>::const_iterator it = m_restored.find(name);
+   return it == m_restored.end() ? NULL : &it->second;
+}
+
+String CheckpointManager::getSaveFileName(const String &name) const
+{
+   String file = m_save_file + "." + name;
+   return file[0] == '/' ? file : Sim()->getConfig()->formatOutputFileName(file);
+}
+
+String CheckpointManager::getRestoredFileName(const String &name) const
+{
+   return m_restore_file + "." + name;
+}
+
+void CheckpointManager::periodic(SubsecondTime time)
+{
+   // Registered after all components (see init), so this runs after their periodic updates of this epoch
+   // and the state saved is that of the end of the epoch
+   if (m_saved || time < m_save_time)
+      return;
+
+   save(time);
+   m_saved = true;
+}
+
+void CheckpointManager::save(SubsecondTime time)
+{
+   String filename = m_save_file[0] == '/' ? m_save_file : Sim()->getConfig()->formatOutputFileName(m_save_file);
+   std::ofstream file(filename.c_str());
+   LOG_ASSERT_ERROR(file, "Cannot write checkpoint %s", filename.c_str());
+
+   file << "[checkpoint]\ntime = " << time.getNS() << "\n";
+   for (std::vector<Component>::const_iterator it = m_components.begin(); it != m_components.end(); ++it)
+   {
+      Section section;
+      it->func(it->self, section);
+      file << "\n[" << it->name << "]\n";
+      for (std::map<String, String>::const_iterator value = section.m_values.begin(); value != section.m_values.end(); ++value)
+         file << value->first << " = " << value->second << "\n";
+   }
+
+   printf("[CHECKPOINT] Saved %s at %" PRIu64 " ns\n", filename.c_str(), time.getNS());
+}
+
+void CheckpointManager::restore()
+{
+   std::ifstream file(m_restore_file.c_str());
+   LOG_ASSERT_ERROR(file, "Cannot read checkpoint %s", m_restore_file.c_str());
+
+   Section *section = NULL;
+   std::string line;
+   while (std::getline(file, line))
+   {
+      if (line.empty())
+         continue;
+      if (line[0] == '[')
+      {
+         size_t end = line.find(']');
+         LOG_ASSERT_ERROR(end != std::string::npos, "Invalid section %s in checkpoint %s", line.c_str(), m_restore_file.c_str());
+         section = &m_restored[String(line.substr(1, end - 1).c_str())];
+         continue;
+      }
+
+      size_t separator = line.find(" = ");
+      LOG_ASSERT_ERROR(section && separator != std::string::npos, "Invalid line %s in checkpoint %s", line.c_str(), m_restore_file.c_str());
+      section->m_values[String(line.substr(0, separator).c_str())] = String(line.substr(separator + 3).c_str());
+   }
+
+   const Section *header = getRestoredSection("checkpoint");
+   LOG_ASSERT_ERROR(header, "Checkpoint %s has no [checkpoint] section", m_restore_file.c_str());
+   printf("[CHECKPOINT] Restoring %s, saved at %s ns\n", m_restore_file.c_str(), header->getString("time").c_str());
+}
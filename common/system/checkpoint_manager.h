@@ -0,0 +1,78 @@
+#ifndef __CHECKPOINT_MANAGER_H
+#define __CHECKPOINT_MANAGER_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+#include <map>
+#include <vector>
+
+// Saves the long-lived model state (temperatures, reliability damage sums, DVFS domains, power history)
+// at a chosen simulated time ([checkpoint] save, save_time), and hands it to the components of a later run
+// ([checkpoint] restore), so experiments can share one warm-up instead of each simulating it.
+// Every component owns a named section of key = value lines. It registers a save callback, and looks up its
+// section when it is created. Application and architectural state (threads, caches, the scheduler's tasks, ...)
+// are not part of it: the restored run starts its own workload on a warm chip.
+
+class CheckpointManager
+{
+   public:
+      class Section
+      {
+         public:
+            void set(const String &key, const String &value);
+            void set(const String &key, double value);
+            void set(const String &key, const std::vector<double> &values);
+            void set(const String &key, const std::vector<String> &values);
+
+            bool has(const String &key) const { return m_values.count(key) > 0; }
+            String getString(const String &key) const;
+            double getFloat(const String &key) const;
+            std::vector<double> getFloatArray(const String &key) const;
+            std::vector<String> getStringArray(const String &key) const;
+
+         private:
+            // Values are whitespace-separated lists
+            std::map<String, String> m_values;
+            friend class CheckpointManager;
+      };
+
+      typedef void (*SaveFunc)(UInt64 self, Section &section);
+
+      CheckpointManager();
+      // Start saving: called once all components have been created, so the save runs after their periodic updates
+      void init();
+
+      // Components that save their state into the section 'name'
+      void registerComponent(const String &name, SaveFunc func, UInt64 self);
+      // Section 'name' of the restored checkpoint, NULL if there is none
+      const Section* getRestoredSection(const String &name) const;
+
+      // Side file of a section whose state is written by a library (the HotSpot model), <checkpoint>.<name>
+      String getSaveFileName(const String &name) const;
+      String getRestoredFileName(const String &name) const;
+
+   private:
+      struct Component
+      {
+         String name;
+         SaveFunc func;
+         UInt64 self;
+      };
+
+      const String m_save_file;
+      const SubsecondTime m_save_time;
+      const String m_restore_file;
+      bool m_saved;
+
+      std::vector<Component> m_components;
+      std::map<String, Section> m_restored;
+
+      static SInt64 hook_periodic(UInt64 self, UInt64 time) { ((CheckpointManager*)self)->periodic(*(subsecond_time_t*)&time); return 0; }
+
+      void periodic(SubsecondTime time);
+      void save(SubsecondTime time);
+      void restore();
+};
+
+#endif // __CHECKPOINT_MANAGER_H
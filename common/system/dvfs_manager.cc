@@ -46,6 +46,39 @@ DvfsManager::DvfsManager()
 
    // Allocate global domains for all other non-application processors
    global_domains.resize(DOMAIN_GLOBAL_MAX, core_period);
+
+   // Continue at the frequencies of a checkpoint rather than the configured ones
+   if (const CheckpointManager::Section *section = Sim()->getCheckpointManager()->getRestoredSection("dvfs"))
+      restoreCheckpoint(*section);
+   Sim()->getCheckpointManager()->registerComponent("dvfs", checkpoint_save, (UInt64)this);
+}
+
+static std::vector<double> getFrequencies(const std::vector<ComponentPeriod> &domains)
+{
+   std::vector<double> freqs_in_hz;
+   for (std::vector<ComponentPeriod>::const_iterator it = domains.begin(); it != domains.end(); ++it)
+      freqs_in_hz.push_back(SubsecondTime::SEC().getFS() / it->getPeriod().getFS());
+   return freqs_in_hz;
+}
+
+void DvfsManager::saveCheckpoint(CheckpointManager::Section &section) const
+{
+   section.set("core_domains", getFrequencies(app_proc_domains));
+   section.set("global_domains", getFrequencies(global_domains));
+}
+
+void DvfsManager::restoreCheckpoint(const CheckpointManager::Section &section)
+{
+   std::vector<double> core_freqs = section.getFloatArray("core_domains");
+   std::vector<double> global_freqs = section.getFloatArray("global_domains");
+   LOG_ASSERT_ERROR(core_freqs.size() == app_proc_domains.size() && global_freqs.size() == global_domains.size(),
+      "Checkpoint has %d core and %d global DVFS domains, expected %d and %d",
+      core_freqs.size(), global_freqs.size(), app_proc_domains.size(), global_domains.size());
+
+   for (UInt32 i = 0; i < core_freqs.size(); ++i)
+      app_proc_domains[i] = ComponentPeriod::fromFreqHz(UInt64(core_freqs[i] + .5));
+   for (UInt32 i = 0; i < global_freqs.size(); ++i)
+      global_domains[i] = ComponentPeriod::fromFreqHz(UInt64(global_freqs[i] + .5));
 }
 
 UInt32 DvfsManager::getCoreDomainId(UInt32 core_id)
@@ -96,3 +129,39 @@ void DvfsManager::setCoreDomain(UInt32 core_id, ComponentPeriod new_freq)
       LOG_PRINT_ERROR("Cannot change non-core frequency");
    }
 }
+
+std::vector<UInt32> DvfsManager::setCoreDomains(const std::vector<UInt64> &freqs_in_hz)
+{
+   LOG_ASSERT_ERROR(freqs_in_hz.size() == m_num_app_cores, "Expected %d core frequencies, got %d", m_num_app_cores, freqs_in_hz.size());
+
+   std::vector<UInt64> domain_freqs(m_num_proc_domains, 0);
+   for (UInt32 core_id = 0; core_id < m_num_app_cores; ++core_id)
+      if (freqs_in_hz[core_id])
+         domain_freqs[getCoreDomainId(core_id)] = freqs_in_hz[core_id];
+
+   std::vector<bool> changed(m_num_proc_domains, false);
+   for (UInt32 domain_id = 0; domain_id < m_num_proc_domains; ++domain_id)
+   {
+      if (!domain_freqs[domain_id])
+         continue;
+      ComponentPeriod new_freq = ComponentPeriod::fromFreqHz(domain_freqs[domain_id]);
+      if (new_freq.getPeriod() != app_proc_domains[domain_id].getPeriod())
+      {
+         app_proc_domains[domain_id] = new_freq;
+         changed[domain_id] = true;
+      }
+   }
+
+   std::vector<UInt32> changed_cores;
+   for (UInt32 core_id = 0; core_id < m_num_app_cores; ++core_id)
+   {
+      if (changed[getCoreDomainId(core_id)])
+      {
+         /* queue a fake instruction that will account for the transition latency */
+         PseudoInstruction *i = new DelayInstruction(m_transition_latency, DelayInstruction::DVFS_TRANSITION);
+         Sim()->getCoreManager()->getCoreFromID(core_id)->getPerformanceModel()->queuePseudoInstruction(i);
+         changed_cores.push_back(core_id);
+      }
+   }
+   return changed_cores;
+}
@@ -2,6 +2,7 @@
 #define __DVFS_MANAGER_H
 
 #include "subsecond_time.h"
+#include "checkpoint_manager.h"
 
 #include <vector>
 
@@ -23,8 +24,18 @@ public:
 protected:
    // Make sure all frequency updates pass through the correct path
    void setCoreDomain(UInt32 core_id, ComponentPeriod new_freq);
+   // Change the domains of all application cores at once (frequency in Hz per core, 0 leaves its domain unchanged).
+   // When several cores of a domain request a frequency, the last one wins, as with consecutive setCoreDomain calls.
+   // Every changed domain is updated once, and each of its cores accounts for one transition latency.
+   // Returns the cores whose frequency changed.
+   std::vector<UInt32> setCoreDomains(const std::vector<UInt64> &freqs_in_hz);
    friend class MagicServer;
 private:
+   static void checkpoint_save(UInt64 self, CheckpointManager::Section &section) { ((DvfsManager*)self)->saveCheckpoint(section); }
+   // Domain frequencies in Hz
+   void saveCheckpoint(CheckpointManager::Section &section) const;
+   void restoreCheckpoint(const CheckpointManager::Section &section);
+
    UInt32 m_cores_per_socket;
    SubsecondTime m_transition_latency;
    UInt32 m_num_proc_domains;
@@ -27,6 +27,7 @@ const char* HookType::hook_type_names[] = {
    "HOOK_APPLICATION_ROI_BEGIN",
    "HOOK_APPLICATION_ROI_END",
    "HOOK_SIGUSR1",
+   "HOOK_CPUFREQ_CHANGE_BATCH",
 };
 static_assert(HookType::HOOK_TYPES_MAX == sizeof(HookType::hook_type_names) / sizeof(HookType::hook_type_names[0]),
               "Not enough values in HookType::hook_type_names");
@@ -57,3 +58,9 @@ SInt64 HooksManager::callHooks(HookType::hook_type_t type, UInt64 arg, bool expe
 
    return -1;
 }
+
+bool HooksManager::hasHooks(HookType::hook_type_t type) const
+{
+   std::unordered_map<HookType::hook_type_t, std::vector<HookCallback> >::const_iterator it = m_registry.find(type);
+   return it != m_registry.end() && !it->second.empty();
+}
@@ -38,6 +38,7 @@ public:
       HOOK_APPLICATION_ROI_BEGIN, // none                            ROI begin, always triggers
       HOOK_APPLICATION_ROI_END,   // none                            ROI end, always triggers
       HOOK_SIGUSR1,             // none                              Sniper process received SIGUSR1
+      HOOK_CPUFREQ_CHANGE_BATCH, // HooksManager::CpufreqChange       CPU frequencies were changed at once (MagicServer::setFrequencies)
       HOOK_TYPES_MAX
    };
    static const char* hook_type_names[];
@@ -93,12 +94,17 @@ public:
       core_id_t core_id;      // Core the thread is now running (or INVALID_CORE_ID == -1 for unscheduled)
       subsecond_time_t time;  // Current time
    } ThreadMigrate;
+   typedef struct {
+      UInt32 num_cores;       // Number of cores whose frequency was changed
+      const UInt32 *core_ids; // Their ids, in ascending order
+   } CpufreqChange;
 
    HooksManager();
    void init();
    void fini();
    void registerHook(HookType::hook_type_t type, HookCallbackFunc func, UInt64 argument, HookCallbackOrder order = ORDER_NOTIFY_PRE);
    SInt64 callHooks(HookType::hook_type_t type, UInt64 argument, bool expect_return = false);
+   bool hasHooks(HookType::hook_type_t type) const;
 
 private:
    std::unordered_map<HookType::hook_type_t, std::vector<HookCallback> > m_registry;
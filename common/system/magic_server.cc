@@ -11,6 +11,9 @@
 #include "stats.h"
 #include "timer.h"
 #include "thread.h"
+#include "itostr.h"
+
+#include <algorithm>
 
 MagicServer::MagicServer()
       : m_performance_enabled(false)
@@ -224,6 +227,59 @@ UInt64 MagicServer::setFrequency(UInt64 core_number, UInt64 freq_in_mhz)
    return 0;
 }
 
+UInt64 MagicServer::setFrequencies(const std::vector<int> &freqs_in_mhz)
+{
+   UInt32 num_cores = Sim()->getConfig()->getApplicationCores();
+   if (freqs_in_mhz.size() != num_cores)
+      return 1;
+
+   std::vector<UInt64> freqs_in_hz(num_cores, 0);
+   std::vector<UInt32> broken_cores;
+   for (UInt32 core_number = 0; core_number < num_cores; ++core_number)
+   {
+      LOG_ASSERT_ERROR(freqs_in_mhz[core_number] >= 0, "Invalid frequency %d MHz for core %d", freqs_in_mhz[core_number], core_number);
+      if (freqs_in_mhz[core_number] > 0)
+         freqs_in_hz[core_number] = 1000000 * UInt64(freqs_in_mhz[core_number]);
+      else
+      {
+         Sim()->getThreadManager()->stallThread_async(core_number, ThreadManager::STALL_BROKEN, SubsecondTime::MaxTime());
+         Sim()->getCoreManager()->getCoreFromID(core_number)->setState(Core::BROKEN);
+         broken_cores.push_back(core_number);
+      }
+   }
+
+   std::vector<UInt32> changed_cores = Sim()->getDvfsManager()->setCoreDomains(freqs_in_hz);
+   if (!broken_cores.empty())
+   {
+      changed_cores.insert(changed_cores.end(), broken_cores.begin(), broken_cores.end());
+      std::sort(changed_cores.begin(), changed_cores.end());
+   }
+   if (changed_cores.empty())
+      return 0;
+
+   // One line for all changed domains instead of one per core
+   String domains;
+   UInt32 last_domain = UINT32_MAX;
+   for (std::vector<UInt32>::const_iterator it = changed_cores.begin(); it != changed_cores.end(); ++it)
+   {
+      UInt32 domain = Sim()->getDvfsManager()->getCoreDomainId(*it);
+      if (domain != last_domain)
+         domains += " " + itostr(domain) + ":" + itostr(freqs_in_mhz[*it] ? getFrequency(*it) : 0);
+      last_domain = domain;
+   }
+   printf("[SNIPER] Setting frequency for %zu cores, DVFS domain:MHz%s\n", changed_cores.size(), domains.c_str());
+
+   // First set frequencies, then call hooks so hook scripts can find the new frequencies by querying the DVFS manager
+   HooksManager::CpufreqChange args = { num_cores: UInt32(changed_cores.size()), core_ids: &changed_cores[0] };
+   Sim()->getHooksManager()->callHooks(HookType::HOOK_CPUFREQ_CHANGE_BATCH, (UInt64)&args);
+   // Scripts that only know about single changes still see every core
+   if (Sim()->getHooksManager()->hasHooks(HookType::HOOK_CPUFREQ_CHANGE))
+      for (std::vector<UInt32>::const_iterator it = changed_cores.begin(); it != changed_cores.end(); ++it)
+         Sim()->getHooksManager()->callHooks(HookType::HOOK_CPUFREQ_CHANGE, *it);
+
+   return 0;
+}
+
 UInt64 MagicServer::getFrequency(UInt64 core_number)
 {
    UInt32 num_cores = Sim()->getConfig()->getApplicationCores();
@@ -4,6 +4,8 @@
 #include "fixed_types.h"
 #include "progress.h"
 
+#include <vector>
+
 class MagicServer
 {
    public:
@@ -25,6 +27,9 @@ class MagicServer
       // To be called while holding the thread manager lock
       UInt64 Magic_unlocked(thread_id_t thread_id, core_id_t core_id, UInt64 cmd, UInt64 arg0, UInt64 arg1);
       UInt64 setFrequency(UInt64 core_number, UInt64 freq_in_mhz);
+      // Set the frequencies of all application cores at once (0 MHz breaks a core, as with setFrequency),
+      // with a single HOOK_CPUFREQ_CHANGE_BATCH for the changed cores
+      UInt64 setFrequencies(const std::vector<int> &freqs_in_mhz);
       UInt64 getFrequency(UInt64 core_number);
 
       void enablePerformance();
@@ -16,6 +16,7 @@
 #include "pthread_emu.h"
 #include "trace_manager.h"
 #include "dvfs_manager.h"
+#include "checkpoint_manager.h"
 #include "hooks_manager.h"
 #include "sampling_manager.h"
 #include "fault_injection.h"
@@ -27,6 +28,9 @@
 #include "instruction_tracer.h"
 #include "memory_tracker.h"
 #include "circular_log.h"
+#include "power_thermal_manager.h"
+#include "reliability_manager.h"
+#include "telemetry.h"
 
 #include <sstream>
 
@@ -117,11 +121,15 @@ Simulator::Simulator()
    , m_fastforward_performance_manager(NULL)
    , m_trace_manager(NULL)
    , m_dvfs_manager(NULL)
+   , m_checkpoint_manager(NULL)
    , m_hooks_manager(NULL)
    , m_sampling_manager(NULL)
    , m_faultinjection_manager(NULL)
    , m_rtn_tracer(NULL)
    , m_memory_tracker(NULL)
+   , m_power_thermal_manager(NULL)
+   , m_reliability_manager(NULL)
+   , m_telemetry(NULL)
    , m_running(false)
    , m_inst_mode_output(true)
 {
@@ -139,6 +147,8 @@ void Simulator::start()
    m_sync_server = new SyncServer();
    m_magic_server = new MagicServer();
    m_transport = Transport::create();
+   // Components read their restored state when they are created
+   m_checkpoint_manager = new CheckpointManager();
    m_dvfs_manager = new DvfsManager();
    m_faultinjection_manager = FaultinjectionManager::create();
    m_thread_stats_manager = new ThreadStatsManager();
@@ -149,6 +159,10 @@ void Simulator::start()
    m_sampling_manager = new SamplingManager();
    m_fastforward_performance_manager = FastForwardPerformanceManager::create();
    m_rtn_tracer = RoutineTracer::create();
+   // The scheduler (created by the thread manager) reads the power/thermal telemetry
+   m_telemetry = new Telemetry();
+   m_power_thermal_manager = PowerThermalManager::create();
+   m_reliability_manager = ReliabilityManager::create();
    m_thread_manager = new ThreadManager();
 
    if (Sim()->getCfg()->getBool("traceinput/enabled"))
@@ -168,6 +182,9 @@ void Simulator::start()
    if (m_trace_manager)
       m_trace_manager->init();
 
+   // After all components registered their periodic hooks
+   m_checkpoint_manager->init();
+
    m_sim_thread_manager->spawnSimThreads();
 
    Instruction::initializeStaticInstructionModel();
@@ -239,6 +256,15 @@ Simulator::~Simulator()
    {
       delete m_rtn_tracer;             m_rtn_tracer = NULL;
    }
+   if (m_power_thermal_manager)
+   {
+      delete m_power_thermal_manager;  m_power_thermal_manager = NULL;
+   }
+   if (m_reliability_manager)
+   {
+      delete m_reliability_manager;    m_reliability_manager = NULL;
+   }
+   delete m_telemetry;                 m_telemetry = NULL;
    // Don't remove the trace manager as threads could still be alive even if they are done
    //delete m_trace_manager;             m_trace_manager = NULL;
    delete m_sampling_manager;          m_sampling_manager = NULL;
@@ -252,6 +278,7 @@ Simulator::~Simulator()
    delete m_thread_stats_manager;      m_thread_stats_manager = NULL;
    delete m_core_manager;              m_core_manager = NULL;
    delete m_dvfs_manager;              m_dvfs_manager = NULL;
+   delete m_checkpoint_manager;        m_checkpoint_manager = NULL;
    delete m_magic_server;              m_magic_server = NULL;
    delete m_sync_server;               m_sync_server = NULL;
    delete m_syscall_server;            m_syscall_server = NULL;
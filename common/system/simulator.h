@@ -24,11 +24,15 @@ class ClockSkewMinimizationManager;
 class FastForwardPerformanceManager;
 class TraceManager;
 class DvfsManager;
+class CheckpointManager;
 class SamplingManager;
 class FaultinjectionManager;
 class TagsManager;
 class RoutineTracer;
 class MemoryTracker;
+class PowerThermalManager;
+class ReliabilityManager;
+class Telemetry;
 namespace config { class Config; }
 
 class Simulator
@@ -63,6 +67,7 @@ public:
    StatsManager *getStatsManager() { return m_stats_manager; }
    ThreadStatsManager *getThreadStatsManager() { return m_thread_stats_manager; }
    DvfsManager *getDvfsManager() { return m_dvfs_manager; }
+   CheckpointManager *getCheckpointManager() { return m_checkpoint_manager; }
    HooksManager *getHooksManager() { return m_hooks_manager; }
    SamplingManager *getSamplingManager() { return m_sampling_manager; }
    FaultinjectionManager *getFaultinjectionManager() { return m_faultinjection_manager; }
@@ -70,6 +75,9 @@ public:
    TagsManager *getTagsManager() { return m_tags_manager; }
    RoutineTracer *getRoutineTracer() { return m_rtn_tracer; }
    MemoryTracker *getMemoryTracker() { return m_memory_tracker; }
+   PowerThermalManager *getPowerThermalManager() { return m_power_thermal_manager; }
+   ReliabilityManager *getReliabilityManager() { return m_reliability_manager; }
+   Telemetry *getTelemetry() { return m_telemetry; }
    void setMemoryTracker(MemoryTracker *memory_tracker) { m_memory_tracker = memory_tracker; }
 
    bool isRunning() { return m_running; }
@@ -101,11 +109,15 @@ private:
    FastForwardPerformanceManager *m_fastforward_performance_manager;
    TraceManager *m_trace_manager;
    DvfsManager *m_dvfs_manager;
+   CheckpointManager *m_checkpoint_manager;
    HooksManager *m_hooks_manager;
    SamplingManager *m_sampling_manager;
    FaultinjectionManager *m_faultinjection_manager;
    RoutineTracer *m_rtn_tracer;
    MemoryTracker *m_memory_tracker;
+   PowerThermalManager *m_power_thermal_manager;
+   ReliabilityManager *m_reliability_manager;
+   Telemetry *m_telemetry;
 
    bool m_running;
    bool m_inst_mode_output;
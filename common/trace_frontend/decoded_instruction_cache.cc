@@ -0,0 +1,110 @@
+#include "decoded_instruction_cache.h"
+#include "instruction.h"
+#include "stats.h"
+
+#include <cstring>
+
+DecodedInstructionCache::Key::Key(app_id_t _app_id, const Sift::Instruction &inst)
+   : app_id(_app_id)
+   , isa(inst.isa)
+   , address(inst.sinst->addr)
+   , size(inst.sinst->size)
+{
+   memcpy(data, inst.sinst->data, sizeof(data));
+}
+
+bool DecodedInstructionCache::Key::operator==(const Key &other) const
+{
+   return address == other.address && app_id == other.app_id && isa == other.isa
+      && size == other.size && memcmp(data, other.data, size) == 0;
+}
+
+DecodedInstructionCache::DecodedInstructionCache()
+   : m_front_hits(0)
+   , m_shared_hits(0)
+   , m_misses(0)
+   , m_instructions(0)
+{
+   registerStatsMetric("decode_cache", 0, "front-hits", &m_front_hits);
+   registerStatsMetric("decode_cache", 0, "shared-hits", &m_shared_hits);
+   registerStatsMetric("decode_cache", 0, "misses", &m_misses);
+   registerStatsMetric("decode_cache", 0, "instructions", &m_instructions);
+}
+
+DecodedInstructionCache::~DecodedInstructionCache()
+{
+   // Instruction objects are not deleted, as their micro-ops may still be referenced by the performance models
+   for (UInt32 i = 0; i < NUM_SHARDS; ++i)
+   {
+      for (Map::iterator it = m_shards[i].entries.begin(); it != m_shards[i].entries.end(); ++it)
+      {
+         delete it->second->decoded;
+         delete it->second;
+      }
+   }
+}
+
+const DecodedInstructionCache::Entry* DecodedInstructionCache::find(app_id_t app_id, const Sift::Instruction &inst)
+{
+   Key key(app_id, inst);
+   Shard &shard = m_shards[getShard(key)];
+
+   ScopedReadLock sl(shard.lock);
+   Map::const_iterator it = shard.entries.find(key);
+   if (it == shard.entries.end())
+      return NULL;
+
+   __sync_fetch_and_add(&m_shared_hits, 1);
+   return it->second;
+}
+
+const DecodedInstructionCache::Entry* DecodedInstructionCache::insert(app_id_t app_id, const Sift::Instruction &inst, const dl::DecodedInst *decoded)
+{
+   Key key(app_id, inst);
+   UInt32 index = getShard(key);
+   Shard &shard = m_shards[index];
+
+   ScopedLock sl(shard.lock);
+   std::pair<Map::iterator, bool> res = shard.entries.insert(Map::value_type(key, (Entry*)NULL));
+   if (!res.second)
+   {
+      // Another thread decoded the same instruction in the mean time
+      delete decoded;
+      __sync_fetch_and_add(&m_shared_hits, 1);
+      return res.first->second;
+   }
+
+   Entry *entry = new Entry();
+   entry->decoded = decoded;
+   entry->shard = index;
+   res.first->second = entry;
+   __sync_fetch_and_add(&m_misses, 1);
+   return entry;
+}
+
+Instruction* DecodedInstructionCache::findInstruction(const Entry *entry, IntPtr pa)
+{
+   ScopedReadLock sl(m_shards[entry->shard].lock);
+   for (std::vector<std::pair<IntPtr, Instruction*> >::const_iterator it = entry->instructions.begin(); it != entry->instructions.end(); ++it)
+      if (it->first == pa)
+         return it->second;
+   return NULL;
+}
+
+Instruction* DecodedInstructionCache::insertInstruction(const Entry *entry, IntPtr pa, Instruction *instruction)
+{
+   ScopedLock sl(m_shards[entry->shard].lock);
+   std::vector<std::pair<IntPtr, Instruction*> > &instructions = const_cast<Entry*>(entry)->instructions;
+   for (std::vector<std::pair<IntPtr, Instruction*> >::const_iterator it = instructions.begin(); it != instructions.end(); ++it)
+   {
+      if (it->first == pa)
+      {
+         delete instruction;
+         return it->second;
+      }
+   }
+
+   instructions.push_back(std::make_pair(pa, instruction));
+   __sync_fetch_and_add(&m_instructions, 1);
+   return instruction;
+}
@@ -0,0 +1,91 @@
+#ifndef __DECODED_INSTRUCTION_CACHE_H
+#define __DECODED_INSTRUCTION_CACHE_H
+
+#include "fixed_types.h"
+#include "lock.h"
+#include "sift_reader.h"
+
+#include <decoder.h>
+
+#include <unordered_map>
+#include <vector>
+
+class Instruction;
+
+// Decoded static instructions, shared by all trace threads.
+// The threads of an application run the same code, so an instruction is decoded once per (application, ISA,
+// address) instead of once per thread. The code bytes are part of the key, so an application that is restarted
+// with a different binary does not pick up stale entries. Entries are never removed: the pointers handed out
+// stay valid for the whole simulation, which lets every thread keep them in a small private front cache
+// (see TraceThread::lookupDecodeCache) that does most lookups without touching the shared table.
+
+class DecodedInstructionCache
+{
+   public:
+      class Entry
+      {
+         public:
+            const dl::DecodedInst *decoded;
+         private:
+            // Instruction objects per physical address: va2pa can differ between the threads of an application
+            // (e.g. with the sequential scheduler), and Instruction::getAddress holds the physical address
+            std::vector<std::pair<IntPtr, Instruction*> > instructions;
+            UInt32 shard;
+            friend class DecodedInstructionCache;
+      };
+
+      DecodedInstructionCache();
+      ~DecodedInstructionCache();
+
+      // Entry of an instruction, NULL if it was not yet decoded
+      const Entry* find(app_id_t app_id, const Sift::Instruction &inst);
+      // Add a freshly decoded instruction. If another thread was first, ours is deleted and the existing entry returned
+      const Entry* insert(app_id_t app_id, const Sift::Instruction &inst, const dl::DecodedInst *decoded);
+
+      // Same for the Instruction object of an entry at a physical address
+      Instruction* findInstruction(const Entry *entry, IntPtr pa);
+      Instruction* insertInstruction(const Entry *entry, IntPtr pa, Instruction *instruction);
+
+      // Lookups that were served by the front caches of the threads
+      void addFrontHits(UInt64 hits) { __sync_fetch_and_add(&m_front_hits, hits); }
+
+   private:
+      struct Key
+      {
+         app_id_t app_id;
+         int isa;
+         IntPtr address;
+         uint8_t size;
+         uint8_t data[16];
+
+         Key(app_id_t app_id, const Sift::Instruction &inst);
+         bool operator==(const Key &other) const;
+      };
+
+      struct KeyHash
+      {
+         size_t operator()(const Key &key) const
+         { return std::hash<IntPtr>()(key.address ^ (UInt64(key.app_id) << 48) ^ (UInt64(key.isa) << 56)); }
+      };
+
+      typedef std::unordered_map<Key, Entry*, KeyHash> Map;
+
+      // Inserts only happen the first time an instruction is seen, so each shard is a read-mostly reader/writer lock
+      struct Shard
+      {
+         RwLock lock;
+         Map entries;
+      };
+
+      static const UInt32 NUM_SHARDS = 64;
+      Shard m_shards[NUM_SHARDS];
+
+      UInt64 m_front_hits;
+      UInt64 m_shared_hits;
+      UInt64 m_misses;
+      UInt64 m_instructions;
+
+      UInt32 getShard(const Key &key) const { return (KeyHash()(key) >> 4) % NUM_SHARDS; }
+};
+
+#endif // __DECODED_INSTRUCTION_CACHE_H
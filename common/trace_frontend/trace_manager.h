@@ -5,6 +5,7 @@
 #include "semaphore.h"
 #include "core.h" // for lock_signal_t and mem_op_t
 #include "_thread.h"
+#include "decoded_instruction_cache.h"
 
 #include <vector>
 
@@ -51,6 +52,7 @@ class TraceManager
       std::vector<String> m_tracefiles;
       std::vector<String> m_responsefiles;
       String m_trace_prefix;
+      DecodedInstructionCache m_decoded_instruction_cache;
       Lock m_lock;
 
       String getFifoName(app_id_t app_id, UInt64 thread_num, bool response, bool create);
@@ -76,6 +78,8 @@ class TraceManager
       void endApplication(TraceThread *thread, SubsecondTime time);
       void accessMemory(int core_id, Core::lock_signal_t lock_signal, Core::mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size);
 
+      DecodedInstructionCache* getDecodedInstructionCache() { return &m_decoded_instruction_cache; }
+
       UInt64 getProgressExpect();
       UInt64 getProgressValue();
 };
@@ -43,6 +43,8 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
    , m_address_randomization(Sim()->getCfg()->getBool("traceinput/address_randomization"))
    , m_appid_from_coreid(Sim()->getCfg()->getString("scheduler/type") == "sequential" ? true : false)
    , m_stop(false)
+   , m_decoded_instruction_cache(Sim()->getTraceManager()->getDecodedInstructionCache())
+   , m_decode_cache_hits(0)
    , m_bbv_base(0)
    , m_bbv_count(0)
    , m_bbv_last(0)
@@ -94,6 +96,12 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
       }
    }
 
+   for (UInt32 i = 0; i < DECODE_CACHE_LINES; ++i)
+   {
+      m_decode_cache[i].entry = NULL;
+      m_decode_cache[i].instruction = NULL;
+   }
+
    thread->setVa2paFunc(_va2pa, (UInt64)this);
    
 }
@@ -106,10 +114,7 @@ TraceThread::~TraceThread()
       unlink(m_tracefile.c_str());
       unlink(m_responsefile.c_str());
    }
-   for(std::unordered_map<IntPtr, const dl::DecodedInst *>::iterator i = m_decoder_cache.begin() ; i != m_decoder_cache.end() ; ++i)
-   {
-      delete (*i).second;
-   }
+   m_decoded_instruction_cache->addFrontHits(m_decode_cache_hits);
 }
 
 UInt64 TraceThread::va2pa(UInt64 va, bool *noMapping)
@@ -391,14 +396,46 @@ SubsecondTime TraceThread::getCurrentTime() const
    return m_thread->getCore()->getPerformanceModel()->getElapsedTime();
 }
 
-Instruction* TraceThread::decode(Sift::Instruction &inst)
+TraceThread::DecodeCacheLine& TraceThread::lookupDecodeCache(Sift::Instruction &inst)
+{
+   DecodeCacheLine &line = m_decode_cache[inst.sinst->addr % DECODE_CACHE_LINES];
+   if (line.entry && line.address == inst.sinst->addr && line.isa == inst.isa)
+   {
+      ++m_decode_cache_hits;
+      return line;
+   }
+
+   // Front cache miss: report the hits so far, and get the instruction from the shared cache, decoding it if we are the first
+   m_decoded_instruction_cache->addFrontHits(m_decode_cache_hits);
+   m_decode_cache_hits = 0;
+
+   const DecodedInstructionCache::Entry *entry = m_decoded_instruction_cache->find(m_app_id, inst);
+   if (!entry)
+      entry = m_decoded_instruction_cache->insert(m_app_id, inst, staticDecode(inst));
+
+   line.address = inst.sinst->addr;
+   line.isa = inst.isa;
+   line.entry = entry;
+   line.instruction = NULL;
+   return line;
+}
+
+Instruction* TraceThread::getInstruction(Sift::Instruction &inst, DecodeCacheLine &line)
+{
+   if (!line.instruction)
+   {
+      UInt64 pa = va2pa(inst.sinst->addr);
+      line.instruction = m_decoded_instruction_cache->findInstruction(line.entry, pa);
+      if (!line.instruction)
+         line.instruction = m_decoded_instruction_cache->insertInstruction(line.entry, pa, decode(inst, *line.entry->decoded));
+   }
+   return line.instruction;
+}
+
+Instruction* TraceThread::decode(Sift::Instruction &inst, const dl::DecodedInst &dec_inst)
 {
 
    //printf("PC: %lx Size: %d num_addresses=%d is_branch=%d\n", inst.sinst->addr, inst.sinst->size, inst.num_addresses, inst.is_branch);
-   if (m_decoder_cache.count(inst.sinst->addr) == 0)
-      m_decoder_cache[inst.sinst->addr] = staticDecode(inst);
-   
-   const dl::DecodedInst& dec_inst = *(m_decoder_cache[inst.sinst->addr]);
 
    OperandList list;
 
@@ -538,10 +575,7 @@ const dl::DecodedInst* TraceThread::staticDecode(Sift::Instruction &inst)
 
 void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruction &next_inst, Core *core, bool do_icache_warmup, UInt64 icache_warmup_addr, UInt64 icache_warmup_size)
 {
-   if (m_decoder_cache.count(inst.sinst->addr) == 0)
-      m_decoder_cache[inst.sinst->addr] = staticDecode(inst);
-   
-   const dl::DecodedInst &dec_inst = *(m_decoder_cache[inst.sinst->addr]);
+   const dl::DecodedInst &dec_inst = *lookupDecodeCache(inst).entry->decoded;
 
    // Warmup instruction caches
 
@@ -569,6 +603,12 @@ void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruc
       // Ignore memory-referencing operands in NOP instructions
       if (!dec_inst.is_nop())
       {
+         // Reads, then writes, are sent to the L1-D as one batch so the memory and SMT locks are taken once per instruction
+         Core::MemoryRequest requests[2 * (Sift::MAX_DYNAMIC_ADDRESSES + 1)];
+         UInt32 num_requests = 0;
+         IntPtr atomic_writes[Sift::MAX_DYNAMIC_ADDRESSES + 1];
+         UInt32 num_atomic_writes = 0;
+
          for(uint32_t mem_idx = 0; mem_idx <  Sim()->getDecoder()->num_memory_operands(&dec_inst); ++mem_idx)
          {
             if (Sim()->getDecoder()->op_read_mem(&dec_inst, mem_idx))
@@ -593,14 +633,11 @@ void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruc
                if (no_mapping)
                   continue;
 
-               core->accessMemory(
-                     /*(is_atomic_update) ? Core::LOCK :*/ Core::NONE,
-                     (is_atomic_update) ? Core::READ_EX : Core::READ,
-                     pa,
-                     NULL,
-                     Sim()->getDecoder()->size_mem_op(&dec_inst, mem_idx),
-                     Core::MEM_MODELED_COUNT,
-                     va2pa(inst.sinst->addr));
+               LOG_ASSERT_ERROR(num_requests < sizeof(requests) / sizeof(requests[0]), "Too many memory operands");
+               requests[num_requests].mem_op_type = (is_atomic_update) ? Core::READ_EX : Core::READ;
+               requests[num_requests].address = pa;
+               requests[num_requests].size = Sim()->getDecoder()->size_mem_op(&dec_inst, mem_idx);
+               ++num_requests;
             }
          }
 
@@ -629,18 +666,26 @@ void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruc
                   continue;
 
                if (is_atomic_update)
-                  core->logMemoryHit(false, Core::WRITE, pa, Core::MEM_MODELED_COUNT, va2pa(inst.sinst->addr));
+               {
+                  LOG_ASSERT_ERROR(num_atomic_writes < sizeof(atomic_writes) / sizeof(atomic_writes[0]), "Too many memory operands");
+                  atomic_writes[num_atomic_writes++] = pa;
+               }
                else
-                  core->accessMemory(
-                        /*(is_atomic_update) ? Core::UNLOCK :*/ Core::NONE,
-                        Core::WRITE,
-                        pa,
-                        NULL,
-                        Sim()->getDecoder()->size_mem_op(&dec_inst, mem_idx),
-                        Core::MEM_MODELED_COUNT,
-                        va2pa(inst.sinst->addr));
+               {
+                  LOG_ASSERT_ERROR(num_requests < sizeof(requests) / sizeof(requests[0]), "Too many memory operands");
+                  requests[num_requests].mem_op_type = Core::WRITE;
+                  requests[num_requests].address = pa;
+                  requests[num_requests].size = Sim()->getDecoder()->size_mem_op(&dec_inst, mem_idx);
+                  ++num_requests;
+               }
             }
          }
+
+         core->accessMemoryBatch(requests, num_requests, Core::MEM_MODELED_COUNT, va2pa(inst.sinst->addr));
+
+         // The write of an atomic update hits the line its read just brought in
+         for(UInt32 i = 0; i < num_atomic_writes; ++i)
+            core->logMemoryHit(false, Core::WRITE, atomic_writes[i], Core::MEM_MODELED_COUNT, va2pa(inst.sinst->addr));
       }
    }
 }
@@ -650,12 +695,10 @@ void TraceThread::handleInstructionDetailed(Sift::Instruction &inst, Sift::Instr
 
    // Set up instruction
 
-   if (m_icache.count(inst.sinst->addr) == 0)
-      m_icache[inst.sinst->addr] = decode(inst);
-   // Here get the decoder instruction without checking, because we must have it for sure
-   const dl::DecodedInst &dec_inst = *(m_decoder_cache[inst.sinst->addr]);
+   DecodeCacheLine &line = lookupDecodeCache(inst);
+   const dl::DecodedInst &dec_inst = *line.entry->decoded;
 
-   Instruction *ins = m_icache[inst.sinst->addr];
+   Instruction *ins = getInstruction(inst, line);
    DynamicInstruction *dynins = prfmdl->createDynamicInstruction(ins, va2pa(inst.sinst->addr));
 
    // Add dynamic instruction info
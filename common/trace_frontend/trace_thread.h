@@ -8,6 +8,7 @@
 #include "sift_reader.h"
 #include "operand.h"
 #include "semaphore.h"
+#include "decoded_instruction_cache.h"
 
 #include <decoder.h>
 
@@ -59,11 +60,21 @@ class TraceThread : public Runnable
       bool m_appid_from_coreid;
       uint8_t m_address_randomization_table[256];
       bool m_stop;
-      std::unordered_map<IntPtr, Instruction *> m_icache;
-      //std::unordered_map<IntPtr, const xed_decoded_inst_t *> m_decoder_cache;  // TODO convert to DecoderLib
       //static bool xed_initialized;  // TODO convert to DecoderLib
       //xed_state_t m_xed_state_init;  // TODO convert to DecoderLib
-      std::unordered_map<IntPtr, const dl::DecodedInst *> m_decoder_cache;  // TODO convert to DecoderLib
+
+      // Direct-mapped front cache of the decoded instructions shared by all threads (TraceManager::getDecodedInstructionCache)
+      struct DecodeCacheLine
+      {
+         IntPtr address;
+         int isa;
+         const DecodedInstructionCache::Entry *entry;
+         Instruction *instruction;  //< Created on the first detailed execution from this line
+      };
+      static const UInt32 DECODE_CACHE_LINES = 1024;
+      DecodeCacheLine m_decode_cache[DECODE_CACHE_LINES];
+      DecodedInstructionCache *m_decoded_instruction_cache;
+      UInt64 m_decode_cache_hits;  //< Front cache hits not yet added to the shared statistics
       UInt64 m_bbv_base;
       UInt64 m_bbv_count;
       UInt64 m_bbv_last;
@@ -115,7 +126,9 @@ class TraceThread : public Runnable
       void handleRoutineChangeFunc(Sift::RoutineOpType event, uint64_t eip, uint64_t esp, uint64_t callEip);
       void handleRoutineAnnounceFunc(uint64_t eip, const char *name, const char *imgname, uint64_t offset, uint32_t line, uint32_t column, const char *filename);
 
-      Instruction* decode(Sift::Instruction &inst);
+      DecodeCacheLine& lookupDecodeCache(Sift::Instruction &inst);
+      Instruction* getInstruction(Sift::Instruction &inst, DecodeCacheLine &line);
+      Instruction* decode(Sift::Instruction &inst, const dl::DecodedInst &dec_inst);
       void handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruction &next_inst, Core *core, bool do_icache_warmup, UInt64 icache_warmup_addr, UInt64 icache_warmup_size);
       void handleInstructionDetailed(Sift::Instruction &inst, Sift::Instruction &next_inst, PerformanceModel *prfmdl);
       //void addDetailedMemoryInfo(DynamicInstruction *dynins, Sift::Instruction &inst, const xed_decoded_inst_t &xed_inst, uint32_t mem_idx, Operand::Direction op_type, bool is_pretetch, PerformanceModel *prfmdl);
@@ -391,6 +391,171 @@ double rk4(void *model, double *y, void *p, int n, double *h, double *yout, slop
 	return new_h;
 }
 
+/* 
+ * exact transient solver. the slope functions of both the block and 
+ * the grid model are affine in the temperatures: f(y) = f(0) - M*y, 
+ * where f(0) only depends on the power and the ambient. for a power 
+ * that is constant over an interval dt, the solution is 
+ * y(dt) = phi*y(0) + psi*f(0), with the propagator phi = exp(-M*dt)
+ * and the input matrix psi = (I - phi) * inv(M). both are computed 
+ * once per distinct dt (M is recovered column by column from the 
+ * slope function). after that, a step costs two dense matrix-vector
+ * products instead of a variable number of rk4 stages.
+ */
+
+/* e = exp(a) by scaling and squaring of a taylor series	*/
+#define EXPM_TAYLOR_TERMS	12
+static void matexp(double **e, double **a, int n)
+{
+	int i, j, k, s = 0;
+	double norm = 0, col, scale;
+	double **x = dmatrix(n, n), **t = dmatrix(n, n);
+
+	/* 1-norm	*/
+	for (j = 0; j < n; j++) {
+		col = 0;
+		for (i = 0; i < n; i++)
+			col += fabs(a[i][j]);
+		norm = MAX(norm, col);
+	}
+	/* scale down to a norm of at most 0.5, where 
+	 * the truncation error is below 1e-13
+	 */
+	if (norm > 0.5)
+		s = (int) ceil(log(norm / 0.5) / log(2.0));
+	scale = ldexp(1.0, -s);
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			x[i][j] = a[i][j] * scale;
+
+	/* e = I + x/1 * (I + x/2 * (... * (I + x/K)))	*/
+	zero_dmatrix(e, n, n);
+	for (i = 0; i < n; i++)
+		e[i][i] = 1.0;
+	for (k = EXPM_TAYLOR_TERMS; k >= 1; k--) {
+		matmult(t, x, e, n);
+		for (i = 0; i < n; i++)
+			for (j = 0; j < n; j++)
+				e[i][j] = t[i][j] / k + (i == j ? 1.0 : 0.0);
+	}
+
+	/* exp(a) = exp(a / 2^s) ^ (2^s)	*/
+	for (k = 0; k < s; k++) {
+		matmult(t, e, e, n);
+		copy_dmatrix(e, t, n, n);
+	}
+
+	free_dmatrix(x);
+	free_dmatrix(t);
+}
+
+static void free_expm_step(expm_step_t *step)
+{
+	free_dmatrix(step->phi);
+	free_dmatrix(step->psi);
+	free_dvector(step->f0);
+	free_dvector(step->y0);
+	free(step);
+}
+
+/* the cache is kept in most recently used order	*/
+expm_step_t *get_expm_step(expm_step_t **cache, void *model, void *p, int n, double dt, slope_fn_ptr f)
+{
+	expm_step_t *step, **prev;
+	double **m, **inv;
+	int i, j, count = 0;
+
+	for (prev = cache; *prev; prev = &(*prev)->next, count++)
+		if ((*prev)->n == n && fabs((*prev)->dt - dt) <= DELTA * DELTA * dt) {
+			step = *prev;
+			*prev = step->next;
+			step->next = *cache;
+			*cache = step;
+			return step;
+		}
+
+	if (n > EXPM_MAX_NODES)
+		fatal("too many thermal nodes for the exact transient solver. reduce the grid size or set expm_used to 0\n");
+
+	/* evict the least recently used propagator	*/
+	if (count >= EXPM_MAX_CACHED) {
+		for (prev = cache; (*prev)->next; prev = &(*prev)->next);
+		free_expm_step(*prev);
+		*prev = NULL;
+	}
+
+	step = (expm_step_t *) calloc (1, sizeof(expm_step_t));
+	if (!step)
+		fatal("memory allocation error\n");
+	step->dt = dt;
+	step->n = n;
+	step->phi = dmatrix(n, n);
+	step->psi = dmatrix(n, n);
+	step->f0 = dvector(n);
+	step->y0 = dvector(n);
+
+	/* column j of M is f(0) - f(e_j). the first row 
+	 * of psi serves as the scratch pad for f(e_j)
+	 */
+	m = dmatrix(n, n);
+	zero_dvector(step->y0, n);
+	(*f)(model, step->y0, p, step->f0);
+	for (j = 0; j < n; j++) {
+		step->y0[j] = 1.0;
+		(*f)(model, step->y0, p, step->psi[0]);
+		for (i = 0; i < n; i++)
+			m[i][j] = step->f0[i] - step->psi[0][i];
+		step->y0[j] = 0.0;
+	}
+
+	/* phi = exp(-M*dt)	*/
+	inv = dmatrix(n, n);
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			inv[i][j] = -m[i][j] * dt;
+	matexp(step->phi, inv, n);
+
+	/* psi = (I - phi) * inv(M). matinv overwrites M	*/
+	matinv(inv, m, n, FALSE);
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			m[i][j] = (i == j ? 1.0 : 0.0) - step->phi[i][j];
+	matmult(step->psi, m, inv, n);
+
+	free_dmatrix(m);
+	free_dmatrix(inv);
+
+	step->next = *cache;
+	*cache = step;
+	return step;
+}
+
+/* advance 'y' by the interval of 'step' at the power in 'p'	*/
+void expm_step(expm_step_t *step, void *model, double *y, void *p, slope_fn_ptr f)
+{
+	int i, n = step->n;
+
+	zero_dvector(step->y0, n);
+	(*f)(model, step->y0, p, step->f0);
+
+	copy_dvector(step->y0, y, n);
+	matvectmult(y, step->phi, step->y0, n);
+	matvectmult(step->y0, step->psi, step->f0, n);
+	for (i = 0; i < n; i++)
+		y[i] += step->y0[i];
+}
+
+void free_expm_cache(expm_step_t **cache)
+{
+	expm_step_t *next;
+
+	while (*cache) {
+		next = (*cache)->next;
+		free_expm_step(*cache);
+		*cache = next;
+	}
+}
+
 /* matmult: C = AB, A, B are n x n square matrices	*/
 void matmult(double **c, double **a, double **b, int n) 
 {
@@ -402,13 +567,22 @@ void matmult(double **c, double **a, double **b, int n)
 	dgemm('N', 'N', n, n, n, 1.0, b[0], n, a[0], n, 0.0, c[0], n);
 	#else
 	int i, j, k;
+	double aik;
 
-	for (i = 0; i < n; i++)
-		for (j = 0; j < n; j++) {
+	/* row-wise, so that the inner loop runs over contiguous 
+	 * memory. RC matrices are sparse, skip the zeroes
+	 */
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < n; j++)
 			c[i][j] = 0;
-			for (k = 0; k < n; k++)
-				c[i][j] += a[i][k] * b[k][j];
+		for (k = 0; k < n; k++) {
+			aik = a[i][k];
+			if (aik == 0)
+				continue;
+			for (j = 0; j < n; j++)
+				c[i][j] += aik * b[k][j];
 		}
+	}
 	#endif	
 }
 
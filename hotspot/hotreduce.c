@@ -0,0 +1,176 @@
+/* 
+ * HotReduce builds a reduced-order thermal model of a floorplan
+ * for use by the simulator in place of the full block model. The
+ * RC network is set up exactly like hotspot does, after which only
+ * the modes that matter at the given sampling interval are kept
+ * (see reduced_model.c). Intended for large floorplans, where
+ * stepping the full network at every interval dominates the cost.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "flp.h"
+#include "package.h"
+#include "temperature.h"
+#include "temperature_block.h"
+#include "reduced_model.h"
+#include "util.h"
+#include "hotreduce.h"
+
+void usage(int argc, char **argv)
+{
+	fprintf(stdout, "Usage: %s -f <file> -o <file> [-c <file>] [-d <file>] [options]\n", argv[0]);
+	fprintf(stdout, "Builds a reduced-order block model of a floorplan with a guaranteed error bound.\n");
+	fprintf(stdout, "Options:(may be specified in any order, within \"[]\" means optional)\n");
+	fprintf(stdout, "   -f <file>\tfloorplan input file (e.g. ev6.flp)\n");
+	fprintf(stdout, "   -o <file>\treduced model output file\n");
+	fprintf(stdout, "  [-c <file>]\tinput configuration parameters from file (e.g. hotspot.config)\n");
+	fprintf(stdout, "  [-d <file>]\toutput configuration parameters to file\n");
+	fprintf(stdout, "  [-max_power <W>]\tupper bound on the power of any functional unit (default 10)\n");
+	fprintf(stdout, "  [-tolerance <K>]\terror bound on the unit temperatures at the end of\n");
+	fprintf(stdout, "            \teach sampling interval (default 0.1)\n");
+	fprintf(stdout, "  [options]\tzero or more options of the form \"-<name> <value>\",\n");
+	fprintf(stdout, "           \toverride the options from config file. the bound holds for\n");
+	fprintf(stdout, "           \tintervals of at least \"-sampling_intvl\" seconds\n");
+}
+
+/* 
+ * parse a table of name-value string pairs and add the configuration
+ * parameters to 'config'
+ */
+void global_config_from_strs(global_config_t *config, str_pair *table, int size)
+{
+	int idx;
+	if ((idx = get_str_index(table, size, "f")) >= 0) {
+		if(sscanf(table[idx].value, "%s", config->flp_file) != 1)
+			fatal("invalid format for configuration  parameter flp_file\n");
+	} else {
+		fatal("required parameter flp_file missing. check usage\n");
+	}
+	if ((idx = get_str_index(table, size, "o")) >= 0) {
+		if(sscanf(table[idx].value, "%s", config->rom_file) != 1)
+			fatal("invalid format for configuration  parameter rom_file\n");
+	} else {
+		fatal("required parameter rom_file missing. check usage\n");
+	}
+	if ((idx = get_str_index(table, size, "c")) >= 0) {
+		if(sscanf(table[idx].value, "%s", config->config) != 1)
+			fatal("invalid format for configuration  parameter config\n");
+	} else {
+		strcpy(config->config, NULLFILE);
+	}
+	if ((idx = get_str_index(table, size, "d")) >= 0) {
+		if(sscanf(table[idx].value, "%s", config->dump_config) != 1)
+			fatal("invalid format for configuration  parameter dump_config\n");
+	} else {
+		strcpy(config->dump_config, NULLFILE);
+	}
+	if ((idx = get_str_index(table, size, "max_power")) >= 0) {
+		if(sscanf(table[idx].value, "%lf", &config->max_power) != 1)
+			fatal("invalid format for configuration  parameter max_power\n");
+	} else {
+		config->max_power = 10.0;
+	}
+	if ((idx = get_str_index(table, size, "tolerance")) >= 0) {
+		if(sscanf(table[idx].value, "%lf", &config->tolerance) != 1)
+			fatal("invalid format for configuration  parameter tolerance\n");
+	} else {
+		config->tolerance = 0.1;
+	}
+	if (config->max_power <= 0.0 || config->tolerance <= 0.0)
+		fatal("max_power and tolerance must be positive\n");
+}
+
+/* 
+ * convert config into a table of name-value pairs. returns the no.
+ * of parameters converted
+ */
+int global_config_to_strs(global_config_t *config, str_pair *table, int max_entries)
+{
+	if (max_entries < 6)
+		fatal("not enough entries in table\n");
+
+	sprintf(table[0].name, "f");
+	sprintf(table[1].name, "o");
+	sprintf(table[2].name, "c");
+	sprintf(table[3].name, "d");
+	sprintf(table[4].name, "max_power");
+	sprintf(table[5].name, "tolerance");
+
+	sprintf(table[0].value, "%s", config->flp_file);
+	sprintf(table[1].value, "%s", config->rom_file);
+	sprintf(table[2].value, "%s", config->config);
+	sprintf(table[3].value, "%s", config->dump_config);
+	sprintf(table[4].value, "%lg", config->max_power);
+	sprintf(table[5].value, "%lg", config->tolerance);
+
+	return 6;
+}
+
+int main(int argc, char **argv)
+{
+	flp_t *flp;
+	block_model_t *model;
+	reduced_model_t *rom;
+	thermal_config_t thermal_config;
+	global_config_t global_config;
+	str_pair table[MAX_ENTRIES];
+	int size;
+
+	if (!(argc >= 5 && argc % 2)) {
+		usage(argc, argv);
+		return 1;
+	}
+	
+	size = parse_cmdline(table, MAX_ENTRIES, argc, argv);
+	global_config_from_strs(&global_config, table, size);
+
+	/* read configuration file	*/
+	if (strcmp(global_config.config, NULLFILE))
+		size += read_str_pairs(&table[size], MAX_ENTRIES, global_config.config);
+
+	/* 
+	 * in the str_pair 'table', earlier entries override later ones.
+	 * so, command line options have priority over config file 
+	 */
+	size = str_pairs_remove_duplicates(table, size);
+
+	/* get defaults and modify according to command line / config file	*/
+	thermal_config = default_thermal_config();
+	thermal_config_add_from_strs(&thermal_config, table, size);
+
+	/* dump configuration if specified	*/
+	if (strcmp(global_config.dump_config, NULLFILE)) {
+		size = global_config_to_strs(&global_config, table, MAX_ENTRIES);
+		size += thermal_config_to_strs(&thermal_config, &table[size], MAX_ENTRIES-size);
+		/* prefix the name of the variable with a '-'	*/
+		dump_str_pairs(table, size, global_config.dump_config, "-");
+	}
+
+	if (strcmp(thermal_config.model_type, BLOCK_MODEL_STR))
+		warning("only the block model can be reduced, using it instead\n");
+	/* the reduced model is linear, so the convection resistance is fixed	*/
+	if (thermal_config.package_model_used &&
+		package_model(&thermal_config, table, size, thermal_config.ambient + SMALL_FOR_CONVEC))
+		warning("natural convection is approximated by the convection resistance at ambient temperature\n");
+
+	flp = read_flp(global_config.flp_file, FALSE);
+	model = alloc_block_model(&thermal_config, flp);
+	populate_R_model_block(model, flp);
+	populate_C_model_block(model, flp);
+
+	rom = reduce_block_model(model, thermal_config.sampling_intvl,
+							 global_config.max_power, global_config.tolerance);
+	write_reduced_model(rom, global_config.rom_file);
+
+	fprintf(stdout, "nodes: %d\n", model->n_nodes);
+	fprintf(stdout, "retained modes: %d\n", rom->n_modes);
+	fprintf(stdout, "error bound: %.4f K for intervals of at least %g s and unit powers of at most %g W\n",
+			rom->bound, rom->intvl, rom->max_power);
+
+	delete_reduced_model(rom);
+	delete_block_model(model);
+	free_flp(flp, FALSE);
+
+	return 0;
+}
@@ -0,0 +1,34 @@
+#ifndef __HOTREDUCE_H_
+#define __HOTREDUCE_H_
+
+#include "util.h"
+
+/* global configuration parameters for HotReduce	*/
+typedef struct global_config_t_st
+{
+	/* floorplan input file */
+	char flp_file[STR_SIZE];
+	/* reduced model output file */
+	char rom_file[STR_SIZE];
+	/* input configuration parameters from file	*/
+	char config[STR_SIZE];
+	/* output configuration parameters to file	*/
+	char dump_config[STR_SIZE];
+	/* maximum power of any functional unit (W)	*/
+	double max_power;
+	/* error bound on the unit temperatures (K)	*/
+	double tolerance;
+}global_config_t;
+
+/* 
+ * parse a table of name-value string pairs and add the configuration
+ * parameters to 'config'
+ */
+void global_config_from_strs(global_config_t *config, str_pair *table, int size);
+/* 
+ * convert config into a table of name-value pairs. returns the no.
+ * of parameters converted
+ */
+int global_config_to_strs(global_config_t *config, str_pair *table, int max_entries);
+
+#endif
@@ -352,6 +352,12 @@ int main(int argc, char **argv)
       }
   }
 
+  /* natural convection changes the RC network at every step	*/
+  if (natural && thermal_config.expm_used) {
+      printf("Warning: Natural convection is not supported by the exact transient solver, using rk4 instead...\n");
+      thermal_config.expm_used = 0;
+  }
+
   /* dump configuration if specified	*/
   if (strcmp(global_config.dump_config, NULLFILE)) {
       size = global_config_to_strs(&global_config, table, MAX_ENTRIES);
@@ -0,0 +1,302 @@
+/*
+ * Persistent, in-process HotSpot thermal model. Performs the same
+ * steps as main() in hotspot.c, but keeps the RC model and the
+ * temperatures alive between calls instead of going through the
+ * power trace, temperature trace and init files.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "flp.h"
+#include "package.h"
+#include "temperature.h"
+#include "temperature_block.h"
+#include "temperature_grid.h"
+#include "reduced_model.h"
+#include "util.h"
+#include "hotspot_lib.h"
+
+struct hotspot_thermal_t_st
+{
+	flp_t *flp;
+	RC_model_t *model;
+	/* reduced-order model, used instead of 'flp' and 'model' when set	*/
+	reduced_model_t *rom;
+	/* the model keeps a pointer to its configuration	*/
+	thermal_config_t config;
+	/* configuration table, needed to re-run the natural convection package model	*/
+	str_pair table[MAX_ENTRIES];
+	int size;
+	int natural;
+	/* instantaneous temperature and power values	*/
+	double *temp, *power;
+	/* position of each of the caller's units in the model's vectors	*/
+	int *index;
+	int n_units;
+	/* compute_temp has been called with a non-null 'temp'	*/
+	int started;
+};
+
+hotspot_thermal_t *hotspot_thermal_alloc(const char *config_file, const char *flp_file,
+										 const char *init_file, const char **names, int n_units)
+{
+	hotspot_thermal_t *thermal;
+	char file[STR_SIZE];
+	int i, j, base, count, n = 0;
+
+	thermal = (hotspot_thermal_t *) calloc(1, sizeof(hotspot_thermal_t));
+	if (!thermal)
+		fatal("not enough memory\n");
+
+	/* configuration file, with init_file overridden by the caller	*/
+	if (init_file) {
+		strcpy(thermal->table[0].name, "init_file");
+		strncpy(thermal->table[0].value, init_file, STR_SIZE-1);
+		thermal->size = 1;
+	}
+	strncpy(file, config_file, STR_SIZE-1);
+	file[STR_SIZE-1] = '\0';
+	thermal->size += read_str_pairs(&thermal->table[thermal->size], MAX_ENTRIES-thermal->size, file);
+	thermal->size = str_pairs_remove_duplicates(thermal->table, thermal->size);
+
+	thermal->config = default_thermal_config();
+	thermal_config_add_from_strs(&thermal->config, thermal->table, thermal->size);
+
+	if (thermal->config.package_model_used) {
+		thermal->natural = package_model(&thermal->config, thermal->table, thermal->size,
+										 thermal->config.ambient + SMALL_FOR_CONVEC);
+		if (thermal->config.r_convec < R_CONVEC_LOW || thermal->config.r_convec > R_CONVEC_HIGH)
+			printf("Warning: Heatsink convection resistance is not realistic, double-check your package settings...\n");
+	}
+
+	/* natural convection changes the RC network at every step	*/
+	if (thermal->natural && thermal->config.expm_used) {
+		printf("Warning: Natural convection is not supported by the exact transient solver, using rk4 instead...\n");
+		thermal->config.expm_used = 0;
+	}
+
+	/* build the RC model once	*/
+	strncpy(file, flp_file, STR_SIZE-1);
+	file[STR_SIZE-1] = '\0';
+	thermal->flp = read_flp(file, FALSE);
+	thermal->model = alloc_RC_model(&thermal->config, thermal->flp, FALSE);
+	populate_R_model(thermal->model, thermal->flp);
+	populate_C_model(thermal->model, thermal->flp);
+
+	thermal->temp = hotspot_vector(thermal->model);
+	thermal->power = hotspot_vector(thermal->model);
+
+	/* initial temperatures	*/
+	if (strcmp(thermal->model->config->init_file, NULLFILE))
+		read_temp(thermal->model, thermal->temp, thermal->model->config->init_file,
+				  thermal->model->config->dtm_used);
+	else
+		set_temp(thermal->model, thermal->temp, thermal->model->config->init_temp);
+
+	/* map the caller's unit order onto the floorplan order	*/
+	if (thermal->model->type == BLOCK_MODEL)
+		n = thermal->model->block->flp->n_units;
+	else
+		for(i=0; i < thermal->model->grid->n_layers; i++)
+			if (thermal->model->grid->layers[i].has_power)
+				n += thermal->model->grid->layers[i].flp->n_units;
+	if (n != n_units)
+		fatal("no. of units in floorplan and power vector differ\n");
+
+	thermal->n_units = n_units;
+	thermal->index = ivector(n_units);
+	if (thermal->model->type == BLOCK_MODEL)
+		for(i=0; i < n_units; i++)
+			thermal->index[i] = get_blk_index(thermal->flp, (char *) names[i]);
+	else
+		for(i=0, base=0, count=0; i < thermal->model->grid->n_layers; i++) {
+			if(thermal->model->grid->layers[i].has_power) {
+				for(j=0; j < thermal->model->grid->layers[i].flp->n_units; j++)
+					thermal->index[count+j] = base + get_blk_index(thermal->model->grid->layers[i].flp,
+																   (char *) names[count+j]);
+				count += thermal->model->grid->layers[i].flp->n_units;
+			}
+			base += thermal->model->grid->layers[i].flp->n_units;
+		}
+
+	return thermal;
+}
+
+hotspot_thermal_t *hotspot_thermal_alloc_reduced(const char *rom_file, const char **names, int n_units)
+{
+	hotspot_thermal_t *thermal;
+	char file[STR_SIZE];
+	int i;
+
+	thermal = (hotspot_thermal_t *) calloc(1, sizeof(hotspot_thermal_t));
+	if (!thermal)
+		fatal("not enough memory\n");
+
+	strncpy(file, rom_file, STR_SIZE-1);
+	file[STR_SIZE-1] = '\0';
+	thermal->rom = read_reduced_model(file);
+	if (thermal->rom->n_units != n_units)
+		fatal("no. of units in reduced model and power vector differ\n");
+
+	thermal->temp = dvector(n_units);
+	thermal->power = dvector(n_units);
+	for(i=0; i < n_units; i++)
+		thermal->temp[i] = thermal->rom->init_temp;
+
+	/* map the caller's unit order onto the model's order	*/
+	thermal->n_units = n_units;
+	thermal->index = ivector(n_units);
+	for(i=0; i < n_units; i++)
+		if ((thermal->index[i] = get_reduced_index(thermal->rom, (char *) names[i])) < 0) {
+			snprintf(file, sizeof(file), "unit %s not found in reduced model\n", names[i]);
+			fatal(file);
+		}
+
+	return thermal;
+}
+
+void hotspot_thermal_free(hotspot_thermal_t *thermal)
+{
+	if (thermal->rom)
+		delete_reduced_model(thermal->rom);
+	else {
+		delete_RC_model(thermal->model);
+		free_flp(thermal->flp, FALSE);
+	}
+	free_dvector(thermal->temp);
+	free_dvector(thermal->power);
+	free_ivector(thermal->index);
+	free(thermal);
+}
+
+void hotspot_thermal_step(hotspot_thermal_t *thermal, const double *power,
+						  double time_elapsed, double *temp)
+{
+	int i;
+
+	for(i=0; i < thermal->n_units; i++)
+		thermal->power[thermal->index[i]] = power[i];
+
+	if (thermal->rom) {
+		compute_temp_reduced(thermal->rom, thermal->power, thermal->temp, time_elapsed);
+		if (temp)
+			hotspot_thermal_get_temp(thermal, temp);
+		return;
+	}
+
+	/* if natural convection is considered, update transient convection resistance first */
+	if (thermal->natural) {
+		thermal->natural = package_model(thermal->model->config, thermal->table, thermal->size,
+										 calc_sink_temp(thermal->model, thermal->temp));
+		populate_R_model(thermal->model, thermal->flp);
+	}
+
+	/* for the grid model, only the first call passes 'temp' so that
+	 * the internal grid temperatures are carried over between calls
+	 */
+	if (thermal->model->type == BLOCK_MODEL || !thermal->started)
+		compute_temp(thermal->model, thermal->power, thermal->temp, time_elapsed);
+	else
+		compute_temp(thermal->model, thermal->power, NULL, time_elapsed);
+	thermal->started = TRUE;
+
+	if (temp)
+		hotspot_thermal_get_temp(thermal, temp);
+}
+
+void hotspot_thermal_get_temp(hotspot_thermal_t *thermal, double *temp)
+{
+	int i;
+
+	for(i=0; i < thermal->n_units; i++)
+		temp[i] = thermal->temp[thermal->index[i]];
+}
+
+void hotspot_thermal_dump(hotspot_thermal_t *thermal, const char *file)
+{
+	char name[STR_SIZE];
+	int i;
+	FILE *fp;
+
+	/* the reduced model only knows the unit temperatures	*/
+	if (thermal->rom) {
+		if (!(fp = fopen(file, "w"))) {
+			snprintf(name, sizeof(name), "error opening %s\n", file);
+			fatal(name);
+		}
+		for(i=0; i < thermal->rom->n_units; i++)
+			fprintf(fp, "%s\t%.2f\n", thermal->rom->names[i], thermal->temp[i]);
+		fclose(fp);
+		return;
+	}
+
+	strncpy(name, file, STR_SIZE-1);
+	name[STR_SIZE-1] = '\0';
+	dump_temp(thermal->model, thermal->temp, name);
+}
+
+void hotspot_thermal_save(hotspot_thermal_t *thermal, const char *file)
+{
+	char str[STR_SIZE];
+	int i;
+	FILE *fp;
+
+	if (!thermal->rom) {
+		hotspot_thermal_dump(thermal, file);
+		return;
+	}
+
+	if (!(fp = fopen(file, "w"))) {
+		snprintf(str, sizeof(str), "error opening %s\n", file);
+		fatal(str);
+	}
+	for(i=0; i < thermal->rom->n_units; i++)
+		fprintf(fp, "%s\t%.17g\n", thermal->rom->names[i], thermal->temp[i]);
+	for(i=0; i < thermal->rom->n_modes; i++)
+		fprintf(fp, "mode_%d\t%.17g\n", i, thermal->rom->q[i]);
+	fclose(fp);
+}
+
+void hotspot_thermal_restore(hotspot_thermal_t *thermal, const char *file)
+{
+	char str[STR_SIZE], name[STR_SIZE];
+	double val;
+	int i, n = 0;
+	FILE *fp;
+
+	if (!thermal->rom) {
+		strncpy(name, file, STR_SIZE-1);
+		name[STR_SIZE-1] = '\0';
+		read_temp(thermal->model, thermal->temp, name, FALSE);
+		/* the grid model has to translate the restored temperatures afresh	*/
+		thermal->started = FALSE;
+		return;
+	}
+
+	if (!(fp = fopen(file, "r"))) {
+		snprintf(str, sizeof(str), "error opening %s\n", file);
+		fatal(str);
+	}
+	while (fgets(str, STR_SIZE, fp)) {
+		if (sscanf(str, "%s%lf", name, &val) != 2)
+			continue;
+		if (sscanf(name, "mode_%d", &i) == 1 && i >= 0 && i < thermal->rom->n_modes)
+			thermal->rom->q[i] = val;
+		else if ((i = get_reduced_index(thermal->rom, name)) >= 0)
+			thermal->temp[i] = val;
+		else {
+			/* room for the entry name and the message around it	*/
+			char msg[2*STR_SIZE];
+			snprintf(msg, sizeof(msg), "unknown entry %s in %s\n", name, file);
+			fatal(msg);
+		}
+		n++;
+	}
+	fclose(fp);
+	if (n != thermal->rom->n_units + thermal->rom->n_modes) {
+		snprintf(str, sizeof(str), "%s does not match the reduced model\n", file);
+		fatal(str);
+	}
+}
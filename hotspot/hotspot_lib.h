@@ -0,0 +1,68 @@
+#ifndef __HOTSPOT_LIB_H_
+#define __HOTSPOT_LIB_H_
+
+/*
+ * Library interface to HotSpot for use from inside a simulator.
+ * Unlike the hotspot binary, which re-reads the floorplan and
+ * configuration, rebuilds the RC model and restores the temperatures
+ * from an init file on every invocation, a hotspot_thermal_t keeps
+ * the model and the (block and internal grid) temperatures in memory
+ * across calls, so each interval is a single compute_temp.
+ *
+ * Only this header should be included by the simulator: the internal
+ * HotSpot headers clash with names used elsewhere (util.h, TRUE, MAX...).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hotspot_thermal_t_st hotspot_thermal_t;
+
+/*
+ * build the thermal model once. 'config_file' is a HotSpot configuration
+ * file (e.g. hotspot.config), 'flp_file' the floorplan. 'init_file' holds
+ * initial temperatures in the format of the hotspot binary's stdout, or is
+ * NULL to use the init_file/init_temp settings of the configuration.
+ * 'names' lists the 'n_units' functional units in the order in which power
+ * values are passed to and temperatures are returned from hotspot_thermal_step.
+ */
+hotspot_thermal_t *hotspot_thermal_alloc(const char *config_file, const char *flp_file,
+										 const char *init_file, const char **names, int n_units);
+/*
+ * same, but for a reduced-order model built by hotreduce. the initial
+ * temperature is that of the configuration the model was built from
+ */
+hotspot_thermal_t *hotspot_thermal_alloc_reduced(const char *rom_file, const char **names, int n_units);
+void hotspot_thermal_free(hotspot_thermal_t *thermal);
+
+/*
+ * advance the model by 'time_elapsed' seconds during which the units
+ * dissipated 'power' (in W). the resulting temperatures (in Kelvin) are
+ * written to 'temp'. both arrays are in the order of 'names' above.
+ */
+void hotspot_thermal_step(hotspot_thermal_t *thermal, const double *power,
+						  double time_elapsed, double *temp);
+
+/* current temperatures (in Kelvin), in the order of 'names'	*/
+void hotspot_thermal_get_temp(hotspot_thermal_t *thermal, double *temp);
+
+/*
+ * dump the complete model state in the format read by 'init_file'.
+ * reduced models only dump the unit temperatures
+ */
+void hotspot_thermal_dump(hotspot_thermal_t *thermal, const char *file);
+
+/*
+ * save the model state to 'file' and restore it, to continue a run from
+ * a checkpoint. unlike hotspot_thermal_dump, reduced models also save
+ * their modal coordinates, so the restored model continues exactly
+ */
+void hotspot_thermal_save(hotspot_thermal_t *thermal, const char *file);
+void hotspot_thermal_restore(hotspot_thermal_t *thermal, const char *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
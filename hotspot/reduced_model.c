@@ -0,0 +1,535 @@
+/*
+ * Reduced-order block model by modal truncation with static correction.
+ *
+ * With theta = T - ambient, the block model is C theta' = -B theta + P,
+ * where B (model->b) is the symmetric conductance matrix, C (model->a) the
+ * diagonal capacitance matrix and P is non-zero only at the silicon nodes
+ * of the functional units (the ambient term cancels against the row sums
+ * of B). S = C^-1/2 B C^-1/2 is symmetric positive definite, so with
+ * S = Q diag(lambda) Q^T and q = Q^T C^1/2 theta the network decouples into
+ *
+ *	q_k' = -lambda_k q_k + w_k^T P,		theta_units = sum_k w_k q_k
+ *
+ * where w_k holds mode k of Q scaled by C^-1/2 at the unit nodes. For
+ * constant power over an interval dt each mode is integrated exactly:
+ *
+ *	q_k += (1 - exp(-lambda_k dt)) * (w_k^T P / lambda_k - q_k)
+ *
+ * Modes that are not retained are replaced by their steady state
+ * w_k w_k^T P / lambda_k, which is summed into a unit x unit matrix D.
+ * The steady state of the reduced model is therefore exact.
+ *
+ * Error bound: for a truncated mode with alpha_k = exp(-lambda_k intvl)
+ * and |P_j| <= max_power, |w_k^T P| <= U_k = max_power * sum_j |w_k(j)|.
+ * As long as the exact q_k stays within U_k / lambda_k (which holds when
+ * starting from a steady state), the difference between the exact q_k
+ * and its steady state at the end of an interval is at most
+ * 2 alpha_k U_k / lambda_k. The error at unit i is hence bounded by
+ *
+ *	sum_{k truncated} 2 alpha_k U_k |w_k(i)| / lambda_k
+ *
+ * at the end of every interval of at least 'intvl' seconds. Fast modes
+ * have alpha_k ~ 0, so few modes are needed for sampling intervals that
+ * are long compared to the smallest thermal time constants.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "reduced_model.h"
+#include "temperature_block.h"
+#include "flp.h"
+#include "util.h"
+
+/*
+ * eigenvalues and eigenvectors of a symmetric matrix: Householder reduction
+ * to tridiagonal form followed by the implicit QL method (the EISPACK
+ * tred2 and tql2 routines). tred2 replaces the symmetric matrix 'v' with the
+ * transpose of the orthogonal transformation and leaves the tridiagonal
+ * matrix in 'd' and 'e'. working on the transpose makes the inner loops
+ * run along rows, which matters for floorplans with thousands of nodes
+ */
+static void tred2(double **v, int n, double *d, double *e)
+{
+	int i, j, k;
+	double f, g, h, hh, scale;
+
+	for(j=0; j < n; j++)
+		d[j] = v[j][n-1];
+
+	for(i=n-1; i > 0; i--) {
+		scale = 0.0;
+		h = 0.0;
+		for(k=0; k < i; k++)
+			scale += fabs(d[k]);
+		if (scale == 0.0) {
+			e[i] = d[i-1];
+			for(j=0; j < i; j++) {
+				d[j] = v[j][i-1];
+				v[j][i] = 0.0;
+				v[i][j] = 0.0;
+			}
+		} else {
+			for(k=0; k < i; k++) {
+				d[k] /= scale;
+				h += d[k] * d[k];
+			}
+			f = d[i-1];
+			g = sqrt(h);
+			if (f > 0)
+				g = -g;
+			e[i] = scale * g;
+			h -= f * g;
+			d[i-1] = f - g;
+			for(j=0; j < i; j++)
+				e[j] = 0.0;
+
+			for(j=0; j < i; j++) {
+				f = d[j];
+				v[i][j] = f;
+				g = e[j] + v[j][j] * f;
+				for(k=j+1; k <= i-1; k++) {
+					g += v[j][k] * d[k];
+					e[k] += v[j][k] * f;
+				}
+				e[j] = g;
+			}
+			f = 0.0;
+			for(j=0; j < i; j++) {
+				e[j] /= h;
+				f += e[j] * d[j];
+			}
+			hh = f / (h + h);
+			for(j=0; j < i; j++)
+				e[j] -= hh * d[j];
+			for(j=0; j < i; j++) {
+				f = d[j];
+				g = e[j];
+				for(k=j; k <= i-1; k++)
+					v[j][k] -= (f * e[k] + g * d[k]);
+				d[j] = v[j][i-1];
+				v[j][i] = 0.0;
+			}
+		}
+		d[i] = h;
+	}
+
+	/* accumulate the transformations	*/
+	for(i=0; i < n-1; i++) {
+		v[i][n-1] = v[i][i];
+		v[i][i] = 1.0;
+		h = d[i+1];
+		if (h != 0.0) {
+			for(k=0; k <= i; k++)
+				d[k] = v[i+1][k] / h;
+			for(j=0; j <= i; j++) {
+				g = 0.0;
+				for(k=0; k <= i; k++)
+					g += v[i+1][k] * v[j][k];
+				for(k=0; k <= i; k++)
+					v[j][k] -= g * d[k];
+			}
+		}
+		for(k=0; k <= i; k++)
+			v[i+1][k] = 0.0;
+	}
+	for(j=0; j < n; j++) {
+		d[j] = v[j][n-1];
+		v[j][n-1] = 0.0;
+	}
+	v[n-1][n-1] = 1.0;
+	e[0] = 0.0;
+}
+
+/*
+ * 'vt' is the transformation from tred2, so that the rotations touch rows.
+ * on return, row k of 'vt' is the normalized eigenvector of eigenvalue 'd[k]'
+ */
+static void tql2(double **vt, int n, double *d, double *e)
+{
+	int i, k, l, m;
+	double c, c2, c3, dl1, el1, f, g, h, p, r, s, s2, tst1, eps = pow(2.0, -52.0);
+	double *row;
+
+	for(i=1; i < n; i++)
+		e[i-1] = e[i];
+	e[n-1] = 0.0;
+
+	f = 0.0;
+	tst1 = 0.0;
+	for(l=0; l < n; l++) {
+		if (fabs(d[l]) + fabs(e[l]) > tst1)
+			tst1 = fabs(d[l]) + fabs(e[l]);
+		for(m=l; m < n-1; m++)
+			if (fabs(e[m]) <= eps * tst1)
+				break;
+
+		if (m > l) {
+			do {
+				g = d[l];
+				p = (d[l+1] - g) / (2.0 * e[l]);
+				r = hypot(p, 1.0);
+				if (p < 0)
+					r = -r;
+				d[l] = e[l] / (p + r);
+				d[l+1] = e[l] * (p + r);
+				dl1 = d[l+1];
+				h = g - d[l];
+				for(i=l+2; i < n; i++)
+					d[i] -= h;
+				f += h;
+
+				p = d[m];
+				c = c2 = c3 = 1.0;
+				el1 = e[l+1];
+				s = s2 = 0.0;
+				for(i=m-1; i >= l; i--) {
+					c3 = c2;
+					c2 = c;
+					s2 = s;
+					g = c * e[i];
+					h = c * p;
+					r = hypot(p, e[i]);
+					e[i+1] = s * r;
+					s = e[i] / r;
+					c = p / r;
+					p = c * d[i] - s * g;
+					d[i+1] = h + s * (c * g + s * d[i]);
+					row = vt[i+1];
+					for(k=0; k < n; k++) {
+						h = row[k];
+						row[k] = s * vt[i][k] + c * h;
+						vt[i][k] = c * vt[i][k] - s * h;
+					}
+				}
+				p = -s * s2 * c3 * el1 * e[l] / dl1;
+				e[l] = s * p;
+				d[l] = c * p;
+			} while (fabs(e[l]) > eps * tst1);
+		}
+		d[l] += f;
+		e[l] = 0.0;
+	}
+}
+
+typedef struct mode_contrib_t_st
+{
+	double bound;
+	int k;
+}mode_contrib_t;
+
+/* descending order of contribution to the error bound	*/
+static int mode_contrib_cmp(const void *a, const void *b)
+{
+	double x = ((const mode_contrib_t *) a)->bound, y = ((const mode_contrib_t *) b)->bound;
+	return (x < y) - (x > y);
+}
+
+static reduced_model_t *alloc_reduced_model(int n_units, int n_modes)
+{
+	int i;
+	reduced_model_t *rom = (reduced_model_t *) calloc(1, sizeof(reduced_model_t));
+	if (!rom)
+		fatal("memory allocation error\n");
+
+	rom->n_units = n_units;
+	rom->n_modes = n_modes;
+	rom->names = (char **) calloc(n_units, sizeof(char *));
+	if (!rom->names)
+		fatal("memory allocation error\n");
+	for(i=0; i < n_units; i++) {
+		rom->names[i] = (char *) calloc(STR_SIZE, sizeof(char));
+		if (!rom->names[i])
+			fatal("memory allocation error\n");
+	}
+
+	/* dvector and dmatrix do not like zero sizes	*/
+	rom->lambda = dvector(n_modes ? n_modes : 1);
+	rom->q0 = dvector(n_modes ? n_modes : 1);
+	rom->q = dvector(n_modes ? n_modes : 1);
+	rom->decay = dvector(n_modes ? n_modes : 1);
+	rom->gain = dvector(n_modes ? n_modes : 1);
+	rom->w = dmatrix(n_modes ? n_modes : 1, n_units);
+	rom->d = dmatrix(n_units, n_units);
+	rom->cached_dt = -1.0;
+	rom->warned_intvl = FALSE;
+
+	return rom;
+}
+
+void delete_reduced_model(reduced_model_t *rom)
+{
+	int i;
+
+	for(i=0; i < rom->n_units; i++)
+		free(rom->names[i]);
+	free(rom->names);
+	free_dvector(rom->lambda);
+	free_dvector(rom->q0);
+	free_dvector(rom->q);
+	free_dvector(rom->decay);
+	free_dvector(rom->gain);
+	free_dmatrix(rom->w);
+	free_dmatrix(rom->d);
+	free(rom);
+}
+
+reduced_model_t *reduce_block_model(block_model_t *model, double intvl,
+									double max_power, double tolerance)
+{
+	int i, j, k, m, n_modes, n = model->n_units, nn = model->n_nodes;
+	double **v, *d, *e, *sqa, **w, *wmax, *contrib, *node_bound;
+	double rest, bound;
+	mode_contrib_t *order;
+	reduced_model_t *rom;
+
+	if (!model->r_ready || !model->c_ready)
+		fatal("R and C models must be populated before reducing them\n");
+	if (intvl <= 0.0 || max_power <= 0.0 || tolerance <= 0.0)
+		fatal("interval, maximum power and tolerance must be positive\n");
+
+	/* S = C^-1/2 B C^-1/2	*/
+	sqa = dvector(nn);
+	for(i=0; i < nn; i++)
+		sqa[i] = sqrt(model->a[i]);
+	v = dmatrix(nn, nn);
+	for(i=0; i < nn; i++)
+		for(j=0; j < nn; j++)
+			v[i][j] = model->b[i][j] / (sqa[i] * sqa[j]);
+
+	d = dvector(nn);
+	e = dvector(nn);
+	tred2(v, nn, d, e);
+	tql2(v, nn, d, e);
+
+	/* mode shapes at the units and their contribution to the error bound	*/
+	w = dmatrix(nn, n);
+	wmax = dvector(nn);
+	contrib = dvector(nn);
+	order = (mode_contrib_t *) calloc(nn, sizeof(mode_contrib_t));
+	if (!order)
+		fatal("memory allocation error\n");
+	for(k=0; k < nn; k++) {
+		double sum = 0.0;
+		if (d[k] <= 0.0)
+			fatal("conductance matrix is not positive definite\n");
+		for(i=0; i < n; i++) {
+			w[k][i] = v[k][i] / sqa[i];
+			sum += fabs(w[k][i]);
+			if (fabs(w[k][i]) > wmax[k])
+				wmax[k] = fabs(w[k][i]);
+		}
+		/* 2 alpha_k U_k / lambda_k	*/
+		contrib[k] = 2.0 * exp(-d[k] * intvl) * max_power * sum / d[k];
+		order[k].bound = contrib[k] * wmax[k];
+		order[k].k = k;
+	}
+
+	/* retain the largest contributors until the rest is within the tolerance	*/
+	qsort(order, nn, sizeof(mode_contrib_t), mode_contrib_cmp);
+	rest = 0.0;
+	for(n_modes=nn; n_modes > 0; n_modes--) {
+		if (rest + order[n_modes-1].bound > tolerance)
+			break;
+		rest += order[n_modes-1].bound;
+	}
+
+	rom = alloc_reduced_model(n, n_modes);
+	for(i=0; i < n; i++) {
+		strncpy(rom->names[i], model->flp->units[i].name, STR_SIZE);
+		rom->names[i][STR_SIZE-1] = '\0';
+	}
+	rom->ambient = model->config.ambient;
+	rom->init_temp = model->config.init_temp;
+	rom->intvl = intvl;
+	rom->max_power = max_power;
+
+	for(m=0; m < n_modes; m++) {
+		k = order[m].k;
+		rom->lambda[m] = d[k];
+		copy_dvector(rom->w[m], w[k], n);
+		for(i=0; i < nn; i++)
+			rom->q0[m] += v[k][i] * sqa[i];
+	}
+
+	/* static response and exact error bound of the truncated modes	*/
+	node_bound = dvector(n);
+	zero_dmatrix(rom->d, n, n);
+	for(m=n_modes; m < nn; m++) {
+		k = order[m].k;
+		for(i=0; i < n; i++) {
+			double f = w[k][i] / d[k];
+			for(j=0; j < n; j++)
+				rom->d[i][j] += f * w[k][j];
+			node_bound[i] += contrib[k] * fabs(w[k][i]);
+		}
+	}
+	bound = 0.0;
+	for(i=0; i < n; i++)
+		if (node_bound[i] > bound)
+			bound = node_bound[i];
+	rom->bound = bound;
+
+	free_dvector(node_bound);
+	free(order);
+	free_dvector(contrib);
+	free_dvector(wmax);
+	free_dmatrix(w);
+	free_dvector(e);
+	free_dvector(d);
+	free_dmatrix(v);
+	free_dvector(sqa);
+
+	set_temp_reduced(rom, rom->init_temp);
+	return rom;
+}
+
+static void write_or_die(void *ptr, size_t size, size_t count, FILE *fp)
+{
+	if (count && fwrite(ptr, size, count, fp) != count)
+		fatal("error writing reduced model\n");
+}
+
+static void read_or_die(void *ptr, size_t size, size_t count, FILE *fp)
+{
+	if (count && fread(ptr, size, count, fp) != count)
+		fatal("reduced model file is truncated\n");
+}
+
+void write_reduced_model(reduced_model_t *rom, char *file)
+{
+	char magic[8] = REDUCED_MAGIC;
+	char str[STR_SIZE];
+	int i, header[2];
+	double params[5];
+	FILE *fp;
+
+	if (!(fp = fopen(file, "wb"))) {
+		sprintf(str, "error opening reduced model file %s\n", file);
+		fatal(str);
+	}
+
+	header[0] = rom->n_units;
+	header[1] = rom->n_modes;
+	params[0] = rom->ambient;
+	params[1] = rom->init_temp;
+	params[2] = rom->intvl;
+	params[3] = rom->max_power;
+	params[4] = rom->bound;
+	write_or_die(magic, 1, 8, fp);
+	write_or_die(header, sizeof(int), 2, fp);
+	write_or_die(params, sizeof(double), 5, fp);
+	for(i=0; i < rom->n_units; i++)
+		write_or_die(rom->names[i], 1, STR_SIZE, fp);
+	write_or_die(rom->lambda, sizeof(double), rom->n_modes, fp);
+	write_or_die(rom->q0, sizeof(double), rom->n_modes, fp);
+	for(i=0; i < rom->n_modes; i++)
+		write_or_die(rom->w[i], sizeof(double), rom->n_units, fp);
+	for(i=0; i < rom->n_units; i++)
+		write_or_die(rom->d[i], sizeof(double), rom->n_units, fp);
+
+	if (fclose(fp))
+		fatal("error writing reduced model\n");
+}
+
+reduced_model_t *read_reduced_model(char *file)
+{
+	char magic[8];
+	char str[STR_SIZE];
+	int i, header[2];
+	double params[5];
+	reduced_model_t *rom;
+	FILE *fp;
+
+	if (!(fp = fopen(file, "rb"))) {
+		sprintf(str, "error opening reduced model file %s\n", file);
+		fatal(str);
+	}
+
+	read_or_die(magic, 1, 8, fp);
+	if (memcmp(magic, REDUCED_MAGIC, 8)) {
+		sprintf(str, "%s is not a reduced thermal model\n", file);
+		fatal(str);
+	}
+	read_or_die(header, sizeof(int), 2, fp);
+	if (header[0] <= 0 || header[1] < 0)
+		fatal("invalid reduced model header\n");
+	read_or_die(params, sizeof(double), 5, fp);
+
+	rom = alloc_reduced_model(header[0], header[1]);
+	rom->ambient = params[0];
+	rom->init_temp = params[1];
+	rom->intvl = params[2];
+	rom->max_power = params[3];
+	rom->bound = params[4];
+	for(i=0; i < rom->n_units; i++) {
+		read_or_die(rom->names[i], 1, STR_SIZE, fp);
+		rom->names[i][STR_SIZE-1] = '\0';
+	}
+	read_or_die(rom->lambda, sizeof(double), rom->n_modes, fp);
+	read_or_die(rom->q0, sizeof(double), rom->n_modes, fp);
+	for(i=0; i < rom->n_modes; i++)
+		read_or_die(rom->w[i], sizeof(double), rom->n_units, fp);
+	for(i=0; i < rom->n_units; i++)
+		read_or_die(rom->d[i], sizeof(double), rom->n_units, fp);
+	fclose(fp);
+
+	set_temp_reduced(rom, rom->init_temp);
+	return rom;
+}
+
+int get_reduced_index(reduced_model_t *rom, char *name)
+{
+	int i;
+
+	for(i=0; i < rom->n_units; i++)
+		if (!strcmp(rom->names[i], name))
+			return i;
+	return -1;
+}
+
+void set_temp_reduced(reduced_model_t *rom, double temp)
+{
+	int k;
+
+	for(k=0; k < rom->n_modes; k++)
+		rom->q[k] = (temp - rom->ambient) * rom->q0[k];
+}
+
+void compute_temp_reduced(reduced_model_t *rom, double *power, double *temp, double time_elapsed)
+{
+	int i, j, k, n = rom->n_units;
+
+	if (time_elapsed != rom->cached_dt) {
+		/* the error bound of the model only holds for intervals of at least 'intvl'	*/
+		if (time_elapsed < rom->intvl && !rom->warned_intvl) {
+			char str[STR_SIZE];
+			snprintf(str, sizeof(str), "reduced model stepped by %g s, less than its interval of %g s: its error bound does not hold\n",
+					 time_elapsed, rom->intvl);
+			warning(str);
+			rom->warned_intvl = TRUE;
+		}
+		for(k=0; k < rom->n_modes; k++) {
+			rom->decay[k] = exp(-rom->lambda[k] * time_elapsed);
+			rom->gain[k] = (1.0 - rom->decay[k]) / rom->lambda[k];
+		}
+		rom->cached_dt = time_elapsed;
+	}
+
+	for(i=0; i < n; i++) {
+		double sum = rom->ambient;
+		for(j=0; j < n; j++)
+			sum += rom->d[i][j] * power[j];
+		temp[i] = sum;
+	}
+
+	for(k=0; k < rom->n_modes; k++) {
+		double u = 0.0;
+		for(i=0; i < n; i++)
+			u += rom->w[k][i] * power[i];
+		rom->q[k] = rom->decay[k] * rom->q[k] + rom->gain[k] * u;
+		for(i=0; i < n; i++)
+			temp[i] += rom->w[k][i] * rom->q[k];
+	}
+}
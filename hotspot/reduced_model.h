@@ -0,0 +1,75 @@
+#ifndef __REDUCED_MODEL_H_
+#define __REDUCED_MODEL_H_
+
+/*
+ * Reduced-order version of the block model for large floorplans.
+ * Built offline by hotreduce from the RC network of populate_R_model_block
+ * and populate_C_model_block, and loaded by the simulator instead of the
+ * full network. See reduced_model.c for the method and the error bound.
+ */
+
+#include "temperature_block.h"
+#include "util.h"
+
+/* file format: header, then the arrays in the order of the struct below	*/
+#define REDUCED_MAGIC	"HSROM01"
+
+typedef struct reduced_model_t_st
+{
+	/* functional units (the silicon layer nodes of the block model)	*/
+	int n_units;
+	char **names;
+	/* no. of retained modes	*/
+	int n_modes;
+
+	/* ambient and initial temperatures of the configuration it was built from	*/
+	double ambient;
+	double init_temp;
+	/* generation parameters and the resulting error bound	*/
+	double intvl;
+	double max_power;
+	double bound;
+
+	/* decay rates (1/s) of the retained modes	*/
+	double *lambda;
+	/* n_modes x n_units: mode shapes at the functional units	*/
+	double **w;
+	/* n_units x n_units: static response of the truncated modes	*/
+	double **d;
+	/* modal coordinates of a uniform 1K rise of all nodes	*/
+	double *q0;
+
+	/* state: modal coordinates of the current temperature rise	*/
+	double *q;
+	/* per-mode decay and gain factors for the last interval	*/
+	double cached_dt;
+	double *decay, *gain;
+	/* whether an interval shorter than 'intvl' was already reported	*/
+	int warned_intvl;
+}reduced_model_t;
+
+/*
+ * reduce a populated block model. the retained modes are chosen such that,
+ * for piecewise constant unit powers of at most 'max_power' W changing at most
+ * every 'intvl' seconds, the unit temperatures at the ends of the intervals
+ * are within 'tolerance' K of those of the full model
+ */
+reduced_model_t *reduce_block_model(block_model_t *model, double intvl,
+									double max_power, double tolerance);
+void delete_reduced_model(reduced_model_t *rom);
+
+void write_reduced_model(reduced_model_t *rom, char *file);
+reduced_model_t *read_reduced_model(char *file);
+
+/* index of a functional unit, -1 if not found	*/
+int get_reduced_index(reduced_model_t *rom, char *name);
+
+/* set all nodes to 'temp' (in Kelvin)	*/
+void set_temp_reduced(reduced_model_t *rom, double temp);
+/*
+ * advance by 'time_elapsed' seconds of constant 'power' (per unit, in W)
+ * and write the unit temperatures to 'temp'
+ */
+void compute_temp_reduced(reduced_model_t *rom, double *power, double *temp, double time_elapsed);
+
+#endif
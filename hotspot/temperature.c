@@ -80,6 +80,8 @@ thermal_config_t default_thermal_config(void)
 	
 	config.package_model_used = 0;
 	strcpy(config.package_config_file, NULLFILE);	
+
+	config.expm_used = 0;
 	
 	/* set block model as default	*/
 	strcpy(config.model_type, BLOCK_MODEL_STR);
@@ -100,6 +102,7 @@ thermal_config_t default_thermal_config(void)
 	 * grid cell as that of the entire block
 	 */
 	strcpy(config.grid_map_mode, GRID_CENTER_STR);
+	config.grid_threads = 1;
 
 	config.detailed_3D_used = 0;	//BU_3D: by default detailed 3D modeling is disabled.	
 	return config;
@@ -241,6 +244,9 @@ void thermal_config_add_from_strs(thermal_config_t *config, str_pair *table, int
 	if ((idx = get_str_index(table, size, "package_config_file")) >= 0)
 		if(sscanf(table[idx].value, "%s", config->package_config_file) != 1)
 			fatal("invalid format for configuration  parameter package_config_file\n");
+	if ((idx = get_str_index(table, size, "expm_used")) >= 0)
+		if(sscanf(table[idx].value, "%d", &config->expm_used) != 1)
+			fatal("invalid format for configuration  parameter expm_used\n");
 	if ((idx = get_str_index(table, size, "block_omit_lateral")) >= 0)
 		if(sscanf(table[idx].value, "%d", &config->block_omit_lateral) != 1)
 			fatal("invalid format for configuration  parameter block_omit_lateral\n");
@@ -259,6 +265,9 @@ void thermal_config_add_from_strs(thermal_config_t *config, str_pair *table, int
 	if ((idx = get_str_index(table, size, "grid_map_mode")) >= 0)
 		if(sscanf(table[idx].value, "%s", config->grid_map_mode) != 1)
 			fatal("invalid format for configuration  parameter grid_map_mode\n");
+	if ((idx = get_str_index(table, size, "grid_threads")) >= 0)
+		if(sscanf(table[idx].value, "%d", &config->grid_threads) != 1)
+			fatal("invalid format for configuration  parameter grid_threads\n");
 	
 	if ((config->t_chip <= 0) || (config->s_sink <= 0) || (config->t_sink <= 0) || 
 		(config->s_spreader <= 0) || (config->t_spreader <= 0) || 
@@ -285,6 +294,8 @@ void thermal_config_add_from_strs(thermal_config_t *config, str_pair *table, int
 		fatal("invalid model type. use 'block' or 'grid'\n");
 	if(config->grid_rows <= 0 || config->grid_cols <= 0)
 		fatal("grid rows and columns should both be greater than zero\n");
+	if (config->grid_threads <= 0)
+		fatal("no. of grid threads should be greater than zero\n");
 	if (strcasecmp(config->grid_map_mode, GRID_AVG_STR) &&
 		strcasecmp(config->grid_map_mode, GRID_MIN_STR) &&
 		strcasecmp(config->grid_map_mode, GRID_MAX_STR) &&
@@ -298,7 +309,7 @@ void thermal_config_add_from_strs(thermal_config_t *config, str_pair *table, int
  */
 int thermal_config_to_strs(thermal_config_t *config, str_pair *table, int max_entries)
 {
-	if (max_entries < 49)
+	if (max_entries < 51)
 		fatal("not enough entries in table\n");
 
 	sprintf(table[0].name, "t_chip");
@@ -350,6 +361,8 @@ int thermal_config_to_strs(thermal_config_t *config, str_pair *table, int max_en
 	sprintf(table[46].name, "grid_layer_file");
 	sprintf(table[47].name, "grid_steady_file");
 	sprintf(table[48].name, "grid_map_mode");
+	sprintf(table[49].name, "expm_used");
+	sprintf(table[50].name, "grid_threads");
 
 	sprintf(table[0].value, "%lg", config->t_chip);
 	sprintf(table[1].value, "%lg", config->k_chip);
@@ -400,8 +413,10 @@ int thermal_config_to_strs(thermal_config_t *config, str_pair *table, int max_en
 	sprintf(table[46].value, "%s", config->grid_layer_file);
 	sprintf(table[47].value, "%s", config->grid_steady_file);
 	sprintf(table[48].value, "%s", config->grid_map_mode);
+	sprintf(table[49].value, "%d", config->expm_used);
+	sprintf(table[50].value, "%d", config->grid_threads);
 
-	return 49;
+	return 51;
 }
 
 /* package parameter routines	*/
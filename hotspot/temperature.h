@@ -200,6 +200,9 @@ typedef struct thermal_config_t_st
 	int package_model_used; /* flag to indicate whether package model is used */
 	char package_config_file[STR_SIZE]; /* package/fan configurations */ 
 
+	/* transient solver - adaptive rk4 or exact matrix exponential	*/
+	int expm_used;
+
 	/* parameters specific to block model	*/
 	int block_omit_lateral;	/* omit lateral resistance?	*/
 
@@ -212,6 +215,8 @@ typedef struct thermal_config_t_st
 	char grid_steady_file[STR_SIZE];
 	/* mapping mode between grid and block models	*/
 	char grid_map_mode[STR_SIZE];
+	/* no. of threads solving the grid	*/
+	int grid_threads;
 	
 	int detailed_3D_used; //BU_3D: Added parameter to check for heterogenous R-C model 
 }thermal_config_t;
@@ -400,6 +405,27 @@ void lusolve(double **a, int n, int *p, double *b, double *x, int spd);
 /* 4th order Runge Kutta solver with adaptive step sizing */
 double rk4(void *model, double *y, void *p, int n, double *h, double *yout, slope_fn_ptr f);
 
+/* exact transient solver for a fixed interval 'dt': y = phi * y + psi * f(0)	*/
+typedef struct expm_step_t_st
+{
+	double dt;
+	int n;
+	/* propagator exp(-M*dt) and input matrix (I - exp(-M*dt)) * inv(M)	*/
+	double **phi;
+	double **psi;
+	/* scratch pad vectors	*/
+	double *f0, *y0;
+	struct expm_step_t_st *next;
+}expm_step_t;
+/* the propagators are dense n x n matrices	*/
+#define EXPM_MAX_NODES	4096
+/* no. of distinct intervals to keep propagators for	*/
+#define EXPM_MAX_CACHED	8
+/* find or build the propagator for 'dt' in the cache	*/
+expm_step_t *get_expm_step(expm_step_t **cache, void *model, void *p, int n, double dt, slope_fn_ptr f);
+void expm_step(expm_step_t *step, void *model, double *y, void *p, slope_fn_ptr f);
+void free_expm_cache(expm_step_t **cache);
+
 /* matrix and vector routines	*/
 void matmult(double **c, double **a, double **b, int n);
 /* same as above but 'a' is a diagonal matrix stored as a 1-d array	*/
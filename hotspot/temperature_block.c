@@ -291,6 +291,8 @@ void populate_R_model_block(block_model_t *model, flp_t *flp)
 
 	/* done	*/
 	model->flp = flp;
+	/* propagators of the old network are stale	*/
+	free_expm_cache(&model->expm_cache);
 	model->r_ready = TRUE;
 }
 
@@ -375,6 +377,7 @@ void populate_C_model_block(block_model_t *model, flp_t *flp)
 	diagmatmult(c, inva, b, NL*n+EXTRA);
 
 	/*	done	*/
+	free_expm_cache(&model->expm_cache);
 	model->c_ready = TRUE;
 }
 
@@ -465,6 +468,13 @@ void compute_temp_block(block_model_t *model, double *power, double *temp, doubl
 	/* use the scratch pad vector to find (inv_A)*POWER */
 	diagmatvectmult(model->t_vector, model->inva, power, model->n_nodes);
 
+	if (model->config.expm_used) {
+		expm_step(get_expm_step(&model->expm_cache, model, model->t_vector, model->n_nodes, 
+								time_elapsed, (slope_fn_ptr) slope_fn_block),
+				  model, temp, model->t_vector, (slope_fn_ptr) slope_fn_block);
+		return;
+	}
+
 	/* Obtain temp at time (t+time_elapsed). 
 	 * Instead of getting the temperature at t+time_elapsed directly, we do it 
 	 * in multiple steps with the correct step size at each time 
@@ -513,6 +523,7 @@ void resize_thermal_model_block(block_model_t *model, int n_units)
 		fatal("resizing block model to more than the allocated space\n");
 	model->n_units = n_units;
 	model->n_nodes = NL * n_units + EXTRA;
+	free_expm_cache(&model->expm_cache);
 	/* resize the 2-d matrices whose no. of columns changes	*/
 	resize_dmatrix(model->len, model->n_units, model->n_units);
 	resize_dmatrix(model->g, model->n_nodes, model->n_nodes);
@@ -855,6 +866,8 @@ void delete_block_model(block_model_t *model)
 
 	free_imatrix(model->border);
 
+	free_expm_cache(&model->expm_cache);
+
 	free(model);
 }
 
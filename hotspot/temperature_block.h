@@ -49,6 +49,9 @@ typedef struct block_model_t_st
 	double **len, **g;
 	int **border;
 
+	/* propagators of the exact transient solver, per interval	*/
+	expm_step_t *expm_cache;
+
 	/* total no. of nodes	*/
 	int n_nodes;
 	/* total no. of blocks	*/
@@ -679,6 +679,10 @@ grid_model_t *alloc_grid_model(thermal_config_t *config, flp_t *flp_default, int
   model->config = *config;
   model->rows = config->grid_rows;
   model->cols = config->grid_cols;
+  if (config->grid_threads > 1) {
+      model->pool = thread_pool_create(config->grid_threads);
+      model->pool_scratch = dvector(config->grid_threads * GRID_PAD);
+  }
   if(do_detailed_3D) //BU_3D: check if heterogenous RC model is on
     model->config.detailed_3D_used = TRUE; 
   if(!strcasecmp(model->config.grid_map_mode, GRID_AVG_STR))
@@ -841,6 +845,8 @@ void populate_R_model_grid(grid_model_t *model, flp_t *flp)
   }
 
   /* done	*/
+  /* propagators of the old network are stale	*/
+  free_expm_cache(&model->expm_cache);
   model->r_ready = TRUE;
 }
 
@@ -892,6 +898,7 @@ void populate_C_model_grid(grid_model_t *model, flp_t *flp)
   }
 
   /* done	*/	
+  free_expm_cache(&model->expm_cache);
   model->c_ready = TRUE;
 }
 
@@ -950,6 +957,11 @@ void delete_grid_model(grid_model_t *model)
 
   free_grid_model_vector(model->last_steady);
   free_grid_model_vector(model->last_trans);
+  free_expm_cache(&model->expm_cache);
+  if (model->pool) {
+      thread_pool_destroy(model->pool);
+      free_dvector(model->pool_scratch);
+  }
   free(model->layers);
   free(model);
 }
@@ -2245,10 +2257,19 @@ double single_iteration_steady_pack(grid_model_t *model, grid_model_vector_t *po
 //end->BU_3D
 
 /* single steady state iteration of grid solver - silicon part */
-double single_iteration_steady_grid(grid_model_t *model, grid_model_vector_t *power,
-                                    grid_model_vector_t *temp)
+/* use the worker pool for the current (possibly coarsened) grid?	*/
+static int grid_use_pool(grid_model_t *model)
 {
-  int n, i, j;
+  return model->pool && model->rows * model->cols >= GRID_PARALLEL_MIN_CELLS;
+}
+
+/* one gauss-seidel pass over the cells j0, j0+step, ... of row i
+ * in layer n. returns the maximum temperature change
+ */
+static double steady_grid_row(grid_model_t *model, grid_model_vector_t *power,
+                              grid_model_vector_t *temp, int n, int i, int j0, int step)
+{
+  int j;
   double prev, delta, max = 0;
   /* sum of the conductances	*/
   double csum;
@@ -2277,163 +2298,218 @@ double single_iteration_steady_grid(grid_model_t *model, grid_model_vector_t *po
       pcbidx = LAYER_PCB;	
   }
 
-  /* for each grid cell	*/
-  for(n=0; n < nl; n++) {
-      for(i=0; i < nr; i++) {
-          for(j=0; j < nc; j++) {
-              /* sum the conductances to cells north, south, 
-               * east, west, above and below
-               */
-              // BU_3D: call new macros if detailed_3D model is used 
-              // the spreader/heat sink layers will use uniform R
-              if(model->config.detailed_3D_used == 1){
-                  csum = NC_det3D(l,n,i,j,nl,nr,nc) + SC_det3D(l,n,i,j,nl,nr,nc) + 
-                    EC_det3D(l,n,i,j,nl,nr,nc) + WC_det3D(l,n,i,j,nl,nr,nc) + 
-                    AC_det3D(l,n,i,j,nl,nr,nc) + BC_det3D(l,n,i,j,nl,nr,nc);
-
-                  /* sum of the weighted temperatures of all the neighbours*/	
-                  wsum = NT_det3D(l,v,n,i,j,nl,nr,nc) + ST_det3D(l,v,n,i,j,nl,nr,nc) + 
-                    ET_det3D(l,v,n,i,j,nl,nr,nc) + WT_det3D(l,v,n,i,j,nl,nr,nc) + 
-                    AT_det3D(l,v,n,i,j,nl,nr,nc) + BT_det3D(l,v,n,i,j,nl,nr,nc);
-              } //end->BU_3D
-              else {	
-                  csum = NC(l,n,i,j,nl,nr,nc) + SC(l,n,i,j,nl,nr,nc) + 
-                    EC(l,n,i,j,nl,nr,nc) + WC(l,n,i,j,nl,nr,nc) + 
-                    AC(l,n,i,j,nl,nr,nc) + BC(l,n,i,j,nl,nr,nc);
-
-                  /* sum of the weighted temperatures of all the neighbours	*/
-                  wsum = NT(l,v,n,i,j,nl,nr,nc) + ST(l,v,n,i,j,nl,nr,nc) + 
-                    ET(l,v,n,i,j,nl,nr,nc) + WT(l,v,n,i,j,nl,nr,nc) + 
-                    AT(l,v,n,i,j,nl,nr,nc) + BT(l,v,n,i,j,nl,nr,nc);
-              } 
-
-              /* spreader core is connected to its periphery	*/
-              if (n == spidx) {
-                  /* northern boundary - edge cell has half the ry	*/
-                  if (i == 0) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
-                      wsum += temp->extra[SP_N]/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
-                  }
-                  /* southern boundary - edge cell has half the ry	*/
-                  if (i == nr-1) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
-                      wsum += temp->extra[SP_S]/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
-                  }
-                  /* eastern boundary	 - edge cell has half the rx	*/
-                  if (j == nc-1) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
-                      wsum += temp->extra[SP_E]/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
-                  }
-                  /* western boundary	- edge cell has half the rx		*/
-                  if (j == 0) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
-                      wsum += temp->extra[SP_W]/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
-                  }
-                  /* heatsink core is connected to its inner periphery and ambient	*/
-              } else if (n == hsidx) {
-                  /* all nodes are connected to the ambient	*/
-                  csum += 1.0/l[n].rz;
-                  wsum += c->ambient/l[n].rz;
-                  /* northern boundary - edge cell has half the ry	*/
-                  if (i == 0) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
-                      wsum += temp->extra[SINK_C_N]/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
-                  }
-                  /* southern boundary - edge cell has half the ry	*/
-                  if (i == nr-1) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
-                      wsum += temp->extra[SINK_C_S]/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
-                  }
-                  /* eastern boundary	 - edge cell has half the rx	*/
-                  if (j == nc-1) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
-                      wsum += temp->extra[SINK_C_E]/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
-                  }
-                  /* western boundary	- edge cell has half the rx		*/
-                  if (j == 0) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
-                      wsum += temp->extra[SINK_C_W]/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
-                  }
-              } else if ((n==subidx) && model->config.model_secondary) {
-                  /* northern boundary - edge cell has half the ry	*/
-                  if (i == 0) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
-                      wsum += temp->extra[SUB_N]/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
-                  }
-                  /* southern boundary - edge cell has half the ry	*/
-                  if (i == nr-1) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
-                      wsum += temp->extra[SUB_S]/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
-                  }
-                  /* eastern boundary	 - edge cell has half the rx	*/
-                  if (j == nc-1) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
-                      wsum += temp->extra[SUB_E]/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
-                  }
-                  /* western boundary	- edge cell has half the rx		*/
-                  if (j == 0) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
-                      wsum += temp->extra[SUB_W]/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
-                  } 
-              } else if ((n==solderidx) && model->config.model_secondary) {
-                  /* northern boundary - edge cell has half the ry	*/
-                  if (i == 0) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
-                      wsum += temp->extra[SOLDER_N]/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
-                  }
-                  /* southern boundary - edge cell has half the ry	*/
-                  if (i == nr-1) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
-                      wsum += temp->extra[SOLDER_S]/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
-                  }
-                  /* eastern boundary	 - edge cell has half the rx	*/
-                  if (j == nc-1) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
-                      wsum += temp->extra[SOLDER_E]/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
-                  }
-                  /* western boundary	- edge cell has half the rx		*/
-                  if (j == 0) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
-                      wsum += temp->extra[SOLDER_W]/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
-                  } 
-              } else if ((n==pcbidx) && model->config.model_secondary) {
-                  /* all nodes are connected to the ambient	*/
-                  csum += 1.0/(model->config.r_convec_sec * 
-                               (model->config.s_pcb * model->config.s_pcb) / (cw * ch));
-                  wsum += c->ambient/(model->config.r_convec_sec * 
-                                      (model->config.s_pcb * model->config.s_pcb) / (cw * ch));
-                  /* northern boundary - edge cell has half the ry	*/
-                  if (i == 0) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
-                      wsum += temp->extra[PCB_C_N]/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
-                  }
-                  /* southern boundary - edge cell has half the ry	*/
-                  if (i == nr-1) {
-                      csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
-                      wsum += temp->extra[PCB_C_S]/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
-                  }
-                  /* eastern boundary	 - edge cell has half the rx	*/
-                  if (j == nc-1) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
-                      wsum += temp->extra[PCB_C_E]/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
-                  }
-                  /* western boundary	- edge cell has half the rx		*/
-                  if (j == 0) {
-                      csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
-                      wsum += temp->extra[PCB_C_W]/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
-                  }
-              }
-
-              /* update the current cell's temperature	*/	   
-              prev = v[n][i][j];
-              v[n][i][j] = (power->cuboid[n][i][j] + wsum) / csum;
-
-              /* compute maximum delta	*/
-              delta =  fabs(prev - v[n][i][j]);
-              if (delta > max)
-                max = delta;
+  for(j=j0; j < nc; j+=step) {
+      /* sum the conductances to cells north, south, 
+       * east, west, above and below
+       */
+      // BU_3D: call new macros if detailed_3D model is used 
+      // the spreader/heat sink layers will use uniform R
+      if(model->config.detailed_3D_used == 1){
+          csum = NC_det3D(l,n,i,j,nl,nr,nc) + SC_det3D(l,n,i,j,nl,nr,nc) + 
+            EC_det3D(l,n,i,j,nl,nr,nc) + WC_det3D(l,n,i,j,nl,nr,nc) + 
+            AC_det3D(l,n,i,j,nl,nr,nc) + BC_det3D(l,n,i,j,nl,nr,nc);
+
+          /* sum of the weighted temperatures of all the neighbours*/	
+          wsum = NT_det3D(l,v,n,i,j,nl,nr,nc) + ST_det3D(l,v,n,i,j,nl,nr,nc) + 
+            ET_det3D(l,v,n,i,j,nl,nr,nc) + WT_det3D(l,v,n,i,j,nl,nr,nc) + 
+            AT_det3D(l,v,n,i,j,nl,nr,nc) + BT_det3D(l,v,n,i,j,nl,nr,nc);
+      } //end->BU_3D
+      else {	
+          csum = NC(l,n,i,j,nl,nr,nc) + SC(l,n,i,j,nl,nr,nc) + 
+            EC(l,n,i,j,nl,nr,nc) + WC(l,n,i,j,nl,nr,nc) + 
+            AC(l,n,i,j,nl,nr,nc) + BC(l,n,i,j,nl,nr,nc);
+
+          /* sum of the weighted temperatures of all the neighbours	*/
+          wsum = NT(l,v,n,i,j,nl,nr,nc) + ST(l,v,n,i,j,nl,nr,nc) + 
+            ET(l,v,n,i,j,nl,nr,nc) + WT(l,v,n,i,j,nl,nr,nc) + 
+            AT(l,v,n,i,j,nl,nr,nc) + BT(l,v,n,i,j,nl,nr,nc);
+      } 
+
+      /* spreader core is connected to its periphery	*/
+      if (n == spidx) {
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
+              wsum += temp->extra[SP_N]/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
+          }
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
+              wsum += temp->extra[SP_S]/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
+          }
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
+              wsum += temp->extra[SP_E]/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
+          }
+          /* western boundary	- edge cell has half the rx		*/
+          if (j == 0) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
+              wsum += temp->extra[SP_W]/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
+          }
+          /* heatsink core is connected to its inner periphery and ambient	*/
+      } else if (n == hsidx) {
+          /* all nodes are connected to the ambient	*/
+          csum += 1.0/l[n].rz;
+          wsum += c->ambient/l[n].rz;
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
+              wsum += temp->extra[SINK_C_N]/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
+          }
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
+              wsum += temp->extra[SINK_C_S]/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
+          }
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
+              wsum += temp->extra[SINK_C_E]/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
+          }
+          /* western boundary	- edge cell has half the rx		*/
+          if (j == 0) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
+              wsum += temp->extra[SINK_C_W]/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
+          }
+      } else if ((n==subidx) && model->config.model_secondary) {
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
+              wsum += temp->extra[SUB_N]/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
+          }
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
+              wsum += temp->extra[SUB_S]/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
+          }
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
+              wsum += temp->extra[SUB_E]/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
+          }
+          /* western boundary	- edge cell has half the rx		*/
+          if (j == 0) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
+              wsum += temp->extra[SUB_W]/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
+          } 
+      } else if ((n==solderidx) && model->config.model_secondary) {
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
+              wsum += temp->extra[SOLDER_N]/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
+          }
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
+              wsum += temp->extra[SOLDER_S]/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
+          }
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
+              wsum += temp->extra[SOLDER_E]/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
+          }
+          /* western boundary	- edge cell has half the rx		*/
+          if (j == 0) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
+              wsum += temp->extra[SOLDER_W]/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
+          } 
+      } else if ((n==pcbidx) && model->config.model_secondary) {
+          /* all nodes are connected to the ambient	*/
+          csum += 1.0/(model->config.r_convec_sec * 
+                       (model->config.s_pcb * model->config.s_pcb) / (cw * ch));
+          wsum += c->ambient/(model->config.r_convec_sec * 
+                              (model->config.s_pcb * model->config.s_pcb) / (cw * ch));
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
+              wsum += temp->extra[PCB_C_N]/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
+          }
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1) {
+              csum += 1.0/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
+              wsum += temp->extra[PCB_C_S]/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
+          }
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
+              wsum += temp->extra[PCB_C_E]/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
+          }
+          /* western boundary	- edge cell has half the rx		*/
+          if (j == 0) {
+              csum += 1.0/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
+              wsum += temp->extra[PCB_C_W]/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
           }
       }
+
+      /* update the current cell's temperature	*/	   
+      prev = v[n][i][j];
+      v[n][i][j] = (power->cuboid[n][i][j] + wsum) / csum;
+
+      /* compute maximum delta	*/
+      delta =  fabs(prev - v[n][i][j]);
+      if (delta > max)
+        max = delta;
+  }
+  return max;
+}
+
+/* the six neighbours of a cell all have the other colour ((n+i+j) is 
+ * odd vs. even), so all rows can be updated concurrently for one colour
+ */
+typedef struct steady_grid_job_t_st
+{
+  grid_model_t *model;
+  grid_model_vector_t *power;
+  grid_model_vector_t *temp;
+  int colour;
+  /* maximum change per worker, GRID_PAD apart	*/
+  double *max;
+}steady_grid_job_t;
+
+static void steady_grid_rows(void *arg, int worker, int begin, int end)
+{
+  steady_grid_job_t *job = (steady_grid_job_t *) arg;
+  int r, n, i, nr = job->model->rows;
+  double delta, max = job->max[worker*GRID_PAD];
+
+  for(r=begin; r < end; r++) {
+      n = r / nr;
+      i = r % nr;
+      delta = steady_grid_row(job->model, job->power, job->temp, n, i, (job->colour + n + i) & 1, 2);
+      if (delta > max)
+        max = delta;
+  }
+  job->max[worker*GRID_PAD] = max;
+}
+
+double single_iteration_steady_grid(grid_model_t *model, grid_model_vector_t *power,
+                                    grid_model_vector_t *temp)
+{
+  int n, i, w;
+  double delta, max = 0;
+  steady_grid_job_t job;
+
+  if (grid_use_pool(model)) {
+      /* red-black ordering	*/
+      job.model = model;
+      job.power = power;
+      job.temp = temp;
+      job.max = model->pool_scratch;
+      for(w=0; w < thread_pool_size(model->pool); w++)
+        job.max[w*GRID_PAD] = 0;
+      for(job.colour=0; job.colour < 2; job.colour++)
+        thread_pool_run(model->pool, model->n_layers * model->rows, steady_grid_rows, &job);
+      for(w=0; w < thread_pool_size(model->pool); w++)
+        max = MAX(max, job.max[w*GRID_PAD]);
+  } else {
+      /* for each grid cell, in lexicographic order	*/
+      for(n=0; n < model->n_layers; n++)
+        for(i=0; i < model->rows; i++) {
+            delta = steady_grid_row(model, power, temp, n, i, 0, 1);
+            if (delta > max)
+              max = delta;
+        }
   }
   /* package part of the iteration	*/
   return (MAX(max, single_iteration_steady_pack(model, power, temp)));
@@ -2962,9 +3038,11 @@ void slope_fn_pack(grid_model_t *model, double *v, grid_model_vector_t *p, doubl
  * equation is CdV + sum{(T - Ti)/Ri} = P 
  * so, slope = dV = [P + sum{(Ti-T)/Ri}]/C
  */
-void slope_fn_grid(grid_model_t *model, double *v, grid_model_vector_t *p, double *dv)
+/* slope of the cells in row i of layer n	*/
+static void slope_grid_row(grid_model_t *model, double *v, grid_model_vector_t *p, double *dv,
+                           int n, int i)
 {
-  int n, i, j;
+  int j;
   /* sum of the currents(power values)	*/
   double psum;
 
@@ -2992,107 +3070,142 @@ void slope_fn_grid(grid_model_t *model, double *v, grid_model_vector_t *p, doubl
       pcbidx = LAYER_PCB;	
   }
 
-  /* for each grid cell	*/
-  for(n=0; n < nl; n++)
-    for(i=0; i < nr; i++)
-      for(j=0; j < nc; j++) {
-          /* sum the currents(power values) to cells north, south, 
-           * east, west, above and below
-           */
-          // BU_3D: uses grid specific values for all layers 
-          // spreader and heat sink layers will use uniform R
-          if(model->config.detailed_3D_used == 1){
-              psum = NP_det3D(l,v,n,i,j,nl,nr,nc) + SP_det3D(l,v,n,i,j,nl,nr,nc) + 
-                EP_det3D(l,v,n,i,j,nl,nr,nc) + WP_det3D(l,v,n,i,j,nl,nr,nc) + 
-                AP_det3D(l,v,n,i,j,nl,nr,nc) + BP_det3D(l,v,n,i,j,nl,nr,nc);
-          }
-          else{
-              psum = NP(l,v,n,i,j,nl,nr,nc) + SP(l,v,n,i,j,nl,nr,nc) + 
-                EP(l,v,n,i,j,nl,nr,nc) + WP(l,v,n,i,j,nl,nr,nc) + 
-                AP(l,v,n,i,j,nl,nr,nc) + BP(l,v,n,i,j,nl,nr,nc);
-          }//end->BU_3D
-
-          /* spreader core is connected to its periphery	*/
-          if (n == spidx) {
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[SP_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[SP_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[SP_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[SP_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
-              /* heatsink core is connected to its inner periphery and ambient	*/
-          } else if (n == hsidx) {
-              /* all nodes are connected to the ambient	*/
-              psum += (c->ambient - A3D(v,n,i,j,nl,nr,nc))/l[n].rz;
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[SINK_C_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[SINK_C_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[SINK_C_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[SINK_C_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
-          }	else if (n == pcbidx && model_secondary) {
-              /* all nodes are connected to the ambient	*/
-              psum += (c->ambient - A3D(v,n,i,j,nl,nr,nc))/(model->config.r_convec_sec * 
-                                                            (model->config.s_pcb * model->config.s_pcb) / (cw * ch));
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[PCB_C_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[PCB_C_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[PCB_C_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[PCB_C_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
-          }	else if (n == subidx && model_secondary) {
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[SUB_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[SUB_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[SUB_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[SUB_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
-          }	else if (n == solderidx && model_secondary) {
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[SOLDER_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[SOLDER_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[SOLDER_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[SOLDER_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
-          }
-
-          /* update the current cell's temperature	*/	   
-          if(model->config.detailed_3D_used == 1)//BU_3D: use find_cap_3D is detailed_3D model is used.
-            A3D(dv,n,i,j,nl,nr,nc) = (p->cuboid[n][i][j] + psum) / find_cap_3D(n, i, j, model);
-          else
-            A3D(dv,n,i,j,nl,nr,nc) = (p->cuboid[n][i][j] + psum) / l[n].c;
+  for(j=0; j < nc; j++) {
+      /* sum the currents(power values) to cells north, south, 
+       * east, west, above and below
+       */
+      // BU_3D: uses grid specific values for all layers 
+      // spreader and heat sink layers will use uniform R
+      if(model->config.detailed_3D_used == 1){
+          psum = NP_det3D(l,v,n,i,j,nl,nr,nc) + SP_det3D(l,v,n,i,j,nl,nr,nc) + 
+            EP_det3D(l,v,n,i,j,nl,nr,nc) + WP_det3D(l,v,n,i,j,nl,nr,nc) + 
+            AP_det3D(l,v,n,i,j,nl,nr,nc) + BP_det3D(l,v,n,i,j,nl,nr,nc);
+      }
+      else{
+          psum = NP(l,v,n,i,j,nl,nr,nc) + SP(l,v,n,i,j,nl,nr,nc) + 
+            EP(l,v,n,i,j,nl,nr,nc) + WP(l,v,n,i,j,nl,nr,nc) + 
+            AP(l,v,n,i,j,nl,nr,nc) + BP(l,v,n,i,j,nl,nr,nc);
+      }//end->BU_3D
+
+      /* spreader core is connected to its periphery	*/
+      if (n == spidx) {
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0)
+            psum += (x[SP_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1)
+            psum += (x[SP_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1)
+            psum += (x[SP_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
+          /* western boundary	 - edge cell has half the rx	*/
+          if (j == 0)
+            psum += (x[SP_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
+          /* heatsink core is connected to its inner periphery and ambient	*/
+      } else if (n == hsidx) {
+          /* all nodes are connected to the ambient	*/
+          psum += (c->ambient - A3D(v,n,i,j,nl,nr,nc))/l[n].rz;
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0)
+            psum += (x[SINK_C_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1)
+            psum += (x[SINK_C_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1)
+            psum += (x[SINK_C_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
+          /* western boundary	 - edge cell has half the rx	*/
+          if (j == 0)
+            psum += (x[SINK_C_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
+      }	else if (n == pcbidx && model_secondary) {
+          /* all nodes are connected to the ambient	*/
+          psum += (c->ambient - A3D(v,n,i,j,nl,nr,nc))/(model->config.r_convec_sec * 
+                                                        (model->config.s_pcb * model->config.s_pcb) / (cw * ch));
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0)
+            psum += (x[PCB_C_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1)
+            psum += (x[PCB_C_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1)
+            psum += (x[PCB_C_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
+          /* western boundary	 - edge cell has half the rx	*/
+          if (j == 0)
+            psum += (x[PCB_C_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
+      }	else if (n == subidx && model_secondary) {
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0)
+            psum += (x[SUB_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1)
+            psum += (x[SUB_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1)
+            psum += (x[SUB_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
+          /* western boundary	 - edge cell has half the rx	*/
+          if (j == 0)
+            psum += (x[SUB_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
+      }	else if (n == solderidx && model_secondary) {
+          /* northern boundary - edge cell has half the ry	*/
+          if (i == 0)
+            psum += (x[SOLDER_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
+          /* southern boundary - edge cell has half the ry	*/
+          if (i == nr-1)
+            psum += (x[SOLDER_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
+          /* eastern boundary	 - edge cell has half the rx	*/
+          if (j == nc-1)
+            psum += (x[SOLDER_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
+          /* western boundary	 - edge cell has half the rx	*/
+          if (j == 0)
+            psum += (x[SOLDER_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
       }
-  /* for each grid cell	*/
+
+      /* update the current cell's temperature	*/	   
+      if(model->config.detailed_3D_used == 1)//BU_3D: use find_cap_3D is detailed_3D model is used.
+        A3D(dv,n,i,j,nl,nr,nc) = (p->cuboid[n][i][j] + psum) / find_cap_3D(n, i, j, model);
+      else
+        A3D(dv,n,i,j,nl,nr,nc) = (p->cuboid[n][i][j] + psum) / l[n].c;
+  }
+}
+
+/* the slope of a cell only depends on the current temperatures,
+ * so the rows are independent
+ */
+typedef struct slope_grid_job_t_st
+{
+  grid_model_t *model;
+  double *v;
+  grid_model_vector_t *p;
+  double *dv;
+}slope_grid_job_t;
+
+static void slope_grid_rows(void *arg, int worker, int begin, int end)
+{
+  slope_grid_job_t *job = (slope_grid_job_t *) arg;
+  int r, nr = job->model->rows;
+
+  for(r=begin; r < end; r++)
+    slope_grid_row(job->model, job->v, job->p, job->dv, r / nr, r % nr);
+}
+
+void slope_fn_grid(grid_model_t *model, double *v, grid_model_vector_t *p, double *dv)
+{
+  int n, i;
+  slope_grid_job_t job;
+
+  if (grid_use_pool(model)) {
+      job.model = model;
+      job.v = v;
+      job.p = p;
+      job.dv = dv;
+      thread_pool_run(model->pool, model->n_layers * model->rows, slope_grid_rows, &job);
+  } else {
+      /* for each grid cell	*/
+      for(n=0; n < model->n_layers; n++)
+        for(i=0; i < model->rows; i++)
+          slope_grid_row(model, v, p, dv, n, i);
+  }
   slope_fn_pack(model, v, p, dv);
 }
 
@@ -3133,23 +3246,30 @@ void compute_temp_grid(grid_model_t *model, double *power, double *temp, double
   /* Obtain temp at time (t+time_elapsed). 
    * Instead of getting the temperature at t+time_elapsed directly, we
    * do it in multiple steps with the correct step size at each time 
-   * provided by rk4. 
+   * provided by rk4 (or in one step with the exact solver). 
    */
-  for (t = 0, new_h = MIN_STEP; t < time_elapsed && new_h >= MIN_STEP*DELTA; t+=h) {
-      h = new_h;
-      /* pass the entire grid and the tail of package nodes 
-       * as a 1-d array
-       */
-      new_h = rk4(model, model->last_trans->cuboid[0][0],  p, 
-                  /* array size = grid size + EXTRA	*/
-                  model->rows * model->cols * model->n_layers + extra_nodes, &h,
-                  model->last_trans->cuboid[0][0], 
-                  /* the slope function callback is typecast accordingly */
-                  (slope_fn_ptr) slope_fn_grid);
-      new_h = MIN(new_h, time_elapsed-t-h);
+  if (model->config.expm_used) {
+      expm_step(get_expm_step(&model->expm_cache, model, p, 
+                              model->rows * model->cols * model->n_layers + extra_nodes,
+                              time_elapsed, (slope_fn_ptr) slope_fn_grid),
+                model, model->last_trans->cuboid[0][0], p, (slope_fn_ptr) slope_fn_grid);
+  } else {
+    for (t = 0, new_h = MIN_STEP; t < time_elapsed && new_h >= MIN_STEP*DELTA; t+=h) {
+        h = new_h;
+        /* pass the entire grid and the tail of package nodes 
+         * as a 1-d array
+         */
+        new_h = rk4(model, model->last_trans->cuboid[0][0],  p, 
+                    /* array size = grid size + EXTRA	*/
+                    model->rows * model->cols * model->n_layers + extra_nodes, &h,
+                    model->last_trans->cuboid[0][0], 
+                    /* the slope function callback is typecast accordingly */
+                    (slope_fn_ptr) slope_fn_grid);
+        new_h = MIN(new_h, time_elapsed-t-h);
 #if VERBOSE > 1
-      i++;
+        i++;
 #endif	
+    }
   }
 
 #if VERBOSE > 1
@@ -9,6 +9,7 @@
  * input in the form of a layer configuration file. 
  */
 #include "temperature.h"
+#include "thread_pool.h"
 
 #if SUPERLU > 0
 /* Lib for SuperLU */
@@ -25,6 +26,11 @@
 #define LCF_THICK			5	/* thickness	*/
 #define LCF_FLP				6	/* floorplan file	*/
 
+/* worker pool - per-worker slots in the scratch pad are a cache line apart	*/
+#define GRID_PAD				8
+/* grids with fewer cells per layer (e.g. the coarse multigrid levels) are solved serially	*/
+#define GRID_PARALLEL_MIN_CELLS	1024
+
 /* vector types - power / temperature	*/
 #define V_POWER				0
 #define V_TEMP				1
@@ -171,6 +177,13 @@ typedef struct grid_model_t_st
   /* block temperatures	*/
   double *last_temp;
 
+  /* propagators of the exact transient solver, per interval	*/
+  expm_step_t *expm_cache;
+
+  /* worker threads, NULL when solving serially	*/
+  thread_pool_t *pool;
+  double *pool_scratch;
+
   /* to allow for resizing	*/
   int base_n_units;
 }grid_model_t;
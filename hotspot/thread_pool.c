@@ -0,0 +1,144 @@
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "thread_pool.h"
+#include "util.h"
+
+struct thread_pool_t_st
+{
+	int n_threads;
+	pthread_t *threads;
+	pthread_mutex_t lock;
+	/* signals a new job (or termination) to the workers	*/
+	pthread_cond_t start;
+	/* signals the completion of the last chunk	*/
+	pthread_cond_t done;
+	/* incremented for every job	*/
+	unsigned long generation;
+	int pending;
+	int quit;
+	/* current job	*/
+	parallel_fn_ptr fn;
+	void *arg;
+	int n;
+};
+
+typedef struct worker_t_st
+{
+	thread_pool_t *pool;
+	int id;
+}worker_t;
+
+static void run_chunk(thread_pool_t *pool, int id)
+{
+	int begin = (int) ((long) pool->n * id / pool->n_threads);
+	int end = (int) ((long) pool->n * (id + 1) / pool->n_threads);
+
+	if (begin < end)
+		(*pool->fn)(pool->arg, id, begin, end);
+}
+
+static void *worker_main(void *data)
+{
+	worker_t *worker = (worker_t *) data;
+	thread_pool_t *pool = worker->pool;
+	unsigned long seen = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	while (1) {
+		while (pool->generation == seen && !pool->quit)
+			pthread_cond_wait(&pool->start, &pool->lock);
+		if (pool->quit)
+			break;
+		seen = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+
+		run_chunk(pool, worker->id);
+
+		pthread_mutex_lock(&pool->lock);
+		if (--pool->pending == 0)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	free(worker);
+	return NULL;
+}
+
+thread_pool_t *thread_pool_create(int n_threads)
+{
+	int i;
+	worker_t *worker;
+	thread_pool_t *pool = (thread_pool_t *) calloc (1, sizeof(thread_pool_t));
+
+	if (!pool)
+		fatal("memory allocation error\n");
+	pool->n_threads = MAX(n_threads, 1);
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+
+	pool->threads = (pthread_t *) calloc (pool->n_threads, sizeof(pthread_t));
+	if (!pool->threads)
+		fatal("memory allocation error\n");
+	for (i = 1; i < pool->n_threads; i++) {
+		worker = (worker_t *) malloc (sizeof(worker_t));
+		if (!worker)
+			fatal("memory allocation error\n");
+		worker->pool = pool;
+		worker->id = i;
+		if (pthread_create(&pool->threads[i], NULL, worker_main, worker))
+			fatal("unable to create worker thread\n");
+	}
+
+	return pool;
+}
+
+void thread_pool_destroy(thread_pool_t *pool)
+{
+	int i;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->quit = TRUE;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	for (i = 1; i < pool->n_threads; i++)
+		pthread_join(pool->threads[i], NULL);
+
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->start);
+	pthread_cond_destroy(&pool->done);
+	free(pool->threads);
+	free(pool);
+}
+
+int thread_pool_size(thread_pool_t *pool)
+{
+	return pool->n_threads;
+}
+
+void thread_pool_run(thread_pool_t *pool, int n, parallel_fn_ptr fn, void *arg)
+{
+	if (pool->n_threads == 1) {
+		if (n > 0)
+			(*fn)(arg, 0, 0, n);
+		return;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->fn = fn;
+	pool->arg = arg;
+	pool->n = n;
+	pool->pending = pool->n_threads - 1;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	run_chunk(pool, 0);
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->pending > 0)
+		pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,22 @@
+#ifndef __THREAD_POOL_H_
+#define __THREAD_POOL_H_
+
+/* 
+ * fixed-size pool of worker threads for data-parallel loops. the
+ * calling thread takes part as worker 0, so a pool of n_threads
+ * starts n_threads-1 additional threads.
+ */
+typedef struct thread_pool_t_st thread_pool_t;
+
+/* loop body - handles the iterations [begin, end)	*/
+typedef void (*parallel_fn_ptr)(void *arg, int worker, int begin, int end);
+
+thread_pool_t *thread_pool_create(int n_threads);
+void thread_pool_destroy(thread_pool_t *pool);
+int thread_pool_size(thread_pool_t *pool);
+/* split [0, n) into one contiguous chunk per worker and 
+ * return when all of them are done
+ */
+void thread_pool_run(thread_pool_t *pool, int n, parallel_fn_ptr fn, void *arg);
+
+#endif
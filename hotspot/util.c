@@ -237,9 +237,18 @@ double ***dcuboid_tail(int nr, int nc, int nl, int xtra)
 	/* 2-d array of pointers denoting (layer, row)	*/
 	m[0] = (double **) calloc (nl * nr, sizeof(double *));
 	assert(m[0] != NULL);
-	/* the actual 3-d data array	*/
+	/* the actual 3-d data array, contiguous and aligned to a 
+	 * cache line so that the rows split among the grid solver 
+	 * threads share as few lines as possible
+	 */
+	#ifdef _MSC_VER
 	m[0][0] = (double *) calloc (nl * nr * nc + xtra, sizeof(double));
 	assert(m[0][0] != NULL);
+	#else
+	if (posix_memalign((void **) &m[0][0], CACHE_LINE_SIZE, (nl * nr * nc + xtra) * sizeof(double)))
+		fatal("memory allocation error\n");
+	memset(m[0][0], 0, (nl * nr * nc + xtra) * sizeof(double));
+	#endif
 
 	/* remaining pointers of the 1-d pointer array	*/
 	for (i = 1; i < nl; i++)
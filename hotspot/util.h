@@ -23,6 +23,7 @@
 #define STR_SIZE		512
 #define LINE_SIZE		65536
 #define MAX_ENTRIES		512
+#define CACHE_LINE_SIZE	64
 
 int eq(double x, double y);
 int le(double x, double y);
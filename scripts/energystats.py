@@ -43,12 +43,68 @@ class Power:
         return Power(self.s - v.s, self.d - v.d)
 
 
+class Activity:
+    '''
+    Per-core activity rates (events per ns) of the statistics the McPAT input is derived from:
+    instruction mix, cache accesses and DRAM traffic.
+    '''
+
+    def __init__(self):
+        timer = 'interval_timer' if self.exists('interval_timer', 0, 'uop_generic') else 'rob_timer'
+        stats = [('performance_model', 'instruction_count'), ('performance_model', 'idle_elapsed_time')] + \
+                [(timer, 'uop_' + uop) for uop in ('fp_addsub', 'fp_muldiv', 'load', 'store', 'generic', 'branch')] + \
+                [('L1-I', 'loads'), ('L1-D', 'loads'), ('L1-D', 'stores'), ('L2', 'loads'), ('L2', 'stores'),
+                 ('dram', 'reads'), ('dram', 'writes')]
+        # Components that do not exist on a core (e.g. DRAM controllers) are left out of its vector
+        self.stats = [[stat for stat in stats if self.exists(stat[0], core, stat[1])]
+                      for core in range(sim.config.ncores)]
+        self.last = self.read()
+        self.time_last = sim.stats.time()
+
+    @staticmethod
+    def exists(objectName, index, metricName):
+        try:
+            sim.stats.get(objectName, index, metricName)
+            return True
+        except ValueError:
+            return False
+
+    def read(self):
+        return [[sim.stats.get(objectName, core, metricName) for objectName, metricName in self.stats[core]]
+                for core in range(sim.config.ncores)]
+
+    def update(self):
+        '''Rates since the previous call'''
+        current = self.read()
+        time_delta = float(max(1, sim.stats.time() - self.time_last)) / sim.util.Time.NS
+        rates = [[(c - l) / time_delta for c, l in zip(current[core], self.last[core])]
+                 for core in range(sim.config.ncores)]
+        self.last = current
+        self.time_last = sim.stats.time()
+        return rates
+
+    @staticmethod
+    def changed(rates, reference, threshold):
+        '''Whether any rate of any core moved by more than threshold (relative) from the reference'''
+        for core_rates, core_reference in zip(rates, reference):
+            for rate, ref in zip(core_rates, core_reference):
+                # Below one event per us a component is idle, don't react to noise around zero
+                if abs(rate - ref) > threshold * max(abs(rate), abs(ref), 1e-3):
+                    return True
+        return False
+
+
 class EnergyStats:
     def setup(self, args):
         args = dict(enumerate((args or '').split(':')))
 
         interval_ns = long(args.get(0, 100000))
 
+        self.enabled = sim.config.get('periodic_power/engine') != 'native'
+        if not self.enabled:
+            # Power, energy stats and thermal are computed inside the simulator (PowerThermalManager)
+            return
+
         sim.util.Every(interval_ns * sim.util.Time.NS,
                        self.periodic, roi_only=True)
         self.dvfs_table = build_dvfs_table(
@@ -60,6 +116,18 @@ class EnergyStats:
         self.in_stats_write = False
         self.power = {}
         self.energy = {}
+        # Lazy evaluation: while the activity stays within the threshold of the last epoch McPAT ran on,
+        # and no frequency or thread mapping changed, its power is reused instead of running McPAT again
+        self.lazy = sim.config.get_bool('periodic_power/lazy/enabled')
+        self.lazy_threshold = sim.config.get_float('periodic_power/lazy/threshold')
+        self.lazy_max_reused = sim.config.get_int('periodic_power/lazy/max_reused')
+        self.activity = None
+        self.activity_reference = None
+        self.frequencies_reference = None
+        self.mapping_changed = True
+        self.reused = 0
+        self.epochs_total = 0
+        self.epochs_reused = 0
         for metric in ('energy-static', 'energy-dynamic'):
             for core in range(sim.config.ncores):
                 sim.stats.register('core', core, metric, self.get_stat)
@@ -78,14 +146,28 @@ class EnergyStats:
         self.update()
 
     def hook_pre_stat_write(self, prefix):
-        if not self.in_stats_write:
-            self.update()
+        # Statistics snapshots (e.g. at the end of the ROI) always get a full McPAT evaluation
+        if self.enabled and not self.in_stats_write:
+            self.update(force=True)
+
+    def hook_thread_start(self, threadid, time):
+        self.mapping_changed = True
+
+    def hook_thread_exit(self, threadid, time):
+        self.mapping_changed = True
+
+    def hook_thread_migrate(self, threadid, coreid, time):
+        self.mapping_changed = True
 
     def hook_sim_end(self):
+        if not self.enabled:
+            return
         if self.name_last:
             sim.util.db_delete(self.name_last, True)
+        if self.lazy:
+            print '[ENERGYSTATS] McPAT power reused for %d of %d epochs' % (self.epochs_reused, self.epochs_total)
 
-    def update(self):
+    def update(self, force=False):
         if sim.stats.time() == self.time_last_power:
             # Time did not advance: don't recompute
             return
@@ -96,8 +178,13 @@ class EnergyStats:
         self.in_stats_write = False
         #   If we also have a previous snapshot: update power
         if self.name_last:
-            power = self.run_power(self.name_last, current)
+            reuse = self.can_reuse_power(force)
+            power = self.run_power(self.name_last, current, reuse)
             self.update_power(power)
+            self.epochs_total += 1
+            self.epochs_reused += reuse
+        elif self.lazy:
+            self.activity = Activity()
         #   Clean up previous last
         if self.name_last:
             sim.util.db_delete(self.name_last)
@@ -107,6 +194,27 @@ class EnergyStats:
         # Increment energy
         self.update_energy()
 
+    def can_reuse_power(self, force):
+        if not self.lazy:
+            return False
+        rates = self.activity.update()
+        frequencies = [sim.dvfs.get_frequency(core) for core in range(sim.config.ncores)]
+
+        reuse = not force and not self.mapping_changed \
+            and self.reused < self.lazy_max_reused \
+            and frequencies == self.frequencies_reference \
+            and not Activity.changed(rates, self.activity_reference, self.lazy_threshold)
+
+        if reuse:
+            self.reused += 1
+        else:
+            # McPAT runs on this epoch, which becomes the reference of the following ones
+            self.activity_reference = rates
+            self.frequencies_reference = frequencies
+            self.mapping_changed = False
+            self.reused = 0
+        return reuse
+
     def get_stat(self, objectName, index, metricName):
         if not self.in_stats_write:
             self.update()
@@ -158,17 +266,20 @@ vdd[] = %s
         cfg.close()
         return configfile
 
-    def run_power(self, name0, name1):
+    def run_power(self, name0, name1, reuse=False):
         outputbase = os.path.join(sim.config.output_dir, 'energystats-temp')
 
         configfile = self.gen_config(outputbase)
 
-        os.system('unset PYTHONHOME; %s -d %s -o %s -c %s --partial=%s:%s --no-graph --no-text' % (
+        # With --reuse-power, tools/mcpat.py skips McPAT and takes the power of its last run (outputbase.py),
+        # but still writes the logs and advances the thermal and reliability models over this epoch
+        os.system('unset PYTHONHOME; %s -d %s -o %s -c %s --partial=%s:%s --no-graph --no-text%s' % (
             os.path.join(os.getenv('SNIPER_ROOT'), 'tools/mcpat.py'),
             sim.config.output_dir,
             outputbase,
             configfile,
-            name0, name1
+            name0, name1,
+            ' --reuse-power' if reuse else ''
         ))
 
         result = {}
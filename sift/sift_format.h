@@ -18,6 +18,13 @@
 # define SIFT_USE_ZLIB 1
 #endif
 
+// Decompression of block-compressed traces on a helper thread (not with PinCRT, which has no std::thread)
+#if defined(PIN_CRT)
+# define SIFT_USE_THREADS 0
+#else
+# define SIFT_USE_THREADS 1
+#endif
+
 namespace Sift
 {
 
@@ -42,8 +49,56 @@ namespace Sift
       ArchIA32 = 2,
       IcacheVariable = 4,
       PhysicalAddress = 8,
+      CompressionBlock = 16,
    } Option;
 
+   // Block-compressed traces (CompressionBlock)
+   //
+   // After the header, the records are grouped in blocks of about BLOCK_SIZE bytes, each a BlockHeader followed
+   // by its independently compressed records. A zero-sized block ends the blocks. A block marked BlockSeekable
+   // starts at an instruction with fresh writer state (an InstructionExt record, and the ICACHE pages,
+   // address mappings and ISA it needs sent again), so reading can start there. Blocks that are cut short
+   // because the writer flushed (to wait for a response) are not seekable.
+   // The blocks are followed by an index of the seekable blocks (BlockIndexEntry), and a BlockFooter
+   // at the very end of the file to find it.
+
+   const uint32_t BLOCK_SIZE = 4 << 20;
+
+   typedef enum
+   {
+      BlockCodecNone,
+      BlockCodecZlib,
+   } BlockCodec;
+
+   typedef enum
+   {
+      BlockSeekable = 1,
+   } BlockFlags;
+
+   typedef struct
+   {
+      uint32_t compressed_size;  //< Size of the block after this header
+      uint32_t size;             //< Size of its records
+      uint8_t  codec;            //< BlockCodec
+      uint8_t  flags;            //< Bit field of BlockFlags
+      uint16_t reserved;
+   } __attribute__ ((__packed__)) BlockHeader;
+
+   typedef struct
+   {
+      uint64_t offset;           //< File offset of the BlockHeader
+      uint64_t icount;           //< Number of instructions before the block
+   } __attribute__ ((__packed__)) BlockIndexEntry;
+
+   const uint32_t BlockFooterMagic = 0x58494653; // "SFIX"
+
+   typedef struct
+   {
+      uint64_t index_offset;     //< File offset of the first BlockIndexEntry
+      uint64_t num_entries;
+      uint32_t magic;
+   } __attribute__ ((__packed__)) BlockFooter;
+
    typedef union
    {
       // Simple format for common instructions
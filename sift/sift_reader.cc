@@ -43,6 +43,10 @@ Sift::Reader::Reader(const char *filename, const char *response_filename, uint32
    , handleRoutineAnnounceFunc(NULL)
    , handleRoutineArg(NULL)   
    , filesize(0)
+   , inputstream(NULL)
+   , mapping(NULL)
+   , direct(false)
+   , blockinput(NULL)
    , last_address(0)
    , icache()
    , m_id(id)
@@ -71,14 +75,16 @@ Sift::Reader::~Reader()
 {
    free(m_filename);
    free(m_response_filename);
+   for(std::unordered_map<uint64_t, const uint8_t*>::iterator i = icache.begin() ; i != icache.end() ; ++i)
+   {
+      // Pages read in place point into the mapping
+      if (!(mapping && mapping->contains((*i).second)))
+         delete [] (*i).second;
+   }
    if (input)
       delete input;
    if (response)
       delete response;
-   for(std::unordered_map<uint64_t, const uint8_t*>::iterator i = icache.begin() ; i != icache.end() ; ++i)
-   {
-      delete [] (*i).second;
-   }
    for(std::unordered_map<uint64_t, const StaticInstruction*>::iterator i = scache.begin() ; i != scache.end() ; ++i)
    {
       delete (*i).second;
@@ -91,19 +97,39 @@ bool Sift::Reader::initStream()
    std::cerr << "[DEBUG:" << m_id << "] InitStream Attempting Open" << std::endl;
    #endif
 
-   inputstream = new std::ifstream(m_filename, std::ios::in);
-
-   if ((!inputstream->is_open()) || (!inputstream->good()))
+   // Trace files on disk are mapped into memory, FIFOs (live tracing) are read through a stream
+   struct stat filestatus;
+   if (stat(m_filename, &filestatus) == 0 && S_ISREG(filestatus.st_mode))
    {
-      std::cerr << "[SIFT:" << m_id << "] Cannot open " << m_filename << "\n";
-      return false;
+      mapping = new vimstream(m_filename);
+      if (mapping->is_open())
+      {
+         filesize = filestatus.st_size;
+         input = mapping;
+         direct = true;
+      }
+      else
+      {
+         delete mapping;
+         mapping = NULL;
+      }
    }
 
-   struct stat filestatus;
-   stat(m_filename, &filestatus);
-   filesize = filestatus.st_size;
+   if (!input)
+   {
+      inputstream = new std::ifstream(m_filename, std::ios::in);
+
+      if ((!inputstream->is_open()) || (!inputstream->good()))
+      {
+         std::cerr << "[SIFT:" << m_id << "] Cannot open " << m_filename << "\n";
+         return false;
+      }
+
+      stat(m_filename, &filestatus);
+      filesize = filestatus.st_size;
 
-   input = new vifstream(inputstream);
+      input = new vifstream(inputstream);
+   }
 
    Sift::Header hdr;
    input->read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
@@ -117,10 +143,18 @@ bool Sift::Reader::initStream()
       std::cerr << "[SIFT:" << m_id << "] Invalid header size\n";
    }
 
+   if (hdr.options & CompressionBlock)
+   {
+      input = blockinput = new ibzstream(input, mapping, sizeof(hdr));
+      direct = false;
+      hdr.options &= ~CompressionBlock;
+   }
+
 #if SIFT_USE_ZLIB
    if (hdr.options & CompressionZlib)
    {
       input = new izstream(input);
+      direct = false;
       hdr.options &= ~CompressionZlib;
    }
 #else
@@ -184,6 +218,39 @@ bool Sift::Reader::initResponse()
    return true;
 }
 
+// Reads from the mapping are not virtual calls (vimstream is final), and compile down to a few loads
+inline void Sift::Reader::readInput(char *data, size_t size)
+{
+   if (direct)
+      mapping->read(data, size);
+   else
+      input->read(data, size);
+}
+
+inline int Sift::Reader::peekInput()
+{
+   return direct ? mapping->peek() : input->peek();
+}
+
+uint8_t* Sift::Reader::getWritableIcachePage(uint64_t base_addr)
+{
+   std::unordered_map<uint64_t, const uint8_t*>::iterator it = icache.find(base_addr);
+   if (it == icache.end())
+   {
+      uint8_t *page = new uint8_t[ICACHE_SIZE];
+      icache[base_addr] = page;
+      return page;
+   }
+   if (mapping && mapping->contains(it->second))
+   {
+      // Page read in place from the mapping, which is read-only: copy it before it is updated
+      uint8_t *page = new uint8_t[ICACHE_SIZE];
+      memcpy(page, it->second, ICACHE_SIZE);
+      it->second = page;
+   }
+   return const_cast<uint8_t*>(it->second);
+}
+
 bool Sift::Reader::Read(Instruction &inst)
 {
    if (input == NULL)
@@ -198,7 +265,7 @@ bool Sift::Reader::Read(Instruction &inst)
    while(!m_seen_end)
    {
       Record rec;
-      uint8_t byte = input->peek();
+      uint8_t byte = peekInput();
       if (input->fail())
       {
          std::cerr << "[SIFT:" << m_id << "] Error: " << strerror(errno) << "\n";
@@ -208,7 +275,7 @@ bool Sift::Reader::Read(Instruction &inst)
       if (byte == 0)
       {
          // Other
-         input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+         readInput(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
          switch(rec.Other.type)
          {
             case RecOtherEnd:
@@ -221,10 +288,21 @@ bool Sift::Reader::Read(Instruction &inst)
             {
                assert(rec.Other.size == sizeof(uint64_t) + ICACHE_SIZE);
                uint64_t address;
-               uint8_t *bytes = new uint8_t[ICACHE_SIZE];
-               input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(bytes), ICACHE_SIZE);
-               icache[address] = bytes;
+               readInput(reinterpret_cast<char*>(&address), sizeof(uint64_t));
+               std::unordered_map<uint64_t, const uint8_t*>::iterator it = icache.find(address);
+               if (it != icache.end() && !(mapping && mapping->contains(it->second)))
+                  delete [] it->second;
+               if (direct)
+               {
+                  // Use the page in place
+                  icache[address] = mapping->map(ICACHE_SIZE);
+               }
+               else
+               {
+                  uint8_t *bytes = new uint8_t[ICACHE_SIZE];
+                  readInput(reinterpret_cast<char*>(bytes), ICACHE_SIZE);
+                  icache[address] = bytes;
+               }
                break;
             }
             case RecOtherIcacheVariable:
@@ -235,16 +313,15 @@ bool Sift::Reader::Read(Instruction &inst)
                #endif
                uint64_t address;
                size_t size = rec.Other.size - sizeof(uint64_t);
-               input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&address), sizeof(uint64_t));
                size_t size_left = size;
                while (size_left > 0)
                {
                   uint64_t base_addr = address & ICACHE_PAGE_MASK;
-                  if (icache.count(base_addr) == 0)
-                     icache[base_addr] = new uint8_t[ICACHE_SIZE];
+                  uint8_t *page = getWritableIcachePage(base_addr);
                   uint64_t offset = address & ICACHE_OFFSET_MASK;
                   size_t read_amount = std::min(size_left, size_t(ICACHE_SIZE - offset));
-                  input->read(const_cast<char*>(reinterpret_cast<const char*>(&(icache[base_addr][offset]))), read_amount);
+                  readInput(reinterpret_cast<char*>(&page[offset]), read_amount);
 
                   #if VERBOSE_ICACHE
                   std::cerr << __FUNCTION__ << ": Wrote " << read_amount << " bytes to 0x" << std::hex << (void*)&(icache[base_addr][offset]) << std::dec << std::endl;
@@ -260,8 +337,8 @@ bool Sift::Reader::Read(Instruction &inst)
             {
                assert(rec.Other.size == 2 * sizeof(uint64_t));
                uint64_t vp, pp;
-               input->read(reinterpret_cast<char*>(&vp), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&pp), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&vp), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&pp), sizeof(uint64_t));
                vcache[vp] = pp;
                break;
             }
@@ -272,7 +349,7 @@ bool Sift::Reader::Read(Instruction &inst)
                #endif
                assert(rec.Other.size == sizeof(uint32_t));
                uint32_t icount;
-               input->read(reinterpret_cast<char*>(&icount), sizeof(icount));
+               readInput(reinterpret_cast<char*>(&icount), sizeof(icount));
                Mode mode = ModeUnknown;
                if (handleInstructionCountFunc)
                   mode = handleInstructionCountFunc(handleInstructionCountArg, icount);
@@ -287,10 +364,10 @@ bool Sift::Reader::Read(Instruction &inst)
                assert(rec.Other.size == sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint64_t));
                uint8_t icount, type;
                uint64_t eip, address;
-               input->read(reinterpret_cast<char*>(&icount), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(&type), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&icount), sizeof(uint8_t));
+               readInput(reinterpret_cast<char*>(&type), sizeof(uint8_t));
+               readInput(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&address), sizeof(uint64_t));
                if (handleCacheOnlyFunc)
                   handleCacheOnlyFunc(handleCacheOnlyArg, icount, (Sift::CacheOnlyType)type, eip, address);
                break;
@@ -304,8 +381,8 @@ bool Sift::Reader::Read(Instruction &inst)
                uint8_t fd;
                uint32_t size = rec.Other.size - sizeof(uint8_t);
                uint8_t *bytes = new uint8_t[size];
-               input->read(reinterpret_cast<char*>(&fd), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(bytes), size);
+               readInput(reinterpret_cast<char*>(&fd), sizeof(uint8_t));
+               readInput(reinterpret_cast<char*>(bytes), size);
                if (handleOutputFunc)
                   handleOutputFunc(handleOutputArg, fd, bytes, size);
                delete [] bytes;
@@ -320,8 +397,8 @@ bool Sift::Reader::Read(Instruction &inst)
                uint16_t syscall_number;
                uint32_t size = rec.Other.size - sizeof(uint16_t);
                uint8_t *bytes = new uint8_t[size];
-               input->read(reinterpret_cast<char*>(&syscall_number), sizeof(uint16_t));
-               input->read(reinterpret_cast<char*>(bytes), size);
+               readInput(reinterpret_cast<char*>(&syscall_number), sizeof(uint16_t));
+               readInput(reinterpret_cast<char*>(bytes), size);
                #if VERBOSE_HEX > 0
                hexdump((char*)&rec, sizeof(rec.Other));
                hexdump((char*)&syscall_number, sizeof(syscall_number));
@@ -367,7 +444,7 @@ bool Sift::Reader::Read(Instruction &inst)
             {
                int32_t thread;
                assert(rec.Other.size == sizeof(thread));
-               input->read(reinterpret_cast<char*>(&thread), sizeof(thread));
+               readInput(reinterpret_cast<char*>(&thread), sizeof(thread));
                assert(handleJoinFunc);
                if (handleJoinFunc)
                {
@@ -412,9 +489,9 @@ bool Sift::Reader::Read(Instruction &inst)
             {
                assert(rec.Other.size == 3 * sizeof(uint64_t));
                uint64_t a, b, c;
-               input->read(reinterpret_cast<char*>(&a), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&b), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&c), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&a), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&b), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&c), sizeof(uint64_t));
                uint64_t result;
                if (handleMagicFunc)
                {
@@ -431,8 +508,8 @@ bool Sift::Reader::Read(Instruction &inst)
             {
                assert(rec.Other.size <= sizeof(uint16_t) + sizeof(EmuRequest));
                uint16_t type; EmuRequest req;
-               input->read(reinterpret_cast<char*>(&type), sizeof(uint16_t));
-               input->read(reinterpret_cast<char*>(&req), rec.Other.size - sizeof(uint16_t));
+               readInput(reinterpret_cast<char*>(&type), sizeof(uint16_t));
+               readInput(reinterpret_cast<char*>(&req), rec.Other.size - sizeof(uint16_t));
                bool result = false; EmuReply res = {};
                if (handleEmuFunc)
                {
@@ -446,10 +523,10 @@ bool Sift::Reader::Read(Instruction &inst)
                assert(rec.Other.size == sizeof(uint8_t) + 3 * sizeof(uint64_t));
                uint8_t event;
                uint64_t eip, esp, callEip;
-               input->read(reinterpret_cast<char*>(&event), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&esp), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&callEip), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&event), sizeof(uint8_t));
+               readInput(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&esp), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&callEip), sizeof(uint64_t));
                if (handleRoutineChangeFunc)
                   handleRoutineChangeFunc(handleRoutineArg, Sift::RoutineOpType(event), eip, esp, callEip);
                break;
@@ -460,19 +537,19 @@ bool Sift::Reader::Read(Instruction &inst)
                uint16_t len_name, len_imgname, len_filename;
                char *name, *imgname, *filename;
                uint32_t line, column;
-               input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&len_name), sizeof(uint16_t));
+               readInput(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&len_name), sizeof(uint16_t));
                name = (char*)malloc(len_name);
-               input->read(name, len_name);
-               input->read(reinterpret_cast<char*>(&len_imgname), sizeof(uint16_t));
+               readInput(name, len_name);
+               readInput(reinterpret_cast<char*>(&len_imgname), sizeof(uint16_t));
                imgname = (char*)malloc(len_imgname);
-               input->read(imgname, len_imgname);
-               input->read(reinterpret_cast<char*>(&offset), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&line), sizeof(uint32_t));
-               input->read(reinterpret_cast<char*>(&column), sizeof(uint32_t));
-               input->read(reinterpret_cast<char*>(&len_filename), sizeof(uint16_t));
+               readInput(imgname, len_imgname);
+               readInput(reinterpret_cast<char*>(&offset), sizeof(uint64_t));
+               readInput(reinterpret_cast<char*>(&line), sizeof(uint32_t));
+               readInput(reinterpret_cast<char*>(&column), sizeof(uint32_t));
+               readInput(reinterpret_cast<char*>(&len_filename), sizeof(uint16_t));
                filename = (char*)malloc(len_filename);
-               input->read(filename, len_filename);
+               readInput(filename, len_filename);
                if (handleRoutineAnnounceFunc)
                   handleRoutineAnnounceFunc(handleRoutineArg, eip, name, imgname, offset, line, column, filename);
                free(name);
@@ -483,7 +560,7 @@ bool Sift::Reader::Read(Instruction &inst)
             { 
                assert(rec.Other.size == sizeof(uint32_t));
                uint32_t new_isa;
-               input->read(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
+               readInput(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
                m_isa = new_isa; // save here new ISA mode value
 
                break;
@@ -491,7 +568,7 @@ bool Sift::Reader::Read(Instruction &inst)
             default:
             {
                uint8_t *bytes = new uint8_t[rec.Other.size];
-               input->read(reinterpret_cast<char*>(bytes), rec.Other.size);
+               readInput(reinterpret_cast<char*>(bytes), rec.Other.size);
                delete [] bytes;
                break;
             }
@@ -505,7 +582,7 @@ bool Sift::Reader::Read(Instruction &inst)
       if ((byte & 0xf) != 0)
       {
          // Instruction
-         input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Instruction));
+         readInput(reinterpret_cast<char*>(&rec), sizeof(rec.Instruction));
 
          #if VERBOSE_HEX > 2
          hexdump(&rec, sizeof(rec.Instruction));
@@ -523,7 +600,7 @@ bool Sift::Reader::Read(Instruction &inst)
       else
       {
          // InstructionExt
-         input->read(reinterpret_cast<char*>(&rec), sizeof(rec.InstructionExt));
+         readInput(reinterpret_cast<char*>(&rec), sizeof(rec.InstructionExt));
 
          #if VERBOSE_HEX > 2
          hexdump(&rec, sizeof(rec.InstructionExt));
@@ -544,7 +621,7 @@ bool Sift::Reader::Read(Instruction &inst)
       last_address += size;
 
       for(int i = 0; i < inst.num_addresses; ++i)
-         input->read(reinterpret_cast<char*>(&inst.addresses[i]), sizeof(uint64_t));
+         readInput(reinterpret_cast<char*>(&inst.addresses[i]), sizeof(uint64_t));
 
       inst.sinst = getStaticInstruction(addr, size);
 
@@ -789,9 +866,35 @@ void Sift::Reader::sendSimpleResponse(RecOtherType type, void *data, uint32_t si
    response->flush();
 }
 
+bool Sift::Reader::Seek(uint64_t &icount)
+{
+   if (input == NULL)
+   {
+      if (!initStream())
+      {
+         std::cerr << "[SIFT:" << m_id << "] Error: initStream failed\n";
+         return false;
+      }
+   }
+
+   if (!blockinput || !blockinput->seek(icount))
+      return false;
+
+   // Seekable blocks start with fresh writer state
+   last_address = 0;
+   m_last_sinst = NULL;
+   m_isa = 0;
+   m_seen_end = false;
+   return true;
+}
+
 uint64_t Sift::Reader::getPosition()
 {
-   if (inputstream)
+   if (blockinput)
+      return blockinput->tellg();
+   else if (mapping)
+      return mapping->tellg();
+   else if (inputstream)
       return inputstream->tellg();
    else
       return 0;
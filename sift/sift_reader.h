@@ -13,6 +13,8 @@
 #include <cassert>
 
 class vistream;
+class vimstream;
+class ibzstream;
 class vostream;
 
 namespace Sift
@@ -83,6 +85,9 @@ namespace Sift
          void *handleRoutineArg;
          uint64_t filesize;
          std::ifstream *inputstream;
+         vimstream *mapping;  //< Trace file mapped into memory, NULL when reading from a stream (FIFO)
+         bool direct;         //< Records are read from the mapping itself (not through decompression)
+         ibzstream *blockinput;  //< Input of a block-compressed trace, NULL otherwise
 
          char *m_filename;
          char *m_response_filename;
@@ -104,6 +109,9 @@ namespace Sift
          int m_isa;
 
          bool initResponse();
+         void readInput(char *data, size_t size);
+         int peekInput();
+         uint8_t* getWritableIcachePage(uint64_t base_addr);
          const Sift::StaticInstruction* staticInfoInstruction(uint64_t addr, uint8_t size);
          const Sift::StaticInstruction* getStaticInstruction(uint64_t addr, uint8_t size);
          void sendSyscallResponse(uint64_t return_code);
@@ -115,6 +123,9 @@ namespace Sift
          ~Reader();
          bool initStream();
          bool Read(Instruction&);
+         // Block-compressed trace files: continue at the last seekable block that starts at or before instruction
+         // icount, and set icount to the number of the instruction that Read returns next. False if the trace cannot be seeked.
+         bool Seek(uint64_t &icount);
          bool AccessMemory(MemoryLockType lock_signal, MemoryOpType mem_op, uint64_t d_addr, uint8_t *data_buffer, uint32_t data_size);
 
          void setHandleInstructionCountFunc(HandleInstructionCountFunc func, void* arg = NULL) { handleInstructionCountFunc = func; handleInstructionCountArg = arg; }
@@ -35,8 +35,9 @@ __sift_assert_fail(__const char *__assertion, __const char *__file,
 }
 
 
-Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression, const char *response_filename, uint32_t id, bool arch32, bool requires_icache_per_insn, bool send_va2pa_mapping, GetCodeFunc2 getCodeFunc2, void* getCodeFunc2Data)
-   : response(NULL)
+Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression, const char *response_filename, uint32_t id, bool arch32, bool requires_icache_per_insn, bool send_va2pa_mapping, GetCodeFunc2 getCodeFunc2, void* getCodeFunc2Data, bool useBlockCompression)
+   : blockoutput(NULL)
+   , response(NULL)
    , getCodeFunc(getCodeFunc)
    , getCodeFunc2(getCodeFunc2)
    , getCodeFunc2Data(getCodeFunc2Data)
@@ -52,6 +53,7 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
    , m_id(id)
    , m_requires_icache_per_insn(requires_icache_per_insn)
    , m_send_va2pa_mapping(send_va2pa_mapping)
+   , m_isa(0)
 {
    memset(hsize, 0, sizeof(hsize));
    memset(haddr, 0, sizeof(haddr));
@@ -59,6 +61,12 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
    m_response_filename = strdup(response_filename);
 
    uint64_t options = 0;
+   if (useBlockCompression)
+   {
+      // Blocks are compressed on their own (when zlib is available), not as one stream
+      options |= CompressionBlock;
+      useCompression = false;
+   }
 #if SIFT_USE_ZLIB
    if (useCompression)
       options |= CompressionZlib;
@@ -91,6 +99,8 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
    output->write(reinterpret_cast<char*>(&hdr), sizeof(hdr));
    output->flush();
 
+   if (options & CompressionBlock)
+      output = blockoutput = new obzstream(output, sizeof(hdr));
    if (options & CompressionZlib)
       output = new ozstream(output);
 }
@@ -147,8 +157,10 @@ void Sift::Writer::End()
 
    if (output)
    {
+      // A block-compressed output writes its last block and the index
       delete output;
       output = NULL;
+      blockoutput = NULL;
    }
 }
 
@@ -180,6 +192,17 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
       return;
    }
 
+   if (blockoutput && blockoutput->full())
+   {
+      // Start a block that can be read on its own: forget what was sent before
+      blockoutput->startBlock(ninstrs);
+      last_address = 0;
+      icache.clear();
+      m_va2pa.clear();
+      if (m_isa)
+         ISAChange(m_isa);
+   }
+
    if (m_requires_icache_per_insn)
    {
       if (! icache[addr])
@@ -872,6 +895,8 @@ void Sift::Writer::ISAChange(uint32_t new_isa)
    std::cerr << "[DEBUG:" << m_id << "] Write ISAChange" << std::endl;
    #endif
 
+   m_isa = new_isa;
+
    if (!output)
    {
       return;
@@ -10,6 +10,7 @@
 
 class vistream;
 class vostream;
+class obzstream;
 
 namespace Sift
 {
@@ -21,6 +22,7 @@ namespace Sift
 
       private:
          vostream *output;
+         obzstream *blockoutput;  //< Output of a block-compressed trace, NULL otherwise
          vistream *response;
          GetCodeFunc getCodeFunc;
          GetCodeFunc2 getCodeFunc2;
@@ -37,6 +39,7 @@ namespace Sift
          uint32_t m_id;
          bool m_requires_icache_per_insn;
          bool m_send_va2pa_mapping;
+         uint32_t m_isa;
 
          void initResponse();
          void handleMemoryRequest(Record &respRec);
@@ -44,7 +47,7 @@ namespace Sift
          uint64_t va2pa_lookup(uint64_t va);
 
       public:
-         Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression = false, const char *response_filename = "", uint32_t id = 0, bool arch32 = false, bool requires_icache_per_insn = false, bool send_va2pa_mapping = false, GetCodeFunc2 getCodeFunc2 = NULL, void *GetCodeFunc2Data = NULL);
+         Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression = false, const char *response_filename = "", uint32_t id = 0, bool arch32 = false, bool requires_icache_per_insn = false, bool send_va2pa_mapping = false, GetCodeFunc2 getCodeFunc2 = NULL, void *GetCodeFunc2Data = NULL, bool useBlockCompression = false);
          ~Writer();
          void End();
          void Instruction(uint64_t addr, uint8_t size, uint8_t num_addresses, uint64_t addresses[], bool is_branch, bool taken, bool is_predicate, bool executed);
@@ -1,6 +1,62 @@
 #include "zfstream.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+vimstream::vimstream(const char *filename)
+   : m_map(NULL)
+   , m_pos(NULL)
+   , m_end(NULL)
+   , m_advised(NULL)
+   , m_dropped(NULL)
+   , m_fail(true)
+{
+   int fd = open(filename, O_RDONLY);
+   if (fd < 0)
+      return;
+
+   struct stat filestatus;
+   if (fstat(fd, &filestatus) == 0 && S_ISREG(filestatus.st_mode) && filestatus.st_size > 0)
+   {
+      void *map = mmap(NULL, filestatus.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED)
+      {
+         m_map = m_pos = m_advised = m_dropped = static_cast<const char*>(map);
+         m_end = m_map + filestatus.st_size;
+         m_fail = false;
+         madvise(map, filestatus.st_size, MADV_SEQUENTIAL);
+         advise();
+      }
+   }
+   // The mapping stays valid after the file is closed
+   close(fd);
+}
+
+vimstream::~vimstream()
+{
+   if (m_map)
+      munmap(const_cast<char*>(m_map), m_end - m_map);
+}
+
+void vimstream::advise()
+{
+   // Prefetch the next window, and drop the one before the current window
+   const size_t page_mask = ~(size_t(sysconf(_SC_PAGESIZE)) - 1);
+   const char *start = m_map + (size_t(m_pos - m_map) & page_mask);
+   const char *end = std::min(start + window, m_end);
+   madvise(const_cast<char*>(start), end - start, MADV_WILLNEED);
+   if (size_t(start - m_map) > window && start - window > m_dropped)
+   {
+      madvise(const_cast<char*>(m_dropped), start - window - m_dropped, MADV_DONTNEED);
+      m_dropped = start - window;
+   }
+   m_advised = end == m_end ? m_end : start + window / 2;
+}
 
 #if !SIFT_USE_ZLIB
 
@@ -160,3 +216,336 @@ int izstream::peek()
 }
 
 #endif /*SIFT_USE_ZLIB*/
+
+
+obzstream::obzstream(vostream *output, uint64_t offset)
+   : output(output)
+   , m_offset(offset)
+   , m_seekable(true)
+   , m_icount(0)
+{
+   m_block.reserve(Sift::BLOCK_SIZE + Sift::ICACHE_SIZE);
+}
+
+obzstream::~obzstream()
+{
+   writeBlock();
+
+   Sift::BlockHeader end = {};
+   output->write(reinterpret_cast<char*>(&end), sizeof(end));
+
+   Sift::BlockFooter footer;
+   footer.index_offset = m_offset + sizeof(end);
+   footer.num_entries = m_index.size();
+   footer.magic = Sift::BlockFooterMagic;
+   if (!m_index.empty())
+      output->write(reinterpret_cast<char*>(&m_index[0]), m_index.size() * sizeof(Sift::BlockIndexEntry));
+   output->write(reinterpret_cast<char*>(&footer), sizeof(footer));
+   output->flush();
+
+   delete output;
+}
+
+void obzstream::startBlock(uint64_t icount)
+{
+   writeBlock();
+   m_seekable = true;
+   m_icount = icount;
+}
+
+void obzstream::writeBlock()
+{
+   if (m_block.empty())
+      return;
+
+   Sift::BlockHeader hdr = {};
+   hdr.size = m_block.size();
+   hdr.flags = m_seekable ? Sift::BlockSeekable : 0;
+
+   const char *data = &m_block[0];
+   hdr.codec = Sift::BlockCodecNone;
+   hdr.compressed_size = hdr.size;
+#if SIFT_USE_ZLIB
+   uLongf compressed_size = compressBound(hdr.size);
+   m_compressed.resize(compressed_size);
+   int ret = compress2((Bytef*)&m_compressed[0], &compressed_size, (const Bytef*)&m_block[0], hdr.size, level);
+   assert(ret == Z_OK);
+   // Keep blocks that do not compress as they are
+   if (compressed_size < hdr.size)
+   {
+      data = &m_compressed[0];
+      hdr.codec = Sift::BlockCodecZlib;
+      hdr.compressed_size = compressed_size;
+   }
+#endif
+
+   if (m_seekable)
+   {
+      Sift::BlockIndexEntry entry = { m_offset, m_icount };
+      m_index.push_back(entry);
+   }
+
+   output->write(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+   output->write(data, hdr.compressed_size);
+   m_offset += sizeof(hdr) + hdr.compressed_size;
+
+   m_block.clear();
+   m_seekable = false;
+}
+
+
+
+ibzstream::ibzstream(vistream *input, vimstream *mapping, uint64_t offset)
+   : input(input)
+   , mapping(mapping)
+   , m_offset(offset)
+   , m_input_done(false)
+   , m_block(NULL)
+   , m_pos(0)
+   , m_position(offset)
+   , m_fail(false)
+   , m_index_loaded(false)
+#if SIFT_USE_THREADS
+   , m_stop(false)
+   , m_done(false)
+#endif
+{
+#if SIFT_USE_THREADS
+   startHelper();
+#endif
+}
+
+ibzstream::~ibzstream()
+{
+#if SIFT_USE_THREADS
+   stopHelper();
+#endif
+   delete m_block;
+   delete input;
+}
+
+ibzstream::Block* ibzstream::readBlock()
+{
+   if (m_input_done)
+      return NULL;
+
+   Sift::BlockHeader hdr;
+   input->read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+   if (input->fail() || (hdr.size == 0 && hdr.compressed_size == 0))
+   {
+      m_input_done = true;
+      return NULL;
+   }
+
+   const char *data;
+   if (mapping)
+   {
+      data = reinterpret_cast<const char*>(mapping->map(hdr.compressed_size));
+   }
+   else
+   {
+      m_compressed.resize(hdr.compressed_size);
+      input->read(&m_compressed[0], hdr.compressed_size);
+      data = input->fail() ? NULL : &m_compressed[0];
+   }
+   if (!data)
+   {
+      std::cerr << "[SIFT] Truncated block at offset " << m_offset << std::endl;
+      m_input_done = true;
+      return NULL;
+   }
+
+   Block *block = new Block();
+   block->data.resize(hdr.size);
+   switch(hdr.codec)
+   {
+      case Sift::BlockCodecNone:
+         assert(hdr.compressed_size == hdr.size);
+         memcpy(&block->data[0], data, hdr.size);
+         break;
+#if SIFT_USE_ZLIB
+      case Sift::BlockCodecZlib:
+      {
+         uLongf size = hdr.size;
+         int ret = uncompress((Bytef*)&block->data[0], &size, (const Bytef*)data, hdr.compressed_size);
+         if (ret != Z_OK || size != hdr.size)
+         {
+            std::cerr << "[SIFT] Corrupt block at offset " << m_offset << std::endl;
+            delete block;
+            m_input_done = true;
+            return NULL;
+         }
+         break;
+      }
+#endif
+      default:
+         std::cerr << "[SIFT] Unsupported codec " << int(hdr.codec) << " of block at offset " << m_offset << std::endl;
+         delete block;
+         m_input_done = true;
+         return NULL;
+   }
+
+   m_offset += sizeof(hdr) + hdr.compressed_size;
+   block->end_offset = m_offset;
+   return block;
+}
+
+#if SIFT_USE_THREADS
+
+void ibzstream::startHelper()
+{
+   m_stop = false;
+   m_done = false;
+   m_thread = std::thread(&ibzstream::helper, this);
+}
+
+void ibzstream::stopHelper()
+{
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+   }
+   m_cond.notify_all();
+   m_thread.join();
+
+   while (!m_ready.empty())
+   {
+      delete m_ready.front();
+      m_ready.pop_front();
+   }
+}
+
+void ibzstream::helper()
+{
+   while (true)
+   {
+      {
+         std::unique_lock<std::mutex> lock(m_mutex);
+         m_cond.wait(lock, [this] { return m_stop || m_ready.size() < depth; });
+         if (m_stop)
+            return;
+      }
+
+      Block *block = readBlock();
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (block)
+         m_ready.push_back(block);
+      else
+         m_done = true;
+      m_cond.notify_all();
+      if (!block)
+         return;
+   }
+}
+
+#endif /*SIFT_USE_THREADS*/
+
+bool ibzstream::nextBlock()
+{
+   delete m_block;
+   m_block = NULL;
+   m_pos = 0;
+
+#if SIFT_USE_THREADS
+   std::unique_lock<std::mutex> lock(m_mutex);
+   m_cond.wait(lock, [this] { return !m_ready.empty() || m_done; });
+   if (m_ready.empty())
+      return false;
+   m_block = m_ready.front();
+   m_ready.pop_front();
+   m_cond.notify_all();
+#else
+   m_block = readBlock();
+   if (!m_block)
+      return false;
+#endif
+
+   m_position = m_block->end_offset;
+   return true;
+}
+
+void ibzstream::read(char* s, std::streamsize n)
+{
+   while (n > 0)
+   {
+      if (!m_block || m_pos == m_block->data.size())
+      {
+         if (!nextBlock())
+         {
+            m_fail = true;
+            return;
+         }
+         continue;
+      }
+      size_t amount = std::min(size_t(n), m_block->data.size() - m_pos);
+      memcpy(s, &m_block->data[m_pos], amount);
+      m_pos += amount;
+      s += amount;
+      n -= amount;
+   }
+}
+
+int ibzstream::peek()
+{
+   while (!m_block || m_pos == m_block->data.size())
+   {
+      if (!nextBlock())
+      {
+         m_fail = true;
+         return EOF;
+      }
+   }
+   return (uint8_t)m_block->data[m_pos];
+}
+
+bool ibzstream::loadIndex()
+{
+   if (!m_index_loaded)
+   {
+      m_index_loaded = true;
+      if (mapping->size() < sizeof(Sift::BlockFooter))
+         return false;
+      Sift::BlockFooter footer;
+      memcpy(&footer, mapping->at(mapping->size() - sizeof(footer)), sizeof(footer));
+      if (footer.magic != Sift::BlockFooterMagic
+          || footer.index_offset + footer.num_entries * sizeof(Sift::BlockIndexEntry) + sizeof(footer) != mapping->size())
+      {
+         std::cerr << "[SIFT] Block index not found, the trace was not completely written" << std::endl;
+         return false;
+      }
+      m_index.resize(footer.num_entries);
+      if (footer.num_entries)
+         memcpy(&m_index[0], mapping->at(footer.index_offset), footer.num_entries * sizeof(Sift::BlockIndexEntry));
+   }
+   return !m_index.empty();
+}
+
+bool ibzstream::seek(uint64_t &icount)
+{
+   if (!mapping || !loadIndex())
+      return false;
+
+   // Last block that starts at or before icount (the first block starts at instruction zero)
+   size_t entry = 0;
+   while (entry + 1 < m_index.size() && m_index[entry + 1].icount <= icount)
+      ++entry;
+
+#if SIFT_USE_THREADS
+   stopHelper();
+#endif
+   delete m_block;
+   m_block = NULL;
+   m_pos = 0;
+
+   mapping->seekg(m_index[entry].offset);
+   m_offset = m_position = m_index[entry].offset;
+   m_input_done = false;
+   m_fail = false;
+#if SIFT_USE_THREADS
+   startHelper();
+#endif
+
+   icount = m_index[entry].icount;
+   return true;
+}
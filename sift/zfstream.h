@@ -6,6 +6,18 @@
 #include <ostream>
 #include <istream>
 #include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+#include <deque>
+
+#if SIFT_USE_THREADS
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+#endif
 
 #if SIFT_USE_ZLIB
 # include <zlib.h>
@@ -64,6 +76,36 @@ class ozstream : public vostream
          { return output->is_open(); }
 };
 
+// Output in independently compressed blocks (CompressionBlock, see sift_format.h)
+class obzstream : public vostream
+{
+   private:
+      vostream *output;
+      uint64_t m_offset;            //< File offset of the next block
+      std::vector<char> m_block;
+      std::vector<char> m_compressed;
+      bool m_seekable;              //< The current block starts with fresh writer state
+      uint64_t m_icount;            //< Instructions before the current block
+      std::vector<Sift::BlockIndexEntry> m_index;
+      static const int level = 6;
+      void writeBlock();
+   public:
+      obzstream(vostream *output, uint64_t offset);
+      virtual ~obzstream();
+      virtual void write(const char* s, std::streamsize n)
+         { m_block.insert(m_block.end(), s, s + n); }
+      // Data is only sent once its block is done, so flushing (when waiting for a response) ends the block
+      virtual void flush()
+         { writeBlock(); output->flush(); }
+      virtual bool fail()
+         { return output->fail(); }
+      virtual bool is_open()
+         { return output->is_open(); }
+      // When the current block is full, the writer starts a new seekable block at the next instruction
+      bool full() const { return m_block.size() >= Sift::BLOCK_SIZE; }
+      void startBlock(uint64_t icount);
+};
+
 
 
 class vistream
@@ -92,6 +134,126 @@ class vifstream : public vistream
       virtual bool fail() const { return stream->fail(); }
 };
 
+// Input from a file mapped into memory: records are read straight from the mapping instead of being copied
+// through an ifstream. Only for regular files (not for the FIFOs used when tracing live). The kernel is told
+// the file is read sequentially; pages of the window ahead are prefetched, and those well behind dropped
+// so the resident size of multi-gigabyte traces stays small (they are read back from the file if touched again).
+class vimstream final : public vistream
+{
+   private:
+      const char *m_map;
+      const char *m_pos;
+      const char *m_end;
+      const char *m_advised;  //< Position at which the next window is prefetched
+      const char *m_dropped;  //< Pages before this were dropped
+      bool m_fail;
+      static const size_t window = 16*1024*1024;
+      void advise();
+   public:
+      vimstream(const char *filename);
+      virtual ~vimstream();
+      bool is_open() const { return m_map != NULL; }
+      virtual void read(char* s, std::streamsize n)
+      {
+         if (m_pos + n > m_end)
+         {
+            // Like ifstream: copy what is left, and fail
+            n = m_end - m_pos;
+            m_fail = true;
+         }
+         memcpy(s, m_pos, n);
+         m_pos += n;
+         if (m_pos > m_advised)
+            advise();
+      }
+      virtual int peek()
+      {
+         if (m_pos == m_end)
+         {
+            m_fail = true;
+            return EOF;
+         }
+         return (uint8_t)*m_pos;
+      }
+      virtual bool fail() const { return m_fail; }
+      // Zero-copy read: n bytes in place, valid as long as the stream is
+      const uint8_t* map(size_t n)
+      {
+         if (m_pos + n > m_end)
+         {
+            m_pos = m_end;
+            m_fail = true;
+            return NULL;
+         }
+         const char *data = m_pos;
+         m_pos += n;
+         if (m_pos > m_advised)
+            advise();
+         return reinterpret_cast<const uint8_t*>(data);
+      }
+      bool contains(const void *data) const { return data >= m_map && data < m_end; }
+      uint64_t tellg() const { return m_pos - m_map; }
+      void seekg(uint64_t pos) { m_pos = m_map + std::min(pos, size()); m_fail = false; advise(); }
+      uint64_t size() const { return m_end - m_map; }
+      // Random access that does not move the stream
+      const uint8_t* at(uint64_t pos) const { return reinterpret_cast<const uint8_t*>(m_map + pos); }
+};
+
+// Input of block-compressed traces (CompressionBlock). The next blocks are read and decompressed on a helper
+// thread, so decompression is not done by the thread that consumes the records. When the input is a mapped
+// file, the index at its end allows to seek to a block.
+class ibzstream : public vistream
+{
+   private:
+      struct Block
+      {
+         std::vector<char> data;
+         uint64_t end_offset;       //< File offset after the block
+      };
+
+      vistream *input;
+      vimstream *mapping;           //< The input if it is a mapped file, NULL otherwise
+      uint64_t m_offset;            //< File offset of the next block to read
+      bool m_input_done;
+      std::vector<char> m_compressed;
+
+      Block *m_block;               //< Block being consumed
+      size_t m_pos;
+      uint64_t m_position;
+      bool m_fail;
+
+      std::vector<Sift::BlockIndexEntry> m_index;
+      bool m_index_loaded;
+
+#if SIFT_USE_THREADS
+      static const size_t depth = 4; //< Blocks decompressed ahead
+      std::thread m_thread;
+      std::mutex m_mutex;
+      std::condition_variable m_cond;
+      std::deque<Block*> m_ready;
+      bool m_stop;
+      bool m_done;
+      void helper();
+      void startHelper();
+      void stopHelper();
+#endif
+
+      Block* readBlock();
+      bool nextBlock();
+      bool loadIndex();
+   public:
+      ibzstream(vistream *input, vimstream *mapping, uint64_t offset);
+      virtual ~ibzstream();
+      virtual void read(char* s, std::streamsize n);
+      virtual int peek();
+      virtual bool fail() const { return m_fail; }
+      // File offset up to which the input was consumed
+      uint64_t tellg() const { return m_position; }
+      // Continue reading at the last seekable block that starts at or before instruction icount,
+      // and set icount to the instruction it starts at. False if the input cannot be seeked.
+      bool seek(uint64_t &icount);
+};
+
 class izstream : public vistream
 {
    private:
@@ -0,0 +1,103 @@
+import concurrent.futures
+import os
+import re
+import traceback
+
+from config import RUNS_FOLDER, CAMPAIGN_JOBS, HOST_CORES_PER_RUN, MEMORY_PER_RUN_GB
+import run as simulation
+
+
+def get_available_memory_gb():
+    try:
+        with open('/proc/meminfo', 'r') as f:
+            for line in f:
+                m = re.match(r'MemAvailable:\s+(\d+) kB', line)
+                if m:
+                    return int(m.group(1)) / 1024 / 1024
+    except IOError:
+        pass
+    return None
+
+
+def get_default_jobs():
+    '''Number of concurrent runs the host can take: one per HOST_CORES_PER_RUN cores and per MEMORY_PER_RUN_GB of available memory.'''
+    jobs = (os.cpu_count() or 1) // HOST_CORES_PER_RUN
+    memory = get_available_memory_gb()
+    if memory is not None:
+        jobs = min(jobs, int(memory // MEMORY_PER_RUN_GB))
+    return max(1, jobs)
+
+
+def execute(name, base_configuration, benchmark, run_hash):
+    run_dir = os.path.join(RUNS_FOLDER, name, run_hash)
+    return simulation.run(base_configuration, benchmark, run_dir=run_dir, quiet=True)
+
+
+class Campaign:
+    '''
+    A set of runs (base configuration x benchmark) executed concurrently.
+
+    Each run gets its own config overlay and working directory (see run.run), so runs do not interfere.
+    Runs whose configuration and benchmark already have results (also from other campaigns) are skipped,
+    so an interrupted campaign resumes where it stopped when it is started again.
+    '''
+
+    def __init__(self, name, jobs=None):
+        self.name = name
+        self.jobs = jobs or CAMPAIGN_JOBS or get_default_jobs()
+        self.runs = []
+
+    def add(self, base_configuration, benchmark):
+        self.runs.append((list(base_configuration), benchmark))
+
+    def run(self):
+        pending = {}
+        seen = set()
+        for base_configuration, benchmark in self.runs:
+            run_hash = simulation.get_run_hash(base_configuration, benchmark)
+            if run_hash in seen:
+                continue
+            seen.add(run_hash)
+            finished = simulation.find_finished_run(run_hash)
+            if finished is not None:
+                print('skipping {} with configuration {} (results in {})'.format(benchmark, '+'.join(base_configuration), finished))
+            else:
+                pending[run_hash] = (base_configuration, benchmark)
+
+        print('campaign {}: {} runs, {} to do, {} concurrently'.format(self.name, len(self.runs), len(pending), self.jobs))
+        failed = []
+        with concurrent.futures.ProcessPoolExecutor(max_workers=self.jobs) as executor:
+            futures = {}
+            for run_hash, (base_configuration, benchmark) in pending.items():
+                futures[executor.submit(execute, self.name, base_configuration, benchmark, run_hash)] = (base_configuration, benchmark)
+            for future in concurrent.futures.as_completed(futures):
+                base_configuration, benchmark = futures[future]
+                try:
+                    print('finished {} with configuration {} (results in {})'.format(benchmark, '+'.join(base_configuration), future.result()))
+                except Exception:
+                    print('#' * 80)
+                    print('failed {} with configuration {}'.format(benchmark, '+'.join(base_configuration)))
+                    print(traceback.format_exc())
+                    print('#' * 80)
+                    failed.append((base_configuration, benchmark))
+
+        print('campaign {}: {} of {} runs failed'.format(self.name, len(failed), len(pending)))
+        return failed
+
+
+def dvfs_sweep():
+    # DVFS epochs x frequencies x benchmarks, all runs concurrently
+    campaign = Campaign('dvfs_sweep')
+    for benchmark in ('parsec-blackscholes', 'parsec-x264'):
+        parallelism = simulation.get_feasible_parallelisms(benchmark)[0]
+        for freq in (1, 2, 3, 4):
+            for epoch in ('slowDVFS', 'mediumDVFS', 'fastDVFS'):
+                campaign.add(['{:.1f}GHz'.format(freq), 'maxFreq', epoch], simulation.get_instance(benchmark, parallelism, input_set='simsmall'))
+    campaign.run()
+
+
+def main():
+    dvfs_sweep()
+
+if __name__ == '__main__':
+    main()
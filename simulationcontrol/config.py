@@ -4,7 +4,14 @@ HERE = os.path.dirname(os.path.abspath(__file__))
 SNIPER = os.path.dirname(HERE)
 
 RESULTS_FOLDER = os.path.join(SNIPER, 'results')
+RUNS_FOLDER = os.path.join(SNIPER, 'runs')  # working directories of the running simulations (removed after a successful run)
 NUMBER_CORES = 4
 SNIPER_CONFIG = 'gainestown'
 ENABLE_HEARTBEATS = False
 SCRIPT='magic_timestamp' if ENABLE_HEARTBEATS else ''
+
+# Concurrent runs of a campaign (campaign.py): None sizes it to the host, at most one run per
+# HOST_CORES_PER_RUN host cores and per MEMORY_PER_RUN_GB of available memory.
+CAMPAIGN_JOBS = None
+HOST_CORES_PER_RUN = 2
+MEMORY_PER_RUN_GB = 4
@@ -1,4 +1,5 @@
 import datetime
+import hashlib
 import math
 import os
 import gzip
@@ -10,7 +11,7 @@ import subprocess
 import traceback
 import sys
 
-from config import NUMBER_CORES, RESULTS_FOLDER, SNIPER_CONFIG, SCRIPT, ENABLE_HEARTBEATS
+from config import NUMBER_CORES, RESULTS_FOLDER, RUNS_FOLDER, SNIPER_CONFIG, SCRIPT, ENABLE_HEARTBEATS
 from resultlib.plot import create_plots
 
 HERE = os.path.dirname(os.path.abspath(__file__))
@@ -19,39 +20,97 @@ BENCHMARKS = os.path.join(SNIPER_BASE, 'benchmarks')
 BATCH_START = datetime.datetime.now().strftime('%Y-%m-%d_%H.%M')
 
 
-def change_base_configuration(base_configuration):
-    base_cfg = os.path.join(SNIPER_BASE, 'config/base.cfg')
-    with open(base_cfg, 'r') as f:
+def apply_base_configuration(content, base_configuration):
+    '''Return the lines of base.cfg with the `cfg:` tagged lines of the base configuration enabled and all other tagged lines disabled.'''
+    lines = []
+    for line in content.splitlines():
+        m = re.match('.*cfg:(!?)([a-zA-Z_\\.0-9]+)$', line)
+        if m:
+            inverted = m.group(1) == '!'
+            include = inverted ^ (m.group(2) in base_configuration)
+            included = line[0] != '#'
+            if include and not included:
+                line = line[1:]
+            elif not include and included:
+                line = '#' + line
+        lines.append(line)
+    return lines
+
+
+def base_configuration_overlay(base_configuration):
+    '''
+    Return a config file that sets every key with a `cfg:` tagged line in base.cfg to its value under the base configuration.
+    It is loaded right after base.cfg, so base.cfg itself stays untouched and concurrent runs can use different base configurations.
+    '''
+    with open(os.path.join(SNIPER_BASE, 'config/base.cfg'), 'r') as f:
         content = f.read()
-    with open(base_cfg, 'w') as f:
-        for line in content.splitlines():
-            m = re.match('.*cfg:(!?)([a-zA-Z_\\.0-9]+)$', line)
-            if m:
-                inverted = m.group(1) == '!'
-                include = inverted ^ (m.group(2) in base_configuration)
-                included = line[0] != '#'
-                if include and not included:
-                    line = line[1:]
-                elif not include and included:
-                    line = '#' + line
-            f.write(line)
-            f.write('\n')
-
-
-def prev_run_cleanup():
-    '''Cleanup files potentially left over from aborted previous runs.'''
 
-    pattern = r"^\d+\.hb.log$" # Heartbeat logs
-    for f in os.listdir(BENCHMARKS):
-        if not re.match(pattern, f):
+    tagged = []
+    section = ''
+    for line in content.splitlines():
+        m = re.match(r'^\s*\[(.*)\]', line)
+        if m:
+            section = m.group(1)
+        elif re.match('.*cfg:(!?)([a-zA-Z_\\.0-9]+)$', line) and '=' in line:
+            key = (section, line.lstrip('#').split('=')[0].strip())
+            if key not in tagged:
+                tagged.append(key)
+
+    values = {}
+    section = ''
+    for line in apply_base_configuration(content, base_configuration):
+        m = re.match(r'^\s*\[(.*)\]', line)
+        if m:
+            section = m.group(1)
+        elif not line.lstrip().startswith('#') and '=' in line:
+            key = (section, line.split('=')[0].strip())
+            if key in tagged:
+                values[key] = line.strip()
+
+    overlay = ['# base configuration: {}'.format('+'.join(base_configuration))]
+    section = None
+    for key in tagged:
+        if key not in values:
             continue
-
-        file_path = os.path.join(BENCHMARKS, f)
-        if os.path.isfile(file_path):
-            os.remove(file_path)
-
-
-def save_output(base_configuration, benchmark, console_output, cpistack, started, ended):
+        if key[0] != section:
+            section = key[0]
+            overlay.append('[{}]'.format(section))
+        overlay.append(values[key])
+    return '\n'.join(overlay) + '\n'
+
+
+def get_run_hash(base_configuration, benchmark):
+    '''Identify a run by everything that determines its results: base.cfg under the base configuration, the architecture and the benchmark.'''
+    with open(os.path.join(SNIPER_BASE, 'config/base.cfg'), 'r') as f:
+        base_cfg = '\n'.join(apply_base_configuration(f.read(), base_configuration))
+    h = hashlib.sha1()
+    for part in (base_cfg, SNIPER_CONFIG, str(NUMBER_CORES), SCRIPT, str(ENABLE_HEARTBEATS), benchmark, ' '.join(get_periodic_args(base_configuration))):
+        h.update(part.encode('utf-8'))
+        h.update(b'\0')
+    return h.hexdigest()
+
+
+def find_finished_run(run_hash):
+    '''Return the results directory of an earlier successful run with the same hash, or None.'''
+    if not os.path.exists(RESULTS_FOLDER):
+        return None
+    for dirname in os.listdir(RESULTS_FOLDER):
+        hash_file = os.path.join(RESULTS_FOLDER, dirname, 'runhash.txt')
+        if os.path.isfile(hash_file):
+            with open(hash_file, 'r') as f:
+                if f.read().strip() == run_hash:
+                    return dirname
+    return None
+
+
+def prepare_run_dir(run_dir):
+    '''Start from an empty working directory (removes files left over from aborted previous runs).'''
+    if os.path.exists(run_dir):
+        shutil.rmtree(run_dir)
+    os.makedirs(run_dir)
+
+
+def save_output(base_configuration, benchmark, console_output, cpistack, started, ended, run_dir):
     benchmark_text = benchmark
     if len(benchmark_text) > 100:
         benchmark_text = benchmark_text[:100] + '__etc'
@@ -74,37 +133,27 @@ def save_output(base_configuration, benchmark, console_output, cpistack, started
               'sim.out',
               'cpi-stack.png',
               'sim.stats.sqlite3'):
-        shutil.copy(os.path.join(BENCHMARKS, f), directory)
+        shutil.copy(os.path.join(run_dir, f), directory)
     for f in ('PeriodicPower.log',
               'PeriodicThermal.log',
               'PeriodicFrequency.log',
               'PeriodicVdd.log',
               'PeriodicCPIStack.log',
               'PeriodicRvalue.log'):
-        with open(os.path.join(BENCHMARKS, f), 'rb') as f_in, gzip.open('{}.gz'.format(os.path.join(directory, f)), 'wb') as f_out:
+        with open(os.path.join(run_dir, f), 'rb') as f_in, gzip.open('{}.gz'.format(os.path.join(directory, f)), 'wb') as f_out:
             shutil.copyfileobj(f_in, f_out)
 
     pattern = r"^\d+\.hb.log$" # Heartbeat logs
-    for f in os.listdir(BENCHMARKS):
+    for f in os.listdir(run_dir):
         if not re.match(pattern, f):
             continue
-        shutil.copy(os.path.join(BENCHMARKS, f), directory)
+        shutil.copy(os.path.join(run_dir, f), directory)
 
     create_plots(run)
+    return directory
 
 
-def run(base_configuration, benchmark, ignore_error=False):
-    print('running {} with configuration {}'.format(benchmark, '+'.join(base_configuration)))
-    started = datetime.datetime.now()
-    change_base_configuration(base_configuration)
-
-    prev_run_cleanup()
-
-    benchmark_options = []
-    if ENABLE_HEARTBEATS == True:
-        benchmark_options.append('enable_heartbeats')
-        benchmark_options.append('hb_results_dir=%s' % BENCHMARKS)
-
+def get_periodic_args(base_configuration):
     # NOTE: This determines the logging interval! (see issue in forked repo)
     periodicPower = 1000000
     #periodicPower = 250000
@@ -112,26 +161,52 @@ def run(base_configuration, benchmark, ignore_error=False):
         periodicPower = 250000
     if 'fastDVFS' in base_configuration:
         periodicPower = 100000    
-    args = '-n {number_cores} -c {config} --benchmarks={benchmark} --no-roi --sim-end=last -senergystats:{periodic} -speriodic-power:{periodic}{script}{benchmark_options}' \
-        .format(number_cores=NUMBER_CORES,
-                config=SNIPER_CONFIG,
-                benchmark=benchmark,
-                periodic=periodicPower,
-                script=" -s %s" % SCRIPT if SCRIPT else '',
-                benchmark_options=''.join([' -B ' + opt for opt in benchmark_options]))
+    return ['-senergystats:{}'.format(periodicPower), '-speriodic-power:{}'.format(periodicPower), '-g', 'periodic_power/interval={}'.format(periodicPower)]
+
+
+def run(base_configuration, benchmark, ignore_error=False, run_dir=None, quiet=False):
+    '''
+    Simulate the benchmark under the base configuration (list of `cfg:` tags of base.cfg) and save the results.
+    Everything the run writes goes to its own working directory run_dir (by default one per configuration and benchmark),
+    so runs can execute concurrently (see campaign.py). With quiet, the console output is only saved, not printed.
+    '''
+    print('running {} with configuration {}'.format(benchmark, '+'.join(base_configuration)))
+    started = datetime.datetime.now()
+    run_hash = get_run_hash(base_configuration, benchmark)
+    if run_dir is None:
+        run_dir = os.path.join(RUNS_FOLDER, run_hash)
+
+    prepare_run_dir(run_dir)
+    overlay = os.path.join(run_dir, 'base_configuration.cfg')
+    with open(overlay, 'w') as f:
+        f.write(base_configuration_overlay(base_configuration))
+
+    benchmark_options = []
+    if ENABLE_HEARTBEATS == True:
+        benchmark_options.append('enable_heartbeats')
+        benchmark_options.append('hb_results_dir=%s' % run_dir)
+
+    args = ['-n', str(NUMBER_CORES), '-d', run_dir, '-c', overlay, '-c', SNIPER_CONFIG, '--benchmarks={}'.format(benchmark), '--no-roi', '--sim-end=last']
+    args += get_periodic_args(base_configuration)
+    if SCRIPT:
+        args += ['-s', SCRIPT]
+    for opt in benchmark_options:
+        args += ['-B', opt]
     console_output = ''
 
+    # the simulator reads the heartbeat logs from its working directory
     run_sniper = os.path.join(BENCHMARKS, 'run-sniper')
-    p = subprocess.Popen([run_sniper] + args.split(' '), stdout=subprocess.PIPE, stderr=subprocess.STDOUT, bufsize=1, cwd=BENCHMARKS)
+    p = subprocess.Popen([run_sniper] + args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, bufsize=1, cwd=run_dir)
     with p.stdout:
         for line in iter(p.stdout.readline, b''):
             linestr = line.decode('utf-8')
             console_output += linestr
-            print(linestr, end='')
+            if not quiet:
+                print(linestr, end='')
     p.wait()
 
     try:
-        cpistack = subprocess.check_output(['python', os.path.join(SNIPER_BASE, 'tools/cpistack.py')], cwd=BENCHMARKS)
+        cpistack = subprocess.check_output(['python', os.path.join(SNIPER_BASE, 'tools/cpistack.py')], cwd=run_dir)
     except:
         if ignore_error:
             cpistack = b''
@@ -140,11 +215,17 @@ def run(base_configuration, benchmark, ignore_error=False):
 
     ended = datetime.datetime.now()
 
-    save_output(base_configuration, benchmark, console_output, cpistack, started, ended)
+    directory = save_output(base_configuration, benchmark, console_output, cpistack, started, ended, run_dir)
 
     if p.returncode != 0:
         raise Exception('return code != 0')
 
+    # only successful runs are reused by campaigns
+    with open(os.path.join(directory, 'runhash.txt'), 'w') as f:
+        f.write(run_hash + '\n')
+    shutil.rmtree(run_dir)
+    return directory
+
 
 def try_run(base_configuration, benchmark, ignore_error=False):
     try:
@@ -6,6 +6,7 @@
 #include "logmem.h"
 #include "exceptions.h"
 #include "sim_api.h"
+#include "policy_replay.h"
 
 int main(int argc, char* argv[])
 {
@@ -41,6 +42,18 @@ int main(int argc, char* argv[])
    Simulator::allocate();
    Sim()->start();
 
+   // Approximate the DVFS and migration policies on the logs of an earlier run instead of simulating it
+   if (PolicyReplay::isEnabled())
+   {
+      PolicyReplay *replay = new PolicyReplay();
+      replay->run();
+      delete replay;
+
+      Simulator::release();
+      delete cfg;
+      return 0;
+   }
+
    // config::Config shouldn't be called outside of init/fini
    // With Sim()->hideCfg(), we let Simulator know to complain when someone does call Sim()->getCfg()
    Sim()->hideCfg();
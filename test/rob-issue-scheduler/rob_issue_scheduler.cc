@@ -0,0 +1,513 @@
+// Regression check for the RobTimer issue stage: runs the same random uop streams through the scan, check and event
+// issue schedulers, and requires the event-driven ones to reproduce the dispatch, issue, done and commit time of every
+// uop of the scan, as well as every simulate() result and rob_timer statistic.
+//
+// RobTimer is linked from the simulator sources without the rest of the simulator: the few objects it reaches through
+// Sim() (configuration, statistics, DVFS domains, the decoder) and the core's memory hierarchy are replaced by the
+// minimal stand-ins below. They are set up as raw objects, hence the access to their private members.
+
+#include <sstream>
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <set>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <list>
+#include <string>
+#include <functional>
+#include <memory>
+#include <boost/tuple/tuple.hpp>
+
+#define private public
+#define protected public
+#include "simulator.h"
+#include "core.h"
+#include "performance_model.h"
+#include "dvfs_manager.h"
+#include "stats.h"
+#include "config.hpp"
+#include "log.h"
+#include "decoder.h"
+#undef private
+#undef protected
+
+#include "rob_timer.h"
+#include "rob_contention.h"
+#include "core_model.h"
+#include "dynamic_micro_op.h"
+#include "micro_op.h"
+#include "instruction_tracer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <cstring>
+#include <cinttypes>
+
+// Configuration: the perf_model/core/rob_timer keys of the run
+
+static std::map<std::string, std::string> s_config;
+
+SInt64 config::Config::getIntArray(const String &path, UInt64 index) { return atoll(s_config.at(path.c_str()).c_str()); }
+bool config::Config::getBoolArray(const String &path, UInt64 index) { return s_config.at(path.c_str()) == "true"; }
+const String config::Config::getStringArray(const String &path, UInt64 index) { return String(s_config.at(path.c_str()).c_str()); }
+
+// Logging: only errors and warnings are printed, LOG_PRINT_ERROR exits
+
+static char s_log[sizeof(Log)] __attribute__((aligned(16)));
+
+Log *Log::getSingleton() { return (Log*)s_log; }
+String Log::getModule(const char *filename) { return String(filename); }
+bool Log::isEnabled(const char *module) { return false; }
+void Log::log(ErrorState err, const char *source_file, SInt32 source_line, const char *format, ...)
+{
+   va_list args;
+   va_start(args, format);
+   fprintf(stderr, "[%s:%d] ", source_file, source_line);
+   vfprintf(stderr, format, args);
+   fprintf(stderr, "\n");
+   va_end(args);
+}
+
+// Statistics: the metrics of the current run are kept to compare them at the end
+
+static std::vector<StatsMetricBase*> s_metrics;
+
+void StatsManager::registerMetric(StatsMetricBase *metric) { s_metrics.push_back(metric); }
+template <> UInt64 makeStatsValue<UInt64>(UInt64 t) { return t; }
+template <> UInt64 makeStatsValue<SubsecondTime>(SubsecondTime t) { return t.getFS(); }
+
+// Simulator: one 2 GHz DVFS domain, and a decoder that only knows the opcodes used below
+
+static ComponentPeriod s_period = ComponentPeriod::fromFreqHz(2000000000ull);
+
+const ComponentPeriod* DvfsManager::getCoreDomain(UInt32 core_id) { return &s_period; }
+
+static const dl::Decoder::decoder_opcode OPCODE_ALU = 1, OPCODE_FP_ADDSUB = 2, OPCODE_FP_MULDIV = 3, OPCODE_PAUSE = 4;
+
+class TestDecoder : public dl::Decoder
+{
+   public:
+      void decode(dl::DecodedInst *inst) {}
+      void decode(dl::DecodedInst *inst, dl::dl_isa isa) {}
+      void change_isa_mode(dl::dl_isa new_isa) {}
+      const char* inst_name(unsigned int inst_id) { return "inst"; }
+      const char* reg_name(unsigned int reg_id) { return "reg"; }
+      decoder_reg largest_enclosing_register(decoder_reg r) { return r; }
+      bool invalid_register(decoder_reg r) { return false; }
+      bool reg_is_program_counter(decoder_reg r) { return false; }
+      bool inst_in_group(const dl::DecodedInst *inst, unsigned int group_id) { return false; }
+      unsigned int num_operands(const dl::DecodedInst *inst) { return 0; }
+      unsigned int num_memory_operands(const dl::DecodedInst *inst) { return 0; }
+      decoder_reg mem_base_reg(const dl::DecodedInst *inst, unsigned int mem_idx) { return 0; }
+      decoder_reg mem_index_reg(const dl::DecodedInst *inst, unsigned int mem_idx) { return 0; }
+      bool op_read_mem(const dl::DecodedInst *inst, unsigned int mem_idx) { return false; }
+      bool op_write_mem(const dl::DecodedInst *inst, unsigned int mem_idx) { return false; }
+      bool op_read_reg(const dl::DecodedInst *inst, unsigned int idx) { return false; }
+      bool op_write_reg(const dl::DecodedInst *inst, unsigned int idx) { return false; }
+      bool is_addr_gen(const dl::DecodedInst *inst, unsigned int idx) { return false; }
+      bool op_is_reg(const dl::DecodedInst *inst, unsigned int idx) { return false; }
+      decoder_reg get_op_reg(const dl::DecodedInst *inst, unsigned int idx) { return 0; }
+      unsigned int size_mem_op(const dl::DecodedInst *inst, unsigned int mem_idx) { return 8; }
+      unsigned int get_exec_microops(const dl::DecodedInst *ins, int numLoads, int numStores) { return 1; }
+      uint16_t get_operand_size(const dl::DecodedInst *ins) { return 64; }
+      bool is_cache_flush_opcode(decoder_opcode opcd) { return false; }
+      bool is_div_opcode(decoder_opcode opcd) { return false; }
+      bool is_pause_opcode(decoder_opcode opcd) { return opcd == OPCODE_PAUSE; }
+      bool is_branch_opcode(decoder_opcode opcd) { return false; }
+      bool is_fpvector_addsub_opcode(decoder_opcode opcd, const dl::DecodedInst* ins) { return opcd == OPCODE_FP_ADDSUB; }
+      bool is_fpvector_muldiv_opcode(decoder_opcode opcd, const dl::DecodedInst* ins) { return opcd == OPCODE_FP_MULDIV; }
+      bool is_fpvector_ldst_opcode(decoder_opcode opcd, const dl::DecodedInst* ins) { return false; }
+      decoder_reg last_reg() { return 64; }
+};
+
+dl::Decoder::~Decoder() {}
+
+static TestDecoder s_decoder;
+
+dl::Decoder *Simulator::getDecoder() { return &s_decoder; }
+
+static char s_simulator[sizeof(Simulator)] __attribute__((aligned(16)));
+static char s_stats_manager[sizeof(StatsManager)] __attribute__((aligned(16)));
+static char s_dvfs_manager[sizeof(DvfsManager)] __attribute__((aligned(16)));
+static char s_config_file[sizeof(void*)] __attribute__((aligned(16)));
+Simulator *Simulator::m_singleton = NULL;
+config::Config *Simulator::m_config_file = NULL;
+
+// Memory hierarchy: a fixed hit level per cache line, 10% DRAM, 20% L2, the rest L1
+
+MemoryResult Core::accessMemory(lock_signal_t lock_signal, mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size, MemModeled modeled, IntPtr eip, SubsecondTime now, bool is_fault_mask)
+{
+   UInt64 hash = (d_addr >> 6) * 0x9E3779B97F4A7C15ull;
+   hash ^= hash >> 29;
+
+   MemoryResult result;
+   switch (hash % 10)
+   {
+      case 0:
+         result.hit_where = HitWhere::DRAM;
+         result.latency = SubsecondTime::NS(80);
+         break;
+      case 1:
+      case 2:
+         result.hit_where = HitWhere::L2_OWN;
+         result.latency = SubsecondTime::NS(6);
+         break;
+      default:
+         result.hit_where = HitWhere::L1_OWN;
+         result.latency = SubsecondTime::NS(2);
+         break;
+   }
+   return result;
+}
+
+// Core model: three ALU ports, one load and one store port
+
+class TestContention : public RobContention
+{
+   private:
+      int m_alu, m_load, m_store;
+
+      int &getPort(const DynamicMicroOp &uop)
+      {
+         return uop.getMicroOp()->isLoad() ? m_load : uop.getMicroOp()->isStore() ? m_store : m_alu;
+      }
+
+   public:
+      void initCycle(SubsecondTime now) { m_alu = 3; m_load = 1; m_store = 1; }
+      bool tryIssue(const DynamicMicroOp &uop) { return getPort(uop) > 0; }
+      bool noMore() { return m_alu == 0 && m_load == 0 && m_store == 0; }
+      void doIssue(DynamicMicroOp &uop) { --getPort(uop); }
+};
+
+class TestDynamicMicroOp : public DynamicMicroOp
+{
+   public:
+      TestDynamicMicroOp(const MicroOp *uop, const CoreModel *core_model, ComponentPeriod period) : DynamicMicroOp(uop, core_model, period) {}
+      const char* getType() const { return "test"; }
+};
+
+class TestAllocator : public Allocator
+{
+   public:
+      void *alloc(size_t bytes)
+      {
+         // Allocator::dealloc expects a pointer to the owning allocator in front of the data
+         char *ptr = (char*)malloc(sizeof(Allocator*) + bytes);
+         *(Allocator**)ptr = this;
+         return ptr + sizeof(Allocator*);
+      }
+      void _dealloc(void *ptr) { free(ptr); }
+};
+
+class TestCoreModel : public CoreModel
+{
+   public:
+      IntervalContention* createIntervalContentionModel(const Core *core) const { return NULL; }
+      unsigned int getLongLatencyCutoff() const { return 10; }
+      RobContention* createRobContentionModel(const Core *core) const { return new TestContention(); }
+      Allocator* createDMOAllocator() const { return new TestAllocator(); }
+      DynamicMicroOp* createDynamicMicroOp(Allocator *alloc, const MicroOp *uop, ComponentPeriod period) const
+      {
+         return DynamicMicroOp::alloc<TestDynamicMicroOp>(alloc, uop, this, period);
+      }
+      unsigned int getInstructionLatency(const MicroOp *uop) const
+      {
+         if (uop->isLoad() || uop->isStore())
+            return 1;
+         else if (uop->getSubtype() == MicroOp::UOP_SUBTYPE_FP_MULDIV)
+            return 5;
+         else if (uop->getSubtype() == MicroOp::UOP_SUBTYPE_FP_ADDSUB)
+            return 3;
+         else
+            return 1;
+      }
+      unsigned int getAluLatency(const MicroOp *uop) const { return getInstructionLatency(uop); }
+      unsigned int getBypassLatency(const DynamicMicroOp *uop) const { return 0; }
+      unsigned int getLongestLatency() const { return 5; }
+};
+
+// Records the times of every uop as it commits
+
+class TimesRecorder : public InstructionTracer
+{
+   public:
+      std::vector<UInt64> m_times; // per uop: sequence number, dispatch, issue, done, commit (fs)
+
+      void traceInstruction(const DynamicMicroOp *uop, uop_times_t *times)
+      {
+         m_times.push_back(uop->getSequenceNumber());
+         m_times.push_back(times->dispatch.getFS());
+         m_times.push_back(times->issue.getFS());
+         m_times.push_back(times->done.getFS());
+         m_times.push_back(times->commit.getFS());
+      }
+};
+
+// Random uop stream
+
+class Random
+{
+   private:
+      UInt64 m_state;
+
+   public:
+      Random(UInt64 seed) : m_state(seed * 2654435761u + 1) {}
+      UInt64 next() { m_state ^= m_state << 13; m_state ^= m_state >> 7; m_state ^= m_state << 17; return m_state; }
+      unsigned int below(unsigned int n) { return next() % n; }
+};
+
+static const unsigned int NUM_REGISTERS = 16;
+
+// One instruction: a serializing uop or memory fence, or an optional load, an execute and an optional store,
+// with the memory address of its loads and stores
+static void makeInstruction(Random &random, std::deque<MicroOp> &static_uops, std::vector<MicroOp*> &uops, UInt64 &address)
+{
+   unsigned int kind = random.below(100);
+   // Half of the accesses go to a small, hot region
+   address = 0x10000 + 8 * random.below(kind < 50 ? 64 : 4096);
+
+   if (kind < 3)
+   {
+      static_uops.push_back(MicroOp());
+      MicroOp *uop = &static_uops.back();
+      uop->makeExecute(0, 0, OPCODE_ALU, "fence", false);
+      if (kind == 0)
+         uop->setSerializing(true);
+      else
+         uop->setMemBarrier(true);
+      uop->setFirst(true);
+      uop->setLast(true);
+      uops.push_back(uop);
+      return;
+   }
+
+   bool has_load = kind < 40, has_store = kind >= 30 && kind < 55, is_branch = kind >= 90;
+   dl::Decoder::decoder_opcode opcode = random.below(10) == 0 ? OPCODE_FP_MULDIV
+                                      : random.below(6) == 0 ? OPCODE_FP_ADDSUB
+                                      : random.below(30) == 0 ? OPCODE_PAUSE
+                                      : OPCODE_ALU;
+
+   if (has_load)
+   {
+      static_uops.push_back(MicroOp());
+      MicroOp *uop = &static_uops.back();
+      uop->makeLoad(0, opcode, "load", 8);
+      // As the instruction decoder does, address registers are source registers as well
+      unsigned int address_register = random.below(NUM_REGISTERS);
+      uop->addAddressRegister(address_register, "reg");
+      uop->addSourceRegister(address_register, "reg");
+      uop->addSourceRegister(random.below(NUM_REGISTERS), "reg");
+      uops.push_back(uop);
+   }
+
+   static_uops.push_back(MicroOp());
+   MicroOp *execute = &static_uops.back();
+   execute->makeExecute(0, has_load ? 1 : 0, opcode, "execute", is_branch);
+   execute->addSourceRegister(random.below(NUM_REGISTERS), "reg");
+   if (random.below(2))
+      execute->addSourceRegister(random.below(NUM_REGISTERS), "reg");
+   if (!is_branch)
+      execute->addDestinationRegister(random.below(NUM_REGISTERS), "reg");
+   uops.push_back(execute);
+
+   if (has_store)
+   {
+      static_uops.push_back(MicroOp());
+      MicroOp *uop = &static_uops.back();
+      uop->makeStore(0, 1, opcode, "store", 8);
+      unsigned int address_register = random.below(NUM_REGISTERS);
+      uop->addAddressRegister(address_register, "reg");
+      uop->addSourceRegister(address_register, "reg");
+      uop->addSourceRegister(random.below(NUM_REGISTERS), "reg");
+      uops.push_back(uop);
+   }
+
+   uops.front()->setFirst(true);
+   uops.back()->setLast(true);
+}
+
+struct Configuration
+{
+   UInt64 seed;
+   int num_instructions;
+   int window_size;
+   int dispatch_width;
+   bool in_order;
+   bool issue_contention;
+};
+
+struct Result
+{
+   std::vector<UInt64> simulate;    // instructions and latency returned by every simulate() call
+   std::vector<UInt64> times;       // TimesRecorder::m_times
+   std::vector<std::pair<String, UInt64> > stats;
+};
+
+static Result run(const Configuration &configuration, const char *issue_scheduler)
+{
+   s_config["perf_model/core/rob_timer/commit_width"] = "4";
+   s_config["perf_model/core/rob_timer/rs_entries"] = configuration.window_size > 36 ? "36" : "8";
+   s_config["perf_model/core/rob_timer/store_to_load_forwarding"] = configuration.seed % 2 ? "true" : "false";
+   s_config["perf_model/core/rob_timer/address_disambiguation"] = configuration.seed % 3 ? "true" : "false";
+   s_config["perf_model/core/rob_timer/in_order"] = configuration.in_order ? "true" : "false";
+   s_config["perf_model/core/rob_timer/issue_scheduler"] = issue_scheduler;
+   s_config["perf_model/core/rob_timer/issue_contention"] = configuration.issue_contention ? "true" : "false";
+   s_config["perf_model/core/rob_timer/outstanding_loads"] = "10";
+   s_config["perf_model/core/rob_timer/outstanding_stores"] = "8";
+   s_config["perf_model/core/rob_timer/mlp_histogram"] = "true";
+
+   static char core_object[sizeof(Core)] __attribute__((aligned(16)));
+   static char performance_model_object[sizeof(PerformanceModel)] __attribute__((aligned(16)));
+   memset(core_object, 0, sizeof(core_object));
+   memset(performance_model_object, 0, sizeof(performance_model_object));
+
+   TimesRecorder recorder;
+   PerformanceModel *performance_model = (PerformanceModel*)performance_model_object;
+   performance_model->m_instruction_tracer = &recorder;
+   Core *core = (Core*)core_object;
+   core->m_core_id = 0;
+   core->m_dvfs_domain = &s_period;
+   core->m_performance_model = performance_model;
+
+   TestCoreModel core_model;
+   Allocator *allocator = core_model.createDMOAllocator();
+   std::deque<MicroOp> static_uops;
+   RobTimer *rob_timer = new RobTimer(core, performance_model, &core_model, 8, configuration.dispatch_width, configuration.window_size);
+
+   Random random(configuration.seed);
+   Result result;
+   SubsecondTime time = SubsecondTime::Zero();
+
+   for(int i = 0; i < configuration.num_instructions; ++i)
+   {
+      std::vector<MicroOp*> uops;
+      UInt64 address;
+      makeInstruction(random, static_uops, uops, address);
+
+      std::vector<DynamicMicroOp*> dynamic_uops;
+      for(std::vector<MicroOp*>::iterator it = uops.begin(); it != uops.end(); ++it)
+      {
+         DynamicMicroOp *uop = core_model.createDynamicMicroOp(allocator, *it, s_period);
+         if ((*it)->isLoad() || (*it)->isStore())
+            uop->setAddress(Memory::make_access(address));
+         if ((*it)->isBranch())
+            uop->setBranchMispredicted(random.below(8) == 0);
+         if ((*it)->isFirst() && random.below(200) == 0)
+         {
+            uop->setICacheLatency(1 + random.below(20));
+            uop->setICacheHitWhere(HitWhere::L2_OWN);
+         }
+         dynamic_uops.push_back(uop);
+      }
+
+      boost::tuple<uint64_t,SubsecondTime> simulated = rob_timer->simulate(dynamic_uops);
+      result.simulate.push_back(simulated.get<0>());
+      result.simulate.push_back(simulated.get<1>().getFS());
+      time += simulated.get<1>();
+
+      // Now and then, jump ahead as a barrier synchronization does
+      if (random.below(500) == 0)
+      {
+         time += SubsecondTime::NS(random.below(100));
+         rob_timer->synchronize(time);
+      }
+   }
+
+   for(std::vector<StatsMetricBase*>::iterator it = s_metrics.begin(); it != s_metrics.end(); ++it)
+   {
+      result.stats.push_back(std::make_pair((*it)->metricName, (*it)->recordMetric()));
+      delete *it;
+   }
+   s_metrics.clear();
+   result.times = recorder.m_times;
+
+   delete rob_timer;
+   delete allocator;
+   return result;
+}
+
+static bool compare(const Configuration &configuration, const char *issue_scheduler, const Result &scan, const Result &other)
+{
+   printf("seed %3" PRIu64 ", window %3d, %s, %s contention: %-5s ", configuration.seed, configuration.window_size,
+          configuration.in_order ? "in-order" : "out-of-order", configuration.issue_contention ? "with" : "no", issue_scheduler);
+
+   for(size_t i = 0; i < std::min(scan.times.size(), other.times.size()); i += 5)
+   {
+      if (!std::equal(scan.times.begin() + i, scan.times.begin() + i + 5, other.times.begin() + i))
+      {
+         printf("uop %" PRIu64 " differs: dispatch/issue/done/commit %" PRIu64 "/%" PRIu64 "/%" PRIu64 "/%" PRIu64 " fs, scan has %" PRIu64 "/%" PRIu64 "/%" PRIu64 "/%" PRIu64 " fs\n",
+                scan.times[i], other.times[i + 1], other.times[i + 2], other.times[i + 3], other.times[i + 4],
+                scan.times[i + 1], scan.times[i + 2], scan.times[i + 3], scan.times[i + 4]);
+         return false;
+      }
+   }
+   if (scan.times.size() != other.times.size())
+   {
+      printf("%zu uops committed, scan committed %zu\n", other.times.size() / 5, scan.times.size() / 5);
+      return false;
+   }
+   if (scan.simulate != other.simulate)
+   {
+      printf("simulate() results differ\n");
+      return false;
+   }
+   for(size_t i = 0; i < scan.stats.size(); ++i)
+   {
+      if (scan.stats[i] != other.stats[i])
+      {
+         printf("rob_timer.%s = %" PRIu64 ", scan has %" PRIu64 "\n", scan.stats[i].first.c_str(), other.stats[i].second, scan.stats[i].second);
+         return false;
+      }
+   }
+
+   printf("%zu uops identical\n", scan.times.size() / 5);
+   return true;
+}
+
+int main(int argc, char **argv)
+{
+   if (argc > 3)
+   {
+      fprintf(stderr, "Usage: %s [<seeds> [<instructions per seed>]]\n", argv[0]);
+      return 2;
+   }
+   int num_seeds = argc > 1 ? atoi(argv[1]) : 10;
+   int num_instructions = argc > 2 ? atoi(argv[2]) : 20000;
+
+   Simulator::m_singleton = (Simulator*)s_simulator;
+   Simulator::m_config_file = (config::Config*)s_config_file;
+   Simulator::m_singleton->m_stats_manager = (StatsManager*)s_stats_manager;
+   Simulator::m_singleton->m_dvfs_manager = (DvfsManager*)s_dvfs_manager;
+
+   int failures = 0;
+   for(int seed = 1; seed <= num_seeds; ++seed)
+   {
+      for(int variant = 0; variant < 4; ++variant)
+      {
+         Configuration configuration;
+         configuration.seed = seed;
+         configuration.num_instructions = num_instructions;
+         // Every fourth seed uses a small window, which is full most of the time
+         configuration.window_size = seed % 4 == 0 ? 32 : 128;
+         configuration.dispatch_width = seed % 4 == 0 ? 2 : 4;
+         configuration.in_order = variant & 1;
+         configuration.issue_contention = variant & 2;
+
+         Result scan = run(configuration, "scan");
+         // check mode aborts on the first disagreement between the scan and the event-driven bookkeeping
+         if (!compare(configuration, "check", scan, run(configuration, "check")))
+            ++failures;
+         if (!compare(configuration, "event", scan, run(configuration, "event")))
+            ++failures;
+      }
+   }
+
+   if (failures)
+      printf("FAILED: %d runs differ from the scan issue stage\n", failures);
+   else
+      printf("PASSED: the check and event issue stages match the scan in %d runs\n", 2 * 4 * num_seeds);
+   return failures ? 1 : 0;
+}
@@ -242,21 +242,9 @@ def log_cpi_stack(results):
                 f.write('\n')
 
 
-def main(jobid, resultsdir, outputfile, powertype='dynamic', config=None, no_graph=False, partial=None, print_stack=True, return_data=False):
+def run_mcpat(jobid, resultsdir, outputfile, results):
     tempfile = outputfile + '.xml'
 
-    results = sniper_lib.get_results(jobid, resultsdir, partial=partial)
-    if config:
-        # update using energystats-temp.cfg
-        results['config'] = sniper_config.parse_config(
-            file(config).read(), results['config'])
-
-        # recompute cycle counts with updated frequencies
-        _results = sniper_lib.parse_results_from_dir(
-            resultsdir, partial=partial, metrics=None)
-        results['results'] = sniper_lib.stats_process(
-            results['config'], _results)
-
     stats = sniper_stats.SniperStats(resultsdir=resultsdir, jobid=jobid)
 
     power, nuca_at_level = edit_XML(
@@ -264,11 +252,6 @@ def main(jobid, resultsdir, outputfile, powertype='dynamic', config=None, no_gra
     power = map(lambda v: v[0], power)
     file(tempfile, "w").write('\n'.join(power))
 
-    # Log Performance Counters
-    log_frequencies(results)
-    log_vdd(results)
-    log_cpi_stack(results)
-
     # Run McPAT
     mcpat_run(tempfile, outputfile + '.txt')
 
@@ -340,6 +323,35 @@ def main(jobid, resultsdir, outputfile, powertype='dynamic', config=None, no_gra
     # Write back
     file(outputfile + '.py', 'w').write("power = " + pprint.pformat(power_dat))
 
+    return power_dat
+
+
+def main(jobid, resultsdir, outputfile, powertype='dynamic', config=None, no_graph=False, partial=None, print_stack=True, return_data=False, reuse_power=False):
+    results = sniper_lib.get_results(jobid, resultsdir, partial=partial)
+    if config:
+        # update using energystats-temp.cfg
+        results['config'] = sniper_config.parse_config(
+            file(config).read(), results['config'])
+
+        # recompute cycle counts with updated frequencies
+        _results = sniper_lib.parse_results_from_dir(
+            resultsdir, partial=partial, metrics=None)
+        results['results'] = sniper_lib.stats_process(
+            results['config'], _results)
+
+    # Log Performance Counters
+    log_frequencies(results)
+    log_vdd(results)
+    log_cpi_stack(results)
+
+    if reuse_power and os.path.exists(outputfile + '.py'):
+        # Activity did not change (scripts/energystats.py lazy mode): keep the power of the previous run
+        power_dat = {}
+        execfile(outputfile + '.py', {}, power_dat)
+        power_dat = power_dat['power']
+    else:
+        power_dat = run_mcpat(jobid, resultsdir, outputfile, results)
+
     # Build stack
     ncores = int(results['config']['general/total_cores'])
     time0_begin = results['results']['global.time_begin']
@@ -651,7 +663,9 @@ def power_stack(power_dat, cfg, seconds, powertype='total', nocollapse=False):
         thermalLogFileName.close()
 
         # Update reliability values of all the cores.
-        if (sniper_config.get_config(cfg, "reliability/enabled") == 'true'):
+        # With the native reliability engine, the simulator picks up the temperatures itself (common/power/reliability_manager.h)
+        if (sniper_config.get_config(cfg, "reliability/enabled") == 'true'
+                and sniper_config.get_config_default(cfg, "reliability/engine", "external") == 'external'):
             update_reliability_values(cfg, 'InstantaneousTemperature.log', seconds)
 
     return buildstack.merge_items({0: data}, all_items, nocollapse=nocollapse)
@@ -2070,7 +2084,7 @@ def readTemplate(ncores, num_l2s, private_l2s, num_l3s, technology_node):
 
 if __name__ == '__main__':
     def usage():
-        print 'Usage:', sys.argv[0], '[-h (help)] [-j <jobid> | -d <resultsdir (default: .)>] [-t <type: %s>] [-c <override-config>] [-o <output-file (power{.png,.txt,.py})>]' % '|'.join(powertypes)
+        print 'Usage:', sys.argv[0], '[-h (help)] [-j <jobid> | -d <resultsdir (default: .)>] [-t <type: %s>] [-c <override-config>] [-o <output-file (power{.png,.txt,.py})>] [--reuse-power (power of the previous run with the same output file)]' % '|'.join(powertypes)
         sys.exit(-1)
 
     jobid = 0
@@ -2082,10 +2096,11 @@ if __name__ == '__main__':
     no_graph = False
     no_text = False
     partial = None
+    reuse_power = False
 
     try:
         opts, args = getopt.getopt(sys.argv[1:], "hj:t:c:d:o:", [
-                                   'no-graph', 'no-text', 'partial='])
+                                   'no-graph', 'no-text', 'partial=', 'reuse-power'])
     except getopt.GetoptError, e:
         print e
         usage()
@@ -2114,6 +2129,8 @@ if __name__ == '__main__':
                 sys.stderr.write('--partial=<from>:<to>\n')
                 usage()
             partial = a.split(':')
+        if o == '--reuse-power':
+            reuse_power = True
 
     main(jobid=jobid, resultsdir=resultsdir, powertype=powertype, config=config,
-         outputfile=outputfile, no_graph=no_graph, print_stack=not no_text, partial=partial)
+         outputfile=outputfile, no_graph=no_graph, print_stack=not no_text, partial=partial, reuse_power=reuse_power)